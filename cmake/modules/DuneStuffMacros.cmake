@@ -138,6 +138,11 @@ if(LIKWID_FOUND)
 endif(LIKWID_FOUND)
 set(ENABLE_PERFMON 0 CACHE STRING "enable likwid performance monitoring API usage")
 
+# the ThreadManager uses std::thread, independent of MPI
+set(THREADS_PREFER_PTHREAD_FLAG ON)
+find_package(Threads REQUIRED)
+list(APPEND DUNE_DEFAULT_LIBS ${CMAKE_THREAD_LIBS_INIT})
+
 
 # include(FindFASP)
 
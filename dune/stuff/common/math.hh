@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <type_traits>
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/static_assert.hh>
@@ -20,11 +21,6 @@
 #include <boost/static_assert.hpp>
 #include <boost/fusion/include/void.hpp>
 #include <boost/format.hpp>
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/max.hpp>
-#include <boost/accumulators/statistics/min.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 #if HAVE_DUNE_FEM
@@ -188,25 +184,43 @@ protected:
 
 public:
   MinMaxAvg()
+    : count_(0)
+    , sum_(0)
+    , min_(std::numeric_limits< ElementType >::max())
+    , max_(std::numeric_limits< ElementType >::lowest())
   {}
 
-  template< class stl_container_type > MinMaxAvg(const stl_container_type& elements) {
-    dune_static_assert( (boost::is_same< ElementType, typename stl_container_type::value_type >::value),
+  template< class stl_container_type > MinMaxAvg(const stl_container_type& elements)
+    : MinMaxAvg()
+  {
+    dune_static_assert( (std::is_same< ElementType, typename stl_container_type::value_type >::value),
                         "cannot assign mismatching types" );
-    acc_ = std::for_each(elements.begin(), elements.end(), acc_);
+    for (const auto& element : elements)
+      operator()(element);
   }
 
-  std::size_t count() const { return boost::accumulators::count(acc_); }
-  ElementType sum() const { return boost::accumulators::sum(acc_); }
-  ElementType min() const { return boost::accumulators::min(acc_); }
-  ElementType max() const { return boost::accumulators::max(acc_); }
+  std::size_t count() const { return count_; }
+  ElementType sum() const { return sum_; }
+  ElementType min() const { return min_; }
+  ElementType max() const { return max_; }
   ElementType average() const {
     // for integer ElementType this just truncates from floating-point
-    return ElementType(boost::accumulators::mean(acc_));
+    return ElementType(sum_ / double(count_));
   }
 
   void operator()(const ElementType& el) {
-    acc_(el);
+    ++count_;
+    sum_ += el;
+    min_ = std::min(min_, el);
+    max_ = std::max(max_, el);
+  }
+
+  //! adds all elements seen by other, as if they had been given to this object
+  void merge(const ThisType& other) {
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
   }
 
   void output(std::ostream& stream) {
@@ -214,15 +228,10 @@ public:
   }
 
 protected:
-  typedef boost::accumulators::stats<
-    boost::accumulators::tag::max,
-    boost::accumulators::tag::min,
-    boost::accumulators::tag::mean,
-    boost::accumulators::tag::count,
-    boost::accumulators::tag::sum>
-  StatsType;
-  boost::accumulators::accumulator_set< ElementType, StatsType > acc_;
-
+  std::size_t count_;
+  ElementType sum_;
+  ElementType min_;
+  ElementType max_;
 };
 
 //! \return var bounded in [min, max]
@@ -35,6 +35,7 @@
 #include <dune/stuff/common/filesystem.hh>
 #include <dune/stuff/common/threadmanager.hh>
 
+#include <cstdio>
 #include <map>
 #include <string>
 #include <boost/foreach.hpp>
@@ -311,8 +312,153 @@ void Profiler::outputTimings(std::ostream& out) const
   }
 }
 
+Profiler::SectionId Profiler::sectionId(const std::string& section_name)
+{
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  const auto result = section_ids_.find(section_name);
+  if (result != section_ids_.end())
+    return result->second;
+  const SectionId id = SectionId(section_names_.size());
+  section_names_.push_back(section_name);
+  section_ids_[section_name] = id;
+  return id;
+} // ... sectionId(...)
+
+std::string Profiler::sectionName(const SectionId section) const
+{
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  if (section >= section_names_.size())
+    DUNE_THROW(Dune::RangeError, "unknown section id " << section);
+  return section_names_[section];
+}
+
+void Profiler::setTracing(const bool enabled)
+{
+  tracing_.store(enabled);
+}
+
+Profiler::TraceBuffer& Profiler::addTraceBuffer()
+{
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  trace_buffers_.emplace_back();
+  return trace_buffers_.back();
+}
+
+void Profiler::resetTrace()
+{
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  for (auto& buffer : trace_buffers_)
+    buffer.clear();
+}
+
+namespace {
+
+std::string json_escaped(const std::string& str)
+{
+  std::string ret;
+  for (const char cc : str) {
+    if (cc == '"' || cc == '\\') {
+      ret += '\\';
+      ret += cc;
+    } else if (static_cast< unsigned char >(cc) < 0x20) {
+      char code[8];
+      std::snprintf(code, sizeof(code), "\\u%04x", static_cast< unsigned int >(cc));
+      ret += code;
+    } else
+      ret += cc;
+  }
+  return ret;
+} // ... json_escaped(...)
+
+template< class T >
+void write_binary(std::ostream& out, const T* values, const size_t size)
+{
+  out.write(reinterpret_cast< const char* >(values), size*sizeof(T));
+}
+
+} // namespace
+
+void Profiler::outputTrace(const std::string name) const
+{
+  const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+  boost::filesystem::path filename = boost::filesystem::path(output_dir_)
+                                     / (boost::format("%s_p%08d.json") % name % comm.rank()).str();
+  boost::filesystem::ofstream out(filename);
+  outputTrace(out);
+}
+
+void Profiler::outputTrace(std::ostream& out) const
+{
+  const int rank = Dune::MPIHelper::getCollectiveCommunication().rank();
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  std::vector< std::string > names;
+  for (const auto& section_name : section_names_)
+    names.push_back(json_escaped(section_name));
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  char time[32];
+  for (size_t tt = 0; tt < trace_buffers_.size(); ++tt) {
+    for (const auto& event : trace_buffers_[tt]) {
+      // the trace format expects microseconds
+      std::snprintf(time, sizeof(time), "%llu.%03llu",
+                    static_cast< unsigned long long >(event.time/1000),
+                    static_cast< unsigned long long >(event.time%1000));
+      out << (first ? "\n" : ",\n")
+          << "{\"name\":\"" << names[event.section] << "\",\"ph\":\""
+          << (event.kind == TraceEvent::start ? "B" : "E") << "\",\"ts\":" << time
+          << ",\"pid\":" << rank << ",\"tid\":" << tt << "}";
+      first = false;
+    }
+  }
+  out << "\n]}" << std::endl;
+} // ... outputTrace(...)
+
+void Profiler::outputTraceBinary(const std::string name) const
+{
+  const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+  boost::filesystem::path filename = boost::filesystem::path(output_dir_)
+                                     / (boost::format("%s_p%08d.dstrace") % name % comm.rank()).str();
+  boost::filesystem::ofstream out(filename, std::ios::binary);
+  std::lock_guard< std::mutex > guard(trace_mutex_);
+  const std::uint32_t version = 1;
+  const std::uint32_t byte_order_mark = 0x01020304;
+  const std::uint64_t rank = comm.rank();
+  out.write("DSTRACE\n", 8);
+  write_binary(out, &version, 1);
+  write_binary(out, &byte_order_mark, 1);
+  write_binary(out, &rank, 1);
+  const std::uint64_t num_sections = section_names_.size();
+  write_binary(out, &num_sections, 1);
+  for (const auto& section_name : section_names_) {
+    const std::uint64_t length = section_name.size();
+    write_binary(out, &length, 1);
+    write_binary(out, section_name.data(), section_name.size());
+  }
+  const std::uint64_t num_threads = trace_buffers_.size();
+  write_binary(out, &num_threads, 1);
+  for (const auto& buffer : trace_buffers_) {
+    const std::uint64_t num_events = buffer.size();
+    std::vector< std::uint64_t > times(num_events);
+    std::vector< std::uint32_t > sections(num_events);
+    std::vector< std::uint8_t > kinds(num_events);
+    for (size_t ii = 0; ii < num_events; ++ii) {
+      times[ii] = buffer[ii].time;
+      sections[ii] = buffer[ii].section;
+      kinds[ii] = buffer[ii].kind;
+    }
+    write_binary(out, &num_events, 1);
+    write_binary(out, times.data(), num_events);
+    write_binary(out, sections.data(), num_events);
+    write_binary(out, kinds.data(), num_events);
+  }
+  if (!out)
+    DUNE_THROW(Dune::IOError, "could not write " << filename);
+} // ... outputTraceBinary(...)
+
 Profiler::Profiler()
   : csv_sep(",")
+  , tracing_(false)
+  , trace_origin_(std::chrono::steady_clock::now())
 {
   DSC_LIKWID_INIT;
   reset(1);
@@ -12,6 +12,12 @@
 #include <ctime>
 #include <memory>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 #include <boost/noncopyable.hpp>
 #include <boost/timer/timer.hpp>
@@ -52,6 +58,7 @@ public:
    *  - User can set as many (even nested) named sections whose total (=system+user) time will be computed across all program
    * instances.\n
    *  - Provides csv-conform output of process-averaged runtimes.
+   *  - Provides a low overhead tracing mode (see startEvent()) for short sections and timelines across threads.
    * \todo this could go into libdune-stuff
    **/
 class Profiler
@@ -125,6 +132,72 @@ public:
 
   void setOutputdir(const std::string dir);
 
+  /** \name low overhead tracing
+   *  Sections are interned once (sectionId()), startEvent() and stopEvent() then only append an event with a
+   *  steady_clock time stamp to a buffer of the calling thread: no lookup, no lock and no timer object. Events are only
+   *  recorded while tracing is enabled (setTracing()), otherwise startEvent() and stopEvent() cost one relaxed atomic
+   *  load. The output and reset methods must not be called while other threads are recording.
+   *  \{
+   **/
+  typedef std::uint32_t SectionId;
+
+  struct TraceEvent
+  {
+    enum Kind : std::uint8_t { start = 0, stop = 1 };
+    //! nanoseconds since the construction of the profiler
+    std::uint64_t time;
+    SectionId section;
+    Kind kind;
+  };
+
+  typedef std::vector< TraceEvent > TraceBuffer;
+
+  //! \return the id of section_name, the same name always yields the same id (thread safe, but look it up only once)
+  SectionId sectionId(const std::string& section_name);
+
+  std::string sectionName(const SectionId section) const;
+
+  void setTracing(const bool enabled);
+
+  bool tracing() const
+  {
+    return tracing_.load(std::memory_order_relaxed);
+  }
+
+  void startEvent(const SectionId section)
+  {
+    record(section, TraceEvent::start);
+  }
+
+  void stopEvent(const SectionId section)
+  {
+    record(section, TraceEvent::stop);
+  }
+
+  //! drops all recorded events, the section ids stay valid
+  void resetTrace();
+
+  //! writes the events of all threads in the Chrome trace format (chrome://tracing, Perfetto) to <dir>/name_p<rank>.json
+  void outputTrace(const std::string name) const;
+  void outputTrace(std::ostream& out) const;
+
+  /** writes the events of all threads to <dir>/name_p<rank>.dstrace, the layout (in native byte order) is
+   *  \code
+   * char[8]   "DSTRACE\n"
+   * uint32    format version (1)
+   * uint32    byte order mark (0x01020304)
+   * uint64    MPI rank
+   * uint64    number of sections, followed by each name as uint64 length and chars
+   * uint64    number of threads, followed by the columns of each thread:
+   *   uint64    number of events n
+   *   uint64[n] times in nanoseconds
+   *   uint32[n] section ids
+   *   uint8[n]  kinds (0: start, 1: stop)
+   *  \endcode
+   **/
+  void outputTraceBinary(const std::string name) const;
+  //! \}
+
   //! a utility class to time a limited scope of code
   class ScopedTiming
     : public boost::noncopyable
@@ -142,6 +215,23 @@ public:
     }
   };
 
+  //! a utility class to trace a limited scope of code, see DSC_PROFILER_TRACE_SCOPE
+  class ScopedEvent
+    : public boost::noncopyable
+  {
+    const SectionId section_;
+
+    public:
+    inline ScopedEvent(const SectionId section)
+      : section_(section) {
+      Profiler::instance().startEvent(section_);
+    }
+
+    inline ~ScopedEvent() {
+      Profiler::instance().stopEvent(section_);
+    }
+  };
+
 private:
   DatamapVector datamaps_;
   unsigned int current_run_number_;
@@ -153,6 +243,34 @@ private:
   KnownTimersMap known_timers_map_;
   const std::string csv_sep;
 
+  std::atomic< bool > tracing_;
+  const std::chrono::steady_clock::time_point trace_origin_;
+  mutable std::mutex trace_mutex_;
+  std::deque< std::string > section_names_;
+  std::unordered_map< std::string, SectionId > section_ids_;
+  //! one buffer per thread which ever recorded an event, a deque keeps the buffers in place
+  std::deque< TraceBuffer > trace_buffers_;
+
+  void record(const SectionId section, const TraceEvent::Kind kind)
+  {
+    if (!tracing_.load(std::memory_order_relaxed))
+      return;
+    const auto time = std::chrono::steady_clock::now() - trace_origin_;
+    traceBuffer().push_back(TraceEvent{std::uint64_t(std::chrono::duration_cast< std::chrono::nanoseconds >(time).count()),
+                                       section,
+                                       kind});
+  } // ... record(...)
+
+  TraceBuffer& traceBuffer()
+  {
+    static thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr)
+      buffer = &addTraceBuffer();
+    return *buffer;
+  }
+
+  TraceBuffer& addTraceBuffer();
+
   static Profiler& instance() {
     static Profiler pf;
     return pf;
@@ -171,4 +289,14 @@ inline Profiler& profiler() {
 
 #define DSC_PROFILER Dune::Stuff::Common::profiler()
 
+#define DSC_PROFILER_CONCAT_IMPL(a, b) a ## b
+#define DSC_PROFILER_CONCAT(a, b) DSC_PROFILER_CONCAT_IMPL(a, b)
+
+//! traces the rest of the enclosing scope as section name, the section id is only looked up once per call site
+#define DSC_PROFILER_TRACE_SCOPE(name) \
+  static const Dune::Stuff::Common::Profiler::SectionId DSC_PROFILER_CONCAT(dsc_profiler_section_, __LINE__) \
+      = DSC_PROFILER.sectionId(name); \
+  const Dune::Stuff::Common::Profiler::ScopedEvent DSC_PROFILER_CONCAT(dsc_profiler_scope_, __LINE__)( \
+      DSC_PROFILER_CONCAT(dsc_profiler_section_, __LINE__))
+
 #endif // DUNE_STUFF_PROFILER_HH_INCLUDED
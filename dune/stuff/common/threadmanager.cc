@@ -7,48 +7,242 @@
 
 #include "threadmanager.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <dune/stuff/common/configtree.hh>
+
 #if HAVE_DUNE_FEM
+# include <dune/fem/misc/threadmanager.hh>
+#endif
+
+namespace Dune {
+namespace Stuff {
+namespace {
+
+//! the thread number within the pool, only valid inside of a parallel region
+thread_local unsigned int pool_thread = 0;
+//! the number of threads of the parallel region the calling thread is in, 0 outside of parallel regions
+thread_local unsigned int region_threads = 0;
+
+
+/**
+ *  Keeps num_threads - 1 workers alive between parallel regions (the calling thread is the first one of each region),
+ *  so entering a region only costs a notification instead of spawning threads.
+ */
+class ThreadPool
+{
+public:
+  static ThreadPool& instance()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  ~ThreadPool()
+  {
+    stop();
+  }
+
+  void run(const unsigned int num_threads, const std::function< void(unsigned int, unsigned int) >& job)
+  {
+    // only one region at a time, regions started by other threads wait here
+    std::lock_guard< std::mutex > region_guard(region_mutex_);
+    if (workers_.size() + 1 != num_threads) {
+      stop();
+      start(num_threads);
+    }
+    {
+      std::lock_guard< std::mutex > guard(mutex_);
+      job_ = &job;
+      exceptions_.assign(num_threads, nullptr);
+      pending_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+    execute(0);
+    {
+      std::unique_lock< std::mutex > lock(mutex_);
+      done_.wait(lock, [this] { return pending_ == 0; });
+      job_ = nullptr;
+    }
+    for (const auto& exception : exceptions_)
+      if (exception)
+        std::rethrow_exception(exception);
+  } // ... run(...)
+
+private:
+  ThreadPool()
+    : num_threads_(1)
+    , job_(nullptr)
+    , pending_(0)
+    , generation_(0)
+    , stopping_(false)
+  {}
+
+  void start(const unsigned int num_threads)
+  {
+    num_threads_ = num_threads;
+    stopping_ = false;
+    for (unsigned int tt = 1; tt < num_threads; ++tt)
+      workers_.emplace_back(&ThreadPool::work, this, tt, generation_);
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard< std::mutex > guard(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+    workers_.clear();
+    num_threads_ = 1;
+  } // ... stop(...)
+
+  void execute(const unsigned int thread)
+  {
+    pool_thread = thread;
+    region_threads = num_threads_;
+    try {
+      (*job_)(thread, num_threads_);
+    } catch (...) {
+      exceptions_[thread] = std::current_exception();
+    }
+    region_threads = 0;
+  } // ... execute(...)
+
+  void work(const unsigned int thread, std::size_t generation)
+  {
+    while (true) {
+      {
+        std::unique_lock< std::mutex > lock(mutex_);
+        wake_.wait(lock, [&] { return stopping_ || generation_ != generation; });
+        if (stopping_)
+          return;
+        generation = generation_;
+      }
+      execute(thread);
+      {
+        std::lock_guard< std::mutex > guard(mutex_);
+        if (--pending_ == 0)
+          done_.notify_one();
+      }
+    }
+  } // ... work(...)
+
+  std::vector< std::thread > workers_;
+  unsigned int num_threads_;
+  const std::function< void(unsigned int, unsigned int) >* job_;
+  std::vector< std::exception_ptr > exceptions_;
+  std::size_t pending_;
+  std::size_t generation_;
+  bool stopping_;
+  std::mutex region_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+}; // class ThreadPool
 
-#include <dune/fem/misc/threadmanager.hh>
 
-unsigned int Dune::Stuff::ThreadManager::max_threads()
+#if !HAVE_DUNE_FEM
+std::atomic< unsigned int >& max_thread_count()
+{
+  static std::atomic< unsigned int > count([] {
+    const char* value = std::getenv("DUNE_STUFF_NUM_THREADS");
+    if (value != nullptr && std::atoi(value) > 0)
+      return unsigned(std::atoi(value));
+    return 1u;
+  }());
+  return count;
+} // ... max_thread_count(...)
+#endif // !HAVE_DUNE_FEM
+
+} // namespace
+
+
+#if HAVE_DUNE_FEM
+
+unsigned int ThreadManager::max_threads()
 {
     return Dune::Fem::ThreadManager::maxThreads();
 }
 
-unsigned int Dune::Stuff::ThreadManager::current_threads()
+unsigned int ThreadManager::current_threads()
 {
+    if (region_threads > 0)
+      return region_threads;
     return Dune::Fem::ThreadManager::currentThreads();
 }
 
-unsigned int Dune::Stuff::ThreadManager::thread()
+unsigned int ThreadManager::thread()
 {
+    if (region_threads > 0)
+      return pool_thread;
     return Dune::Fem::ThreadManager::thread();
 }
 
-void Dune::Stuff::ThreadManager::set_max_threads(const unsigned int count)
+void ThreadManager::set_max_threads(const unsigned int count)
 {
     Dune::Fem::ThreadManager::setMaxNumberThreads(count);
 }
 
 #else // if HAVE_DUNE_FEM
 
-unsigned int Dune::Stuff::ThreadManager::max_threads()
+unsigned int ThreadManager::max_threads()
 {
-    return 1;
+    return max_thread_count();
 }
 
-unsigned int Dune::Stuff::ThreadManager::current_threads()
+unsigned int ThreadManager::current_threads()
 {
-    return 1;
+    return std::max(region_threads, 1u);
 }
 
-unsigned int Dune::Stuff::ThreadManager::thread()
+unsigned int ThreadManager::thread()
 {
-    return 1;
+    return (region_threads > 0) ? pool_thread : 0;
 }
 
-void Dune::Stuff::ThreadManager::set_max_threads(const unsigned int /*count*/)
-{}
+void ThreadManager::set_max_threads(const unsigned int count)
+{
+    max_thread_count() = std::max(count, 1u);
+}
 
 #endif // HAVE_DUNE_FEM
+
+void ThreadManager::configure(const Common::ConfigTree& config)
+{
+    if (config.has_key("threading.max_count"))
+      set_max_threads(config.get< unsigned int >("threading.max_count"));
+}
+
+void ThreadManager::run_in_parallel(const std::function< void(unsigned int, unsigned int) >& job)
+{
+    const unsigned int num_threads = max_threads();
+    if (region_threads > 0 || num_threads == 1) {
+      const unsigned int outer_threads = region_threads;
+      if (outer_threads == 0) {
+        pool_thread = 0;
+        region_threads = 1;
+      }
+      try {
+        job(0, 1);
+      } catch (...) {
+        region_threads = outer_threads;
+        throw;
+      }
+      region_threads = outer_threads;
+      return;
+    }
+    ThreadPool::instance().run(num_threads, job);
+}
+
+} // namespace Stuff
+} // namespace Dune
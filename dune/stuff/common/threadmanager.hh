@@ -6,13 +6,24 @@
 #ifndef DUNE_STUFF_COMMON_THREADMANAGER_HH
 #define DUNE_STUFF_COMMON_THREADMANAGER_HH
 
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
 #include <vector>
 
 namespace Dune {
 namespace Stuff {
+namespace Common {
+
+class ConfigTree;
+
+} // namespace Common
 
 /** abstractions of threading functionality
- *  currently forwads to dune-fem if possible, falls back to single-thread dummy imp
+ *  currently forwads the thread counts to dune-fem if possible, otherwise the number of threads is taken from the
+ *  environment variable DUNE_STUFF_NUM_THREADS (defaulting to 1, use set_max_threads() or configure() to change it).
+ *  Parallel regions are run on a persistent pool of std::threads, the thread numbers are stable across regions.
  **/
 struct ThreadManager
 {
@@ -22,56 +33,140 @@ struct ThreadManager
   //! return number of current threads
   static unsigned int current_threads();
 
-  //! return thread number
+  //! return thread number, in [0, max_threads())
   static unsigned int thread();
 
   //! set maximal number of threads available during run
   static void set_max_threads( const unsigned int count );
+
+  //! set maximal number of threads from the key "threading.max_count" of config, if present
+  static void configure( const Common::ConfigTree& config );
+
+  /** \brief calls job(chunk, num_chunks) for every chunk in [0, num_chunks) in parallel and returns once all are done
+   *
+   *  The calling thread works on chunk 0, each chunk is executed on another thread of the pool, so chunk equals
+   *  thread() within job. Nested calls (from within job) run the whole job on the calling thread, i.e. job(0, 1),
+   *  while thread() still returns the number of the calling thread. Thus use thread(), not chunk, to access data
+   *  stored per thread. The first exception thrown by any chunk is rethrown after all chunks are done.
+   **/
+  static void run_in_parallel( const std::function< void(unsigned int, unsigned int) >& job );
+
+  /** \brief calls body(first, last) for contiguous chunks [first, last) of [begin, end) in parallel
+   *  \sa run_in_parallel
+   **/
+  template< class Body >
+  static void parallel_for( const std::size_t begin, const std::size_t end, const Body& body )
+  {
+    if (end <= begin)
+      return;
+    const std::size_t size = end - begin;
+    run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+      const std::size_t first = begin + (chunk*size)/num_chunks;
+      const std::size_t last = begin + ((chunk + 1)*size)/num_chunks;
+      if (first < last)
+        body(first, last);
+    });
+  } // ... parallel_for(...)
 };
 
+/** one ValueType per thread, accessed by ThreadManager::thread()
+ *  Each value is followed by a cache line of padding, so values written by different threads never share a cache line
+ *  (which would serialize the threads on that line). Accumulate thread-locally and combine the values once at the end
+ *  via sum(), reduce() or for_each().
+ **/
 template <class ValueImp>
 class PerThreadValue {
 public:
   typedef ValueImp ValueType;
 
+  //! assumed size of a cache line in bytes
+  static const std::size_t cache_line_size = 64;
+
 private:
   typedef PerThreadValue<ValueImp> ThisType;
-  typedef std::vector< ValueType > ContainerType;
+
+  struct PaddedValue {
+    ValueType value;
+    char padding[cache_line_size];
+  };
+
+  typedef std::vector< PaddedValue > ContainerType;
 
 public:
   //! Initialization by copy construction of ValueType
   PerThreadValue( const ValueType& value )
-    : values_( ThreadManager::max_threads(), value)
+    : values_( ThreadManager::max_threads(), PaddedValue{value, {}})
   {}
 
   //! Initialization by in-place construction ValueType with \param ctor_args
   template < class... InitTypes >
   PerThreadValue( InitTypes&& ...ctor_args )
-    : values_( ThreadManager::max_threads(), ValueType(std::forward<InitTypes>(ctor_args)...) )
+    : values_( ThreadManager::max_threads(), PaddedValue{ValueType(std::forward<InitTypes>(ctor_args)...), {}} )
   {}
 
   ValueType& operator * () {
-    return values_[ThreadManager::thread()];
+    return local();
   }
 
   const ValueType& operator * () const {
-    return values_[ThreadManager::thread()];
+    return local();
   }
 
   ValueType* operator -> () {
-    return &values_[ThreadManager::thread()];
+    return &local();
   }
 
   const ValueType* operator -> () const {
-    return &values_[ThreadManager::thread()];
+    return &local();
   }
 
   typename ContainerType::size_type size() const {
     return values_.size();
   }
 
+  //! \return the sum of all per-thread values, ValueType has to provide operator+=
+  ValueType sum() const {
+    return reduce([](const ValueType& lhs, const ValueType& rhs) {
+      ValueType ret(lhs);
+      ret += rhs;
+      return ret;
+    });
+  }
+
+  //! \return op(...op(op(value_0, value_1), value_2)..., value_n)
+  template < class BinaryOperation >
+  ValueType reduce( BinaryOperation op ) const {
+    ValueType ret(values_[0].value);
+    for (typename ContainerType::size_type ii = 1; ii < values_.size(); ++ii)
+      ret = op(ret, values_[ii].value);
+    return ret;
+  }
+
+  //! calls functor(value) for each per-thread value
+  template < class Functor >
+  void for_each( Functor functor ) {
+    for (auto& padded_value : values_)
+      functor(padded_value.value);
+  }
+
+  template < class Functor >
+  void for_each( Functor functor ) const {
+    for (const auto& padded_value : values_)
+      functor(padded_value.value);
+  }
+
 private:
-   ContainerType values_;
+  ValueType& local() {
+    assert(ThreadManager::thread() < values_.size());
+    return values_[ThreadManager::thread()].value;
+  }
+
+  const ValueType& local() const {
+    assert(ThreadManager::thread() < values_.size());
+    return values_[ThreadManager::thread()].value;
+  }
+
+  ContainerType values_;
 };
 
 }
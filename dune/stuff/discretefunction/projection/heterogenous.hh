@@ -8,6 +8,11 @@
 #ifndef DUNE_STUFF_DISCRETEFUNCTION_PROJECTION_HETEROGENOUS_HH
 #define DUNE_STUFF_DISCRETEFUNCTION_PROJECTION_HETEROGENOUS_HH
 
+#include <type_traits>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
 #include <dune/common/fvector.hh>
 #include <dune/grid/common/backuprestore.hh>
 #include <dune/grid/common/grid.hh>
@@ -15,6 +20,7 @@
 #include <dune/stuff/common/ranges.hh>
 #include <dune/stuff/aliases.hh>
 #include <dune/stuff/fem/namespace.hh>
+#include <dune/stuff/common/threadmanager.hh>
 
 #if HAVE_DUNE_FEM
   #include <dune/fem/function/common/discretefunction.hh>
@@ -26,6 +32,7 @@
 #include <dune/grid/io/file/vtk/function.hh>
 
 #include <dune/stuff/grid/search.hh>
+#include <dune/stuff/grid/walk.hh>
 
 namespace Dune {
 namespace Stuff {
@@ -33,31 +40,194 @@ namespace Stuff {
 
 #if HAVE_DUNE_FEM
 
+//! fills points with the global lagrange points of target_entity, reusing the memory of points
 template< class F, class G, int p, template< class > class S >
-std::vector<typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::DomainType>
-global_evaluation_points(const Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>& space,
-         const typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::EntityType& target_entity)
+void global_evaluation_points(const Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>& space,
+         const typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::EntityType& target_entity,
+         std::vector<typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::DomainType>& points)
 {
   const auto& target_lagrangepoint_set = space.lagrangePointSet(target_entity);
   const auto& target_geometry = target_entity.geometry();
   const auto quadNop = target_lagrangepoint_set.nop();
-  std::vector<typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::DomainType> points(quadNop);
+  points.resize(quadNop);
   for(size_t qP = 0; qP < quadNop ; ++qP) {
     points[qP] = target_geometry.global(target_lagrangepoint_set.point(qP));
   }
+}
+
+template< class F, class G, int p, template< class > class S >
+std::vector<typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::DomainType>
+global_evaluation_points(const Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>& space,
+         const typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::EntityType& target_entity)
+{
+  std::vector<typename Dune::Fem::LagrangeDiscreteFunctionSpace<F,G,p,S>::DomainType> points;
+  global_evaluation_points(space, target_entity, points);
   return points;
 }
 
+template< class F, class G, int p, template< class > class S >
+void global_evaluation_points(const Dune::Fem::FiniteVolumeSpace<F,G,p,S>& /*space*/,
+         const typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::EntityType& target_entity,
+         std::vector<typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::DomainType>& points)
+{
+  assert(false);
+  points.assign(1, target_entity.geometry().center());
+}
+
 template< class F, class G, int p, template< class > class S >
 std::vector<typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::DomainType>
-global_evaluation_points(const Dune::Fem::FiniteVolumeSpace<F,G,p,S>& /*space*/,
+global_evaluation_points(const Dune::Fem::FiniteVolumeSpace<F,G,p,S>& space,
          const typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::EntityType& target_entity)
 {
-  assert(false);
-  typedef std::vector<typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::DomainType> Ret;
-  return Ret(1, target_entity.geometry().center());
+  std::vector<typename Dune::Fem::FiniteVolumeSpace<F,G,p,S>::DomainType> points;
+  global_evaluation_points(space, target_entity, points);
+  return points;
 }
 
+namespace internal {
+
+
+/**
+ *  \brief Locates the evaluation points of the entities of the target space in the source grid part, block by block.
+ *
+ *  The target entities are processed in blocks of at most block_size entities per thread, so only the points of one
+ *  block are held in memory at a time. For each point the source entity and the local coordinate therein are stored,
+ *  so the projections only have to evaluate the source and write the DoFs of the block afterwards.
+ *  The lagrange point sets of the target space are only accessed on the calling thread. If Grid::AllowsConcurrentAccess
+ *  is specialized to std::true_type for the grid of the source space, the points of a block are split into one chunk
+ *  per thread of the ThreadManager. Each chunk is then located by its own copy of the search (so searches which keep
+ *  a state, like Grid::EntityInlevelSearch, may be used as well) with its own result, and the local coordinates are
+ *  computed on the same thread. Otherwise everything is done on the calling thread with the given search.
+ */
+template< class SourceSpaceType, class TargetSpaceType, class SearchImp >
+class EvaluationPointLocations
+{
+  typedef typename SourceSpaceType::EntityType::EntitySeed SourceEntitySeedType;
+  typedef typename TargetSpaceType::EntityType::EntitySeed TargetEntitySeedType;
+  typedef std::vector< typename TargetSpaceType::DomainType > PointsType;
+  typedef typename SearchImp::ResultType ResultType;
+  static const bool threaded
+      = Grid::AllowsConcurrentAccess< typename std::remove_const< typename SourceSpaceType::GridType >::type >::value;
+
+public:
+  typedef typename SourceSpaceType::GridType::template Codim< 0 >::EntityPointer SourceEntityPointerType;
+  typedef typename TargetSpaceType::GridType::template Codim< 0 >::EntityPointer TargetEntityPointerType;
+  typedef typename SourceSpaceType::EntityType::Geometry::LocalCoordinate SourceLocalCoordinateType;
+
+  //! the maximal number of target entities per thread and block
+  static const size_t block_size = 1024;
+
+  //! \param search has to search the grid of the source space
+  EvaluationPointLocations(const SourceSpaceType& source_space, const TargetSpaceType& target_space,
+                           SearchImp& search)
+    : source_space_(source_space)
+    , target_space_(target_space)
+    , search_(search)
+    , results_(1)
+  {}
+
+  /**
+   *  \brief Locates the points of the next block of target entities, which starts at it.
+   *  \return the end of the block
+   */
+  template< class IteratorType >
+  IteratorType locate(IteratorType it, const IteratorType& end)
+  {
+    const unsigned int num_threads = threaded ? ThreadManager::max_threads() : 1;
+    target_seeds_.clear();
+    offsets_.assign(1, 0);
+    points_.clear();
+    for (; it != end && target_seeds_.size() < block_size*num_threads; ++it) {
+      global_evaluation_points(target_space_, *it, entity_points_);
+      points_.insert(points_.end(), entity_points_.begin(), entity_points_.end());
+      target_seeds_.push_back(it->seed());
+      offsets_.push_back(points_.size());
+    }
+    source_seeds_.assign(points_.size(), nullptr);
+    local_points_.resize(points_.size());
+    if (num_threads > 1) {
+      if (searches_.size() + 1 < num_threads)
+        searches_.resize(num_threads - 1, search_);
+      if (results_.size() < num_threads)
+        results_.resize(num_threads);
+      ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+        locate_points(chunk == 0 ? search_ : searches_[chunk - 1], results_[chunk],
+               (chunk*points_.size())/num_chunks, ((chunk + 1)*points_.size())/num_chunks);
+      });
+    } else
+      locate_points(search_, results_[0], 0, points_.size());
+    return it;
+  } // ... locate(...)
+
+  //! the number of target entities of the current block
+  size_t num_target_entities() const
+  {
+    return target_seeds_.size();
+  }
+
+  //! the ii-th entity of the current block (in the order of iteration)
+  TargetEntityPointerType target_entity(const size_t ii) const
+  {
+    return target_space_.gridPart().grid().entityPointer(target_seeds_[ii]);
+  }
+
+  //! the number of evaluation points of the ii-th target entity
+  size_t size(const size_t ii) const
+  {
+    return offsets_[ii + 1] - offsets_[ii];
+  }
+
+  bool found(const size_t ii, const size_t qP) const
+  {
+    return source_seeds_[offsets_[ii] + qP] != nullptr;
+  }
+
+  SourceEntityPointerType source_entity(const size_t ii, const size_t qP) const
+  {
+    assert(found(ii, qP));
+    return source_space_.gridPart().grid().entityPointer(*source_seeds_[offsets_[ii] + qP]);
+  }
+
+  //! the evaluation point qP of the ii-th target entity in local coordinates of source_entity(ii, qP)
+  const SourceLocalCoordinateType& source_point(const size_t ii, const size_t qP) const
+  {
+    return local_points_[offsets_[ii] + qP];
+  }
+
+private:
+  //! locates the points [first, last) of the current block
+  void locate_points(SearchImp& search, ResultType& result, const size_t first, const size_t last)
+  {
+    search(boost::make_iterator_range(points_.begin() + first, points_.begin() + last), result);
+    assert(result.size() == last - first);
+    for (size_t pp = first; pp < last; ++pp) {
+      if (result.found(pp - first)) {
+        // points into the table of seeds of the search or of the result, which are kept until the next block
+        source_seeds_[pp] = &result.seed(pp - first);
+        local_points_[pp] = result.entityPointer(pp - first)->geometry().local(points_[pp]);
+      }
+    }
+  } // ... locate_points(...)
+
+  const SourceSpaceType& source_space_;
+  const TargetSpaceType& target_space_;
+  SearchImp& search_;
+  std::vector< SearchImp > searches_;
+  std::vector< ResultType > results_;
+  PointsType entity_points_;
+  PointsType points_;
+  std::vector< TargetEntitySeedType > target_seeds_;
+  std::vector< size_t > offsets_;
+  std::vector< const SourceEntitySeedType* > source_seeds_;
+  std::vector< SourceLocalCoordinateType > local_points_;
+}; // class EvaluationPointLocations
+
+template< class SourceSpaceType, class TargetSpaceType, class SearchImp >
+const size_t EvaluationPointLocations< SourceSpaceType, TargetSpaceType, SearchImp >::block_size;
+
+
+} // namespace internal
+
 template< template< class > class SearchStrategy = Grid::EntityInlevelSearch >
 class HeterogenousProjection
 {
@@ -84,41 +254,43 @@ public:
 
     const auto& space =  target.space();
 
+    internal::EvaluationPointLocations< typename SourceDFImp::DiscreteFunctionSpaceType,
+                                        TargetDiscreteFunctionSpaceType,
+                                        SearchStrategyImp > locations(source.space(), space, search);
+
     // set all DoFs to infinity
     preprocess(target);
 
+    typename TargetDiscreteFunctionSpaceType::RangeType source_value;
     const auto endit = space.end();
-    for(auto it = space.begin(); it != endit ; ++it)
+    for (auto it = space.begin(); it != endit; )
     {
-      const auto& target_entity = *it;
-      auto target_local_function = target.localFunction(target_entity);
-      const auto global_quads = global_evaluation_points(space, target_entity);
-      const auto evaluation_entity_ptrs = search(global_quads);
-      assert(evaluation_entity_ptrs.size() >= global_quads.size());
-
-      int k = 0;
-      typename TargetDiscreteFunctionSpaceType::RangeType source_value;
-      for(size_t qP = 0; qP < global_quads.size() ; ++qP)
+      // locate the evaluation points of the next block of entities before touching their DoFs
+      it = locations.locate(it, endit);
+      for (size_t ii = 0; ii < locations.num_target_entities(); ++ii)
       {
-        if(std::isinf(target_local_function[ k ]))
+        const auto target_entity_ptr = locations.target_entity(ii);
+        auto target_local_function = target.localFunction(*target_entity_ptr);
+
+        int k = 0;
+        for(size_t qP = 0; qP < locations.size(ii) ; ++qP)
         {
-          const auto& source_entity_unique_ptr = evaluation_entity_ptrs[qP];
-          if (source_entity_unique_ptr) {
-            const auto& source_entity_ptr = (*source_entity_unique_ptr);
-            const auto& source_geometry = source_entity_ptr->geometry();
-            const auto& global_point = global_quads[qP];
-            const auto& source_local_point = source_geometry.local(global_point);
-            const auto& source_local_function = source.localFunction(*source_entity_ptr);
-            source_local_function.evaluate(source_local_point, source_value);
-            for(int i = 0; i < target_dimRange; ++i, ++k)
-              setDofValue(target_local_function[k], source_value[i]);
-          }
-          else {
-            DUNE_THROW(InvalidStateException, "Did not find the local lagrange point in the source mesh!");
+          if(std::isinf(target_local_function[ k ]))
+          {
+            if (locations.found(ii, qP)) {
+              const auto source_entity_ptr = locations.source_entity(ii, qP);
+              const auto& source_local_function = source.localFunction(*source_entity_ptr);
+              source_local_function.evaluate(locations.source_point(ii, qP), source_value);
+              for(int i = 0; i < target_dimRange; ++i, ++k)
+                setDofValue(target_local_function[k], source_value[i]);
+            }
+            else {
+              DUNE_THROW(InvalidStateException, "Did not find the local lagrange point in the source mesh!");
+            }
           }
+          else
+            k += target_dimRange;
         }
-        else
-          k += target_dimRange;
       }
     }
     postprocess(target);
@@ -161,34 +333,35 @@ public:
 
     const auto& space =  target.space();
 
+    internal::EvaluationPointLocations< typename SourceDFImp::DiscreteFunctionSpaceType,
+                                        TargetDiscreteFunctionSpaceType,
+                                        SearchStrategyImp > locations(source.space(), space, search);
+
     preprocess(target);
 
+    typename TargetDiscreteFunctionSpaceType::RangeType source_value;
     const auto endit = space.end();
-    for(auto it = space.begin(); it != endit ; ++it)
+    for (auto it = space.begin(); it != endit; )
     {
-      const auto& target_entity = *it;
-      auto target_local_function = target.localFunction(target_entity);
-      const auto global_quads = global_evaluation_points(space, target_entity);
-      const auto evaluation_entity_ptrs = search(global_quads);
-      assert(evaluation_entity_ptrs.size() >= global_quads.size());
-
-      int k = 0;
-      typename TargetDiscreteFunctionSpaceType::RangeType source_value;
-      for(size_t qP = 0; qP < global_quads.size() ; ++qP)
+      it = locations.locate(it, endit);
+      for (size_t ii = 0; ii < locations.num_target_entities(); ++ii)
       {
-          const auto& source_entity_unique_ptr = evaluation_entity_ptrs[qP];
-          if (source_entity_unique_ptr) {
-            const auto& source_entity_ptr = (*source_entity_unique_ptr);
-            const auto& source_geometry = source_entity_ptr->geometry();
-            const auto& global_point = global_quads[qP];
-            const auto& source_local_point = source_geometry.local(global_point);
-            const auto& source_local_function = source.localFunction(*source_entity_ptr);
-            source_local_function.evaluate(source_local_point, source_value);
-            for(int i = 0; i < target_dimRange; ++i, ++k)
-              setDofValue(target_local_function[k], source_value[i]);
-          }
-          else {
-            DUNE_THROW(InvalidStateException, "Did not find the local lagrange point in the source mesh!");
+        const auto target_entity_ptr = locations.target_entity(ii);
+        auto target_local_function = target.localFunction(*target_entity_ptr);
+
+        int k = 0;
+        for(size_t qP = 0; qP < locations.size(ii) ; ++qP)
+        {
+            if (locations.found(ii, qP)) {
+              const auto source_entity_ptr = locations.source_entity(ii, qP);
+              const auto& source_local_function = source.localFunction(*source_entity_ptr);
+              source_local_function.evaluate(locations.source_point(ii, qP), source_value);
+              for(int i = 0; i < target_dimRange; ++i, ++k)
+                setDofValue(target_local_function[k], source_value[i]);
+            }
+            else {
+              DUNE_THROW(InvalidStateException, "Did not find the local lagrange point in the source mesh!");
+            }
           }
         }
       }
@@ -195,9 +195,9 @@ private:
 
 };
 
-class LagrangePattern : public DSL::SparsityPatternDefault {
+class LagrangePattern : public DSL::SparsityPatternCompressed {
 
-    typedef DSL::SparsityPatternDefault BaseType;
+    typedef DSL::SparsityPatternCompressed BaseType;
 public:
     template< class D_FunctionSpace, class D_GridPart, int D_polOrder, template< class > class D_Storage,
               class R_FunctionSpace, class R_GridPart, int R_polOrder, template< class > class R_Storage>
@@ -206,24 +206,25 @@ public:
                     const Dune::LagrangeDiscreteFunctionSpace<R_FunctionSpace,
                                             R_GridPart, R_polOrder, R_Storage>& range_space,
                     const bool non_conform = false)
-        : BaseType(domain_space.size())
+        : BaseType(build(domain_space, range_space, non_conform))
+    {}
+
+private:
+    template< class DomainSpaceImp, class RangeSpaceImp >
+    static BaseType build(const DomainSpaceImp& domain_space, const RangeSpaceImp& range_space,
+                          const bool non_conform)
     {
+        DSL::SparsityPatternBuilder builder(domain_space.size());
+        const auto& gridPart = domain_space.gridPart();
+        const auto& rowMapper = domain_space.mapper();
+        const auto& colMapper = range_space.mapper();
+        std::vector< size_t > globalCols;
         for( const auto& entity : domain_space )
         {
-            const auto& gridPart = domain_space.gridPart();
-            const auto& rowMapper = domain_space.mapper();
-            const auto& colMapper = range_space.mapper();
-            const auto rowEnd = rowMapper.end( entity );
-            for(auto rowIt = rowMapper.begin( entity );
-                rowIt != rowEnd; ++rowIt )
-            {
-              auto& localIndices = BaseType::set( rowIt.global() );
-
-              const auto colEnd = colMapper.end( entity );
-              auto colIt = colMapper.begin( entity );
-              for( ; colIt != colEnd; ++colIt )
-                localIndices.insert( colIt.global() );
-            }
+            globalCols.clear();
+            const auto colEnd = colMapper.end( entity );
+            for(auto colIt = colMapper.begin( entity ); colIt != colEnd; ++colIt )
+              globalCols.push_back( colIt.global() );
             if(non_conform)
             {
               const auto endit = gridPart.iend( entity );
@@ -235,23 +236,20 @@ public:
                 {
                   auto ep = intersection.outside();
                   const auto& neighbor = *ep;
-
                   // also add all neighbor dofs
-                  for(auto rowIt = rowMapper.begin( entity );
-                      rowIt != rowEnd; ++rowIt )
-                  {
-                    auto& localIndices =  BaseType::set( rowIt.global() );
-                    const auto colEnd = colMapper.end( neighbor );
-                    for(auto colIt = colMapper.begin( neighbor );
-                        colIt != colEnd; ++colIt )
-                    {
-                      localIndices.insert( colIt.global() );
-                    }
-                  }
+                  const auto neighborColEnd = colMapper.end( neighbor );
+                  for(auto colIt = colMapper.begin( neighbor );
+                      colIt != neighborColEnd; ++colIt )
+                    globalCols.push_back( colIt.global() );
                 }
               }
             }
+            const auto rowEnd = rowMapper.end( entity );
+            for(auto rowIt = rowMapper.begin( entity );
+                rowIt != rowEnd; ++rowIt )
+              builder.insert( rowIt.global(), globalCols.begin(), globalCols.end() );
         }
+        return builder.finalize();
     }
 };
 
@@ -285,7 +283,9 @@ private:
 
   mutable MatrixType matrix_;
   bool preconditioning_;
-  const DSL::SparsityPatternDefault& sparsity_pattern_;
+  //! only set if constructed from a SparsityPatternDefault, which is converted
+  std::shared_ptr< const DSL::SparsityPatternCompressed > converted_pattern_;
+  const DSL::SparsityPatternCompressed& sparsity_pattern_;
 
 public:
   //! type of local matrix
@@ -293,7 +293,7 @@ public:
 
   inline EigenMatrixObject( const DomainSpaceType& domainSpace,
                             const RangeSpaceType& rangeSpace,
-                            const DSL::SparsityPatternDefault& sparsity_pattern )
+                            const DSL::SparsityPatternCompressed& sparsity_pattern )
     : domainSpace_(domainSpace)
     , rangeSpace_(rangeSpace)
     , sequence_(-1)
@@ -303,6 +303,19 @@ public:
   {
   }
 
+  inline EigenMatrixObject( const DomainSpaceType& domainSpace,
+                            const RangeSpaceType& rangeSpace,
+                            const DSL::SparsityPatternDefault& sparsity_pattern )
+    : domainSpace_(domainSpace)
+    , rangeSpace_(rangeSpace)
+    , sequence_(-1)
+    , matrix_()
+    , preconditioning_(false)
+    , converted_pattern_(std::make_shared< DSL::SparsityPatternCompressed >(sparsity_pattern))
+    , sparsity_pattern_(*converted_pattern_)
+  {
+  }
+
   inline MatrixType& matrix() const
   {
     return matrix_;
@@ -398,6 +411,12 @@ public:
 
   using Base::apply;
 
+  EigenMatrixOperator ( const DomainSpaceType &domainSpace,
+                            const RangeSpaceType &rangeSpace,
+                            const DSL::SparsityPatternCompressed& pattern )
+  : Base( domainSpace, rangeSpace, pattern )
+  {}
+
   EigenMatrixOperator ( const DomainSpaceType &domainSpace,
                             const RangeSpaceType &rangeSpace,
                             const DSL::SparsityPatternDefault& pattern )
@@ -7,6 +7,7 @@
 #define DUNE_STUFF_FUNCTIONS_ESV2007_HH
 
 #include <cmath>
+#include <memory>
 
 #include <dune/geometry/referenceelements.hh>
 
@@ -60,32 +61,36 @@ class DUNE_DEPRECATED_MSG("Use ESV2007::Cutoff instead!") ESV2007Cutoff
     template< class D >
     struct Compute< D, 1, 1 >
     {
-      static RangeFieldType min_eigenvalue_of(const D& diffusion, const EntityType& ent)
+      static RangeFieldType min_eigenvalue_of(const typename D::LocalfunctionType& local_diffusion,
+                                              const EntityType& ent)
       {
-        const auto local_diffusion = diffusion.local_function(ent);
-        assert(local_diffusion->order() == 0);
+        assert(local_diffusion.order() == 0);
         const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(ent.type());
-        return local_diffusion->evaluate(reference_element.position(0, 0))[0];
+        return local_diffusion.evaluate(reference_element.position(0, 0))[0];
       } // ... min_eigenvalue_of_(...)
     }; // class Compute< ..., 1, 1 >
 
   public:
     Localfunction(const EntityType& ent, const DiffusionImp& diffusion, const RangeFieldType poincare_constant)
       : BaseType(ent)
+      , local_diffusion_(diffusion.local_function(ent))
+      , poincare_constant_(poincare_constant)
       , value_(0)
     {
-      const RangeFieldType min_eigen_value
-          = Compute< DiffusionImp, DiffusionImp::dimRange, DiffusionImp::dimRangeCols >::min_eigenvalue_of(diffusion,
-                                                                                                           ent);
-      assert(min_eigen_value > 0.0);
-      const DomainFieldType hh = compute_diameter_of_(ent);
-      value_ = (poincare_constant * hh * hh) / min_eigen_value;
+      compute_value_(ent);
     }
 
     Localfunction(const Localfunction& /*other*/) = delete;
 
     Localfunction& operator=(const Localfunction& /*other*/) = delete;
 
+    virtual void bind(const EntityType& ent) DS_OVERRIDE DS_FINAL
+    {
+      BaseType::bind(ent);
+      local_diffusion_->bind(ent);
+      compute_value_(ent);
+    }
+
     virtual size_t order() const DS_OVERRIDE DS_FINAL
     {
       return 0;
@@ -104,6 +109,16 @@ class DUNE_DEPRECATED_MSG("Use ESV2007::Cutoff instead!") ESV2007Cutoff
     }
 
   private:
+    void compute_value_(const EntityType& ent)
+    {
+      const RangeFieldType min_eigen_value
+          = Compute< DiffusionImp, DiffusionImp::dimRange, DiffusionImp::dimRangeCols >::min_eigenvalue_of(
+              *local_diffusion_, ent);
+      assert(min_eigen_value > 0.0);
+      const DomainFieldType hh = compute_diameter_of_(ent);
+      value_ = (poincare_constant_ * hh * hh) / min_eigen_value;
+    } // ... compute_value_(...)
+
     static DomainFieldType compute_diameter_of_(const EntityType& ent)
     {
       DomainFieldType ret(0);
@@ -118,6 +133,8 @@ class DUNE_DEPRECATED_MSG("Use ESV2007::Cutoff instead!") ESV2007Cutoff
       return ret;
     } // ... compute_diameter_of_(...)
 
+    const std::unique_ptr< typename DiffusionImp::LocalfunctionType > local_diffusion_;
+    const RangeFieldType poincare_constant_;
     RangeFieldType value_;
   }; // class Localfunction
 
@@ -361,32 +378,36 @@ class Cutoff
     template< class D >
     struct Compute< D, 1, 1 >
     {
-      static RangeFieldType min_eigenvalue_of(const D& diffusion, const EntityType& ent)
+      static RangeFieldType min_eigenvalue_of(const typename D::LocalfunctionType& local_diffusion,
+                                              const EntityType& ent)
       {
-        const auto local_diffusion = diffusion.local_function(ent);
-        assert(local_diffusion->order() == 0);
+        assert(local_diffusion.order() == 0);
         const auto& reference_element = ReferenceElements< DomainFieldType, dimDomain >::general(ent.type());
-        return local_diffusion->evaluate(reference_element.position(0, 0))[0];
+        return local_diffusion.evaluate(reference_element.position(0, 0))[0];
       } // ... min_eigenvalue_of_(...)
     }; // class Compute< ..., 1, 1 >
 
   public:
     Localfunction(const EntityType& ent, const DiffusionImp& diffusion, const RangeFieldType poincare_constant)
       : BaseType(ent)
+      , local_diffusion_(diffusion.local_function(ent))
+      , poincare_constant_(poincare_constant)
       , value_(0)
     {
-      const RangeFieldType min_eigen_value
-          = Compute< DiffusionImp, DiffusionImp::dimRange, DiffusionImp::dimRangeCols >::min_eigenvalue_of(diffusion,
-                                                                                                           ent);
-      assert(min_eigen_value > 0.0);
-      const DomainFieldType hh = compute_diameter_of_(ent);
-      value_ = (poincare_constant * hh * hh) / min_eigen_value;
+      compute_value_(ent);
     }
 
     Localfunction(const Localfunction& /*other*/) = delete;
 
     Localfunction& operator=(const Localfunction& /*other*/) = delete;
 
+    virtual void bind(const EntityType& ent) DS_OVERRIDE DS_FINAL
+    {
+      BaseType::bind(ent);
+      local_diffusion_->bind(ent);
+      compute_value_(ent);
+    }
+
     virtual size_t order() const DS_OVERRIDE DS_FINAL
     {
       return 0;
@@ -405,6 +426,16 @@ class Cutoff
     }
 
   private:
+    void compute_value_(const EntityType& ent)
+    {
+      const RangeFieldType min_eigen_value
+          = Compute< DiffusionImp, DiffusionImp::dimRange, DiffusionImp::dimRangeCols >::min_eigenvalue_of(
+              *local_diffusion_, ent);
+      assert(min_eigen_value > 0.0);
+      const DomainFieldType hh = compute_diameter_of_(ent);
+      value_ = (poincare_constant_ * hh * hh) / min_eigen_value;
+    } // ... compute_value_(...)
+
     static DomainFieldType compute_diameter_of_(const EntityType& ent)
     {
       DomainFieldType ret(0);
@@ -419,6 +450,8 @@ class Cutoff
       return ret;
     } // ... compute_diameter_of_(...)
 
+    const std::unique_ptr< typename DiffusionImp::LocalfunctionType > local_diffusion_;
+    const RangeFieldType poincare_constant_;
     RangeFieldType value_;
   }; // class Localfunction
 
@@ -9,10 +9,15 @@
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <type_traits>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/static_assert.hh>
 
+#if HAVE_DUNE_GRID
+# include <dune/grid/common/entity.hh>
+#endif
+
 #include <dune/stuff/common/configtree.hh>
 
 #include "interfaces.hh"
@@ -20,6 +25,26 @@
 namespace Dune {
 namespace Stuff {
 namespace Functions {
+namespace internal {
+
+
+//! the leaf index set of the grid EntityImp belongs to, void for entities which are no Dune::Entity
+template< class EntityImp >
+struct CheckerboardLeafIndexSet
+{
+  typedef void type;
+};
+
+#if HAVE_DUNE_GRID
+template< int cd, int dim, class GridImp, template< int, int, class > class EntityImp >
+struct CheckerboardLeafIndexSet< Dune::Entity< cd, dim, GridImp, EntityImp > >
+{
+  typedef typename std::remove_const< GridImp >::type::LeafIndexSet type;
+};
+#endif // HAVE_DUNE_GRID
+
+
+} // namespace internal
 
 
 template< class EntityImp, class DomainFieldImp, int domainDim, class RangeFieldImp, int rangeDim, int rangeDimCols = 1 >
@@ -29,6 +54,112 @@ class Checkerboard
   typedef LocalizableFunctionInterface< EntityImp, DomainFieldImp, domainDim, RangeFieldImp, rangeDim, rangeDimCols >
     BaseType;
   typedef Checkerboard< EntityImp, DomainFieldImp, domainDim, RangeFieldImp, rangeDim, rangeDimCols > ThisType;
+  typedef typename internal::CheckerboardLeafIndexSet< EntityImp >::type IndexSetType;
+
+  //! the subdomain of each entity of a leaf grid view, see precompute()
+  struct Precomputed
+  {
+    const IndexSetType* index_set;
+    std::vector< size_t > subdomains;
+  }; // struct Precomputed
+
+  /**
+   *  \brief The data needed to find the value of an entity.
+   *
+   *  Shared by the function, its copies and its local functions, so copying it only copies some shared_ptrs.
+   */
+  class Lookup
+  {
+    typedef typename BaseType::EntityType      EntityType;
+    typedef typename BaseType::DomainFieldType DomainFieldType;
+    typedef typename BaseType::RangeType       RangeType;
+  public:
+    Lookup(std::vector< DomainFieldType >&& lowerLeft,
+           std::vector< DomainFieldType >&& upperRight,
+           std::vector< size_t >&& numElements,
+           std::vector< RangeType >&& values)
+      : lowerLeft_(new std::vector< DomainFieldType >(std::move(lowerLeft)))
+      , upperRight_(new std::vector< DomainFieldType >(std::move(upperRight)))
+      , numElements_(new std::vector< size_t >(std::move(numElements)))
+      , values_(new std::vector< RangeType >(std::move(values)))
+    {
+      // checks
+      if (lowerLeft_->size() < dimDomain)
+        DUNE_THROW(Dune::RangeError,
+                   "lowerLeft too small (is " << lowerLeft_->size() << ", should be " << dimDomain << ")");
+      if (upperRight_->size() < dimDomain)
+        DUNE_THROW(Dune::RangeError,
+                   "upperRight too small (is " << upperRight_->size() << ", should be " << dimDomain << ")");
+      if (numElements_->size() < dimDomain)
+        DUNE_THROW(Dune::RangeError,
+                   "numElements too small (is " << numElements_->size() << ", should be " << dimDomain << ")");
+      size_t totalSubdomains = 1;
+      for (size_t dd = 0; dd < dimDomain; ++dd) {
+        const auto& ll = (*lowerLeft_)[dd];
+        const auto& ur = (*upperRight_)[dd];
+        const auto& ne = (*numElements_)[dd];
+        if (!(ll < ur))
+          DUNE_THROW(Dune::RangeError, "lowerLeft has to be elementwise smaller than upperRight!");
+        totalSubdomains *= ne;
+      }
+      if (values_->size() < totalSubdomains)
+        DUNE_THROW(Dune::RangeError,
+                   "values too small (is " << values_->size() << ", should be " << totalSubdomains << ")");
+    } // Lookup(...)
+
+    const RangeType& value_of(const EntityType& entity) const
+    {
+      if (precomputed_) {
+        const size_t index = index_of(precomputed_->index_set, entity);
+        assert(index < precomputed_->subdomains.size());
+        return (*values_)[precomputed_->subdomains[index]];
+      }
+      return (*values_)[subdomain_of(entity)];
+    } // ... value_of(...)
+
+    size_t subdomain_of(const EntityType& entity) const
+    {
+      // decide on the subdomain the center of the entity belongs to
+      const auto center = entity.geometry().center();
+      const auto& ll = *lowerLeft_;
+      const auto& ur = *upperRight_;
+      const auto& ne = *numElements_;
+      size_t subdomain = 0;
+      size_t stride = 1;
+      for (size_t dd = 0; dd < dimDomain; ++dd) {
+        // for points that are on upperRight_[d], this selects one partition too much
+        // so we need to cap this
+        const size_t partition = std::min(size_t(std::floor(ne[dd]*((center[dd] - ll[dd])/(ur[dd] - ll[dd])))),
+                                          ne[dd] - 1);
+        subdomain += partition*stride;
+        stride *= ne[dd];
+      }
+      return subdomain;
+    } // ... subdomain_of(...)
+
+  private:
+    template< class I >
+    static size_t index_of(const I* index_set, const EntityType& entity)
+    {
+      assert(index_set->contains(entity));
+      return index_set->index(entity);
+    }
+
+    //! for entities which are no Dune::Entity, precompute() is not available
+    static size_t index_of(const void* /*index_set*/, const EntityType& /*entity*/)
+    {
+      DUNE_THROW(Dune::InvalidStateException, "This should not happen!");
+      return 0;
+    }
+
+    friend class Checkerboard;
+
+    std::shared_ptr< const std::vector< DomainFieldType > > lowerLeft_;
+    std::shared_ptr< const std::vector< DomainFieldType > > upperRight_;
+    std::shared_ptr< const std::vector< size_t > > numElements_;
+    std::shared_ptr< const std::vector< RangeType > > values_;
+    std::shared_ptr< const Precomputed > precomputed_;
+  }; // class Lookup
 
   class Localfunction
     : public LocalfunctionInterface< EntityImp, DomainFieldImp, domainDim, RangeFieldImp, rangeDim, rangeDimCols >
@@ -48,16 +179,22 @@ class Checkerboard
 
     typedef typename BaseType::JacobianRangeType JacobianRangeType;
 
-    Localfunction(const EntityType& ent,
-                  const RangeType value)
+    Localfunction(const EntityType& ent, const Lookup& lookup)
       : BaseType(ent)
-      , value_(value)
+      , lookup_(lookup)
+      , value_(lookup_.value_of(ent))
     {}
 
     Localfunction(const Localfunction& /*other*/) = delete;
 
     Localfunction& operator=(const Localfunction& /*other*/) = delete;
 
+    virtual void bind(const EntityType& ent) DS_OVERRIDE
+    {
+      BaseType::bind(ent);
+      value_ = lookup_.value_of(ent);
+    }
+
     virtual size_t order() const DS_OVERRIDE
     {
       return 0;
@@ -72,11 +209,23 @@ class Checkerboard
     virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE
     {
       assert(this->is_a_valid_point(xx));
-      ret *= RangeFieldType(0);
+      ret = JacobianRangeType(0);
+    }
+
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE
+    {
+      ret.assign(xxs.size(), value_);
+    }
+
+    virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const DS_OVERRIDE
+    {
+      ret.assign(xxs.size(), JacobianRangeType(0));
     }
 
   private:
-    const RangeType value_;
+    // not a reference to the checkerboard, since the local function may be bound after it is gone
+    const Lookup lookup_;
+    RangeType value_;
   }; // class Localfunction
 
 public:
@@ -144,51 +293,19 @@ public:
                std::vector< size_t >&& numElements,
                std::vector< RangeType >&& values,
                std::string nm = static_id())
-    : lowerLeft_(new std::vector< DomainFieldType >(std::move(lowerLeft)))
-    , upperRight_(new std::vector< DomainFieldType >(std::move(upperRight)))
-    , numElements_(new std::vector< size_t >(std::move(numElements)))
-    , values_(new std::vector< RangeType >(std::move(values)))
+    : lookup_(std::move(lowerLeft), std::move(upperRight), std::move(numElements), std::move(values))
     , name_(nm)
-  {
-    // checks
-    if (lowerLeft_->size() < dimDomain)
-      DUNE_THROW(Dune::RangeError,
-                 "lowerLeft too small (is " << lowerLeft_->size() << ", should be " << dimDomain << ")");
-    if (upperRight_->size() < dimDomain)
-      DUNE_THROW(Dune::RangeError,
-                 "upperRight too small (is " << upperRight_->size() << ", should be " << dimDomain << ")");
-    if (numElements_->size() < dimDomain)
-      DUNE_THROW(Dune::RangeError,
-                 "numElements too small (is " << numElements_->size() << ", should be " << dimDomain << ")");
-    size_t totalSubdomains = 1;
-    for (size_t dd = 0; dd < dimDomain; ++dd) {
-      const auto& ll = (*lowerLeft_)[dd];
-      const auto& ur = (*upperRight_)[dd];
-      const auto& ne = (*numElements_)[dd];
-      if (!(ll < ur))
-        DUNE_THROW(Dune::RangeError, "lowerLeft has to be elementwise smaller than upperRight!");
-      totalSubdomains *= ne;
-    }
-    if (values_->size() < totalSubdomains)
-      DUNE_THROW(Dune::RangeError,
-                 "values too small (is " << values_->size() << ", should be " << totalSubdomains << ")");
-  } // Checkerboard(...)
+  {}
 
   Checkerboard(const ThisType& other)
-    : lowerLeft_(other.lowerLeft_)
-    , upperRight_(other.upperRight_)
-    , numElements_(other.numElements_)
-    , values_(other.values_)
+    : lookup_(other.lookup_)
     , name_(other.name_)
   {}
 
   ThisType& operator=(const ThisType& other)
   {
     if (this != &other) {
-      lowerLeft_ = other.lowerLeft_;
-      upperRight_ = other.upperRight_;
-      numElements_ = other.numElements_;
-      values_ = other.values_;
+      lookup_ = other.lookup_;
       name_ = other.name_;
     }
     return *this;
@@ -206,34 +323,40 @@ public:
 
   virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const DS_OVERRIDE
   {
-    // decide on the subdomain the center of the entity belongs to
-    const auto center = entity.geometry().center();
-    std::vector< size_t > whichPartition(dimDomain, 0);
-    const auto& ll = *lowerLeft_;
-    const auto& ur = *upperRight_;
-    const auto& ne = *numElements_;
-    for (size_t dd = 0; dd < dimDomain; ++dd) {
-      // for points that are on upperRight_[d], this selects one partition too much
-      // so we need to cap this
-      whichPartition[dd] = std::min(size_t(std::floor(ne[dd]*((center[dd] - ll[dd])/(ur[dd] - ll[dd])))),
-                                    ne[dd] - 1);
+    return std::unique_ptr< Localfunction >(new Localfunction(entity, lookup_));
+  }
+
+  /**
+   * \brief Determines the subdomain of each codim 0 entity of grid_view once, so that local functions on these
+   *        entities only look up their value (by the index of the entity) instead of locating the entity center.
+   * \note  grid_view has to be a leaf grid view (its index set is stored, so the grid has to outlive this function
+   *        and its local functions). From then on, all entities given to local_function() have to be entities of
+   *        grid_view. If grid_view changes (refinement, load balancing), call precompute() again. The table is shared
+   *        with all copies made afterwards.
+   */
+  template< class GridViewType >
+  void precompute(const GridViewType& grid_view)
+  {
+    static_assert(std::is_same< typename GridViewType::IndexSet, IndexSetType >::value,
+                  "Only available for leaf grid views of the grid of EntityImp!");
+    auto precomputed = std::make_shared< Precomputed >();
+    precomputed->index_set = &grid_view.indexSet();
+    precomputed->subdomains.resize(precomputed->index_set->size(0));
+    const auto it_end = grid_view.template end< 0 >();
+    for (auto it = grid_view.template begin< 0 >(); it != it_end; ++it) {
+      const auto& entity = *it;
+      precomputed->subdomains[precomputed->index_set->index(entity)] = lookup_.subdomain_of(entity);
     }
-    size_t subdomain = 0;
-    if (dimDomain == 1)
-      subdomain = whichPartition[0];
-    else if (dimDomain == 2)
-      subdomain = whichPartition[0] + whichPartition[1]*ne[0];
-    else
-      subdomain = whichPartition[0] + whichPartition[1]*ne[0] + whichPartition[2]*ne[1]*ne[0];
-    // return the component that belongs to the subdomain
-    return std::unique_ptr< Localfunction >(new Localfunction(entity, (*values_)[subdomain]));
-  } // ... local_function(...)
+    lookup_.precomputed_ = precomputed;
+  } // ... precompute(...)
+
+  bool precomputed() const
+  {
+    return lookup_.precomputed_ != nullptr;
+  }
 
 private:
-  std::shared_ptr< const std::vector< DomainFieldType > > lowerLeft_;
-  std::shared_ptr< const std::vector< DomainFieldType > > upperRight_;
-  std::shared_ptr< const std::vector< size_t > > numElements_;
-  std::shared_ptr< const std::vector< RangeType > > values_;
+  Lookup lookup_;
   std::string name_;
 }; // class Checkerboard
 
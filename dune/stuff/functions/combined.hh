@@ -6,7 +6,9 @@
 #ifndef DUNE_STUFF_FUNCTIONS_COMBINED_HH
 #define DUNE_STUFF_FUNCTIONS_COMBINED_HH
 
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 #include "interfaces.hh"
 
@@ -87,6 +89,13 @@ class Difference
 
     LocalFunction& operator=(const LocalFunction& /*other*/) = delete;
 
+    virtual void bind(const EntityType& ent) DS_OVERRIDE
+    {
+      BaseType::bind(ent);
+      local_minuend_->bind(ent);
+      local_subtrahend_->bind(ent);
+    }
+
     virtual size_t order() const DS_OVERRIDE
     {
       return std::max(local_minuend_->order(), local_subtrahend_->order());
@@ -106,11 +115,29 @@ class Difference
       ret -= tmp_jacobian_range_;
     } // ... jacobian(...)
 
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE
+    {
+      local_minuend_->evaluate(xxs, ret);
+      local_subtrahend_->evaluate(xxs, tmp_ranges_);
+      for (size_t ii = 0; ii < xxs.size(); ++ii)
+        ret[ii] -= tmp_ranges_[ii];
+    } // ... evaluate(...)
+
+    virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const DS_OVERRIDE
+    {
+      local_minuend_->jacobian(xxs, ret);
+      local_subtrahend_->jacobian(xxs, tmp_jacobian_ranges_);
+      for (size_t ii = 0; ii < xxs.size(); ++ii)
+        ret[ii] -= tmp_jacobian_ranges_[ii];
+    } // ... jacobian(...)
+
   private:
-    const std::shared_ptr< const LocalMinuendType > local_minuend_;
-    const std::shared_ptr< const LocalSubtrahendType > local_subtrahend_;
+    const std::unique_ptr< LocalMinuendType > local_minuend_;
+    const std::unique_ptr< LocalSubtrahendType > local_subtrahend_;
     mutable RangeType tmp_range_;
     mutable JacobianRangeType tmp_jacobian_range_;
+    mutable std::vector< RangeType > tmp_ranges_;
+    mutable std::vector< JacobianRangeType > tmp_jacobian_ranges_;
   }; // class LocalFunction
 
 public:
@@ -9,6 +9,7 @@
 #define DUNE_STUFF_FUNCTIONS_CONSTANT_HH
 
 #include <memory>
+#include <vector>
 
 #include <dune/stuff/common/configtree.hh>
 
@@ -90,7 +91,18 @@ public:
 
   virtual void jacobian(const DomainType& /*x*/, JacobianRangeType& ret) const DS_OVERRIDE DS_FINAL
   {
-    ret *= 0.0;
+    ret = JacobianRangeType(0);
+  }
+
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE DS_FINAL
+  {
+    ret.assign(xxs.size(), constant_);
+  }
+
+  virtual void jacobian(const std::vector< DomainType >& xxs,
+                        std::vector< JacobianRangeType >& ret) const DS_OVERRIDE DS_FINAL
+  {
+    ret.assign(xxs.size(), JacobianRangeType(0));
   }
 
   virtual std::string name() const DS_OVERRIDE DS_FINAL
@@ -10,6 +10,8 @@
 # include <dune/grid/io/file/vtk/function.hh>
 #endif
 
+#include <memory>
+
 #include <dune/stuff/common/float_cmp.hh>
 //#include <dune/stuff/grid/entity.hh>
 
@@ -57,13 +59,17 @@ public:
   {
     assert(comp >= 0);
     assert(comp < dimRange);
-    const auto local_func = function_.local_function(en);
-    local_func->evaluate(xx, tmp_value_);
+    if (!local_function_)
+      local_function_ = function_.local_function(en);
+    else
+      local_function_->bind(en);
+    local_function_->evaluate(xx, tmp_value_);
     return tmp_value_[comp];
   }
 
 private:
   const FunctionType& function_;
+  mutable std::unique_ptr< typename FunctionType::LocalfunctionType > local_function_;
   mutable FieldVector< double, dimRange > tmp_value_;
   const std::string name_;
 }; // class VisualizationAdapter
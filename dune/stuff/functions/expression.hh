@@ -14,6 +14,7 @@
 #include <limits>
 
 #include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
 
 #include <dune/stuff/common/configtree.hh>
 #include <dune/stuff/common/exceptions.hh>
@@ -67,6 +68,7 @@ class Expression
       , function_(function)
       , order_(ord)
       , tmp_vector_(0)
+      , tmp_jacobian_(0)
     {}
 
     Localfunction(const Localfunction& /*other*/) = delete;
@@ -84,22 +86,56 @@ class Expression
       for (size_t ii = 0; ii < dimRange; ++ii) {
         auto& retRow = ret[ii];
         for (size_t jj = 0; jj < dimRangeCols; ++jj) {
-          retRow[jj] = tmp_vector_[ii*dimRange + jj];
+          retRow[jj] = tmp_vector_[ii*dimRangeCols + jj];
         }
       }
     } // ... evaluate(...)
 
-    virtual void jacobian(const DomainType& /*xx*/, JacobianRangeType& /*ret*/) const DS_OVERRIDE
+    virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE
     {
-      DUNE_THROW_COLORFULLY(NotImplemented,
-                            "If we decided on the JacobianRangeType of matrix valued functions we have to implement "
-                            << "gradients for this function!");
-    }
+      function_->jacobian(this->entity().geometry().global(xx), tmp_jacobian_);
+      for (size_t ii = 0; ii < dimRange; ++ii)
+        for (size_t jj = 0; jj < dimRangeCols; ++jj)
+          ret[ii][jj] = tmp_jacobian_[ii*dimRangeCols + jj];
+    } // ... jacobian(...)
+
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE
+    {
+      function_->evaluate(to_global(xxs), tmp_vectors_);
+      ret.resize(xxs.size());
+      for (size_t pp = 0; pp < xxs.size(); ++pp)
+        for (size_t ii = 0; ii < dimRange; ++ii)
+          for (size_t jj = 0; jj < dimRangeCols; ++jj)
+            ret[pp][ii][jj] = tmp_vectors_[pp][ii*dimRangeCols + jj];
+    } // ... evaluate(...)
+
+    virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const DS_OVERRIDE
+    {
+      function_->jacobian(to_global(xxs), tmp_jacobians_);
+      ret.resize(xxs.size());
+      for (size_t pp = 0; pp < xxs.size(); ++pp)
+        for (size_t ii = 0; ii < dimRange; ++ii)
+          for (size_t jj = 0; jj < dimRangeCols; ++jj)
+            ret[pp][ii][jj] = tmp_jacobians_[pp][ii*dimRangeCols + jj];
+    } // ... jacobian(...)
 
   private:
+    const std::vector< DomainType >& to_global(const std::vector< DomainType >& xxs) const
+    {
+      const auto geometry = this->entity().geometry();
+      tmp_points_.resize(xxs.size());
+      for (size_t pp = 0; pp < xxs.size(); ++pp)
+        tmp_points_[pp] = geometry.global(xxs[pp]);
+      return tmp_points_;
+    }
+
     const std::shared_ptr< const MathExpressionFunctionType > function_;
     const size_t order_;
     mutable FieldVector< RangeFieldType, dimRange*dimRangeCols > tmp_vector_;
+    mutable FieldMatrix< RangeFieldType, dimRange*dimRangeCols, dimDomain > tmp_jacobian_;
+    mutable std::vector< DomainType > tmp_points_;
+    mutable std::vector< FieldVector< RangeFieldType, dimRange*dimRangeCols > > tmp_vectors_;
+    mutable std::vector< FieldMatrix< RangeFieldType, dimRange*dimRangeCols, dimDomain > > tmp_jacobians_;
   }; // class Localfunction
 
 public:
@@ -277,15 +313,36 @@ public:
     function_->evaluate(xx, ret);
   }
 
+  /**
+   *  Uses the gradient expressions given on construction, if any, and the symbolically derived ones otherwise.
+   */
   virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE
   {
-    if (gradients_.size() == 0)
-      DUNE_THROW_COLORFULLY(NotImplemented, "This function does not provide any gradients!");
+    if (gradients_.size() == 0) {
+      function_->jacobian(xx, ret);
+      return;
+    }
     assert(gradients_.size() == dimRange);
     for (size_t ii = 0; ii < dimRange; ++ii) {
       gradients_[ii]->evaluate(xx, ret[ii]);
     }
   } // ... jacobian(...)
+
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE
+  {
+    function_->evaluate(xxs, ret);
+  }
+
+  virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const DS_OVERRIDE
+  {
+    if (gradients_.size() == 0) {
+      function_->jacobian(xxs, ret);
+      return;
+    }
+    ret.resize(xxs.size());
+    for (size_t pp = 0; pp < xxs.size(); ++pp)
+      jacobian(xxs[pp], ret[pp]);
+  } // ... jacobian(...)
 private:
   void build_gradients(const std::string variable,
                        const std::vector< std::vector< std::string > >& gradient_expressions)
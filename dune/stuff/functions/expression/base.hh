@@ -8,10 +8,13 @@
 #ifndef DUNE_STUFF_FUNCTION_EXPRESSION_BASE_HH
 #define DUNE_STUFF_FUNCTION_EXPRESSION_BASE_HH
 
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
 #include <dune/common/fvector.hh>
+#include <dune/common/fmatrix.hh>
 #include <dune/common/dynvector.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/static_assert.hh>
@@ -20,6 +23,7 @@
 #include <dune/stuff/common/color.hh>
 
 #include "mathexpr.hh"
+#include "bytecode.hh"
 
 namespace Dune {
 namespace Stuff {
@@ -88,16 +92,11 @@ public:
   void evaluate(const Dune::FieldVector< DomainFieldType, dimDomain >& arg,
                 Dune::FieldVector< RangeFieldType, dimRange >& ret) const
   {
-    // copy arg
-    for (typename Dune::FieldVector< DomainFieldType, dimDomain >::size_type ii = 0; ii < dimDomain; ++ii)
-      *(arg_[ii]) = arg[ii];
-    // copy ret
-    for (typename Dune::FieldVector< RangeFieldType, dimRange >::size_type ii = 0; ii < dimRange; ++ii)
-      ret[ii] = op_[ii]->Val();
+    evaluate_(arg, dimDomain, ret);
   }
 
   /**
-   *  \attention  arg will be used up to its size, ret will be resized!
+   *  \attention  arg will be used up to its size (the remaining coordinates are 0), ret will be resized!
    */
   void evaluate(const Dune::DynamicVector< DomainFieldType >& arg,
                 Dune::DynamicVector< RangeFieldType >& ret) const
@@ -106,12 +105,7 @@ public:
     assert(arg.size() > 0);
     if (ret.size() != dimRange)
       ret = Dune::DynamicVector< RangeFieldType >(dimRange);
-    // copy arg
-    for (int ii = 0; ii < std::min(domainDim, int(arg.size())); ++ii)
-      *(arg_[ii]) = arg[ii];
-    // copy ret
-    for (typename Dune::DynamicVector< RangeFieldType >::size_type ii = 0; ii < dimRange; ++ii)
-      ret[ii] = op_[ii]->Val();
+    evaluate_(arg, std::min(size_t(dimDomain), size_t(arg.size())), ret);
   }
 
   void evaluate(const Dune::FieldVector< DomainFieldType, dimDomain >& arg,
@@ -120,27 +114,52 @@ public:
     // check for sizes
     if (ret.size() != dimRange)
       ret = Dune::DynamicVector< RangeFieldType >(dimRange);
-    // copy arg
-    for (typename Dune::FieldVector< DomainFieldType, dimDomain >::size_type ii = 0; ii < dimDomain; ++ii)
-      *(arg_[ii]) = arg[ii];
-    // copy ret
-    for (typename Dune::DynamicVector< RangeFieldType >::size_type ii = 0; ii < dimRange; ++ii)
-      ret[ii] = op_[ii]->Val();
+    evaluate_(arg, dimDomain, ret);
   }
 
   /**
-   *  \attention  arg will be used up to its size
+   *  \attention  arg will be used up to its size (the remaining coordinates are 0)
    */
   void evaluate(const Dune::DynamicVector< DomainFieldType >& arg,
                 Dune::FieldVector< RangeFieldType, dimRange >& ret) const
   {
     assert(arg.size() > 0);
-    // copy arg
-    for (int ii = 0; ii < std::min(size_t(dimDomain), size_t(arg.size())); ++ii)
-      *(arg_[ii]) = arg[ii];
-    // copy ret
-    for (size_t ii = 0; ii < dimRange; ++ii)
-      ret[ii] = op_[ii]->Val();
+    evaluate_(arg, std::min(size_t(dimDomain), size_t(arg.size())), ret);
+  }
+
+  /**
+   *  \brief Evaluates all points at once, ret will be resized.
+   */
+  void evaluate(const std::vector< Dune::FieldVector< DomainFieldType, dimDomain > >& args,
+                std::vector< Dune::FieldVector< RangeFieldType, dimRange > >& ret) const
+  {
+    ret.resize(args.size());
+    apply(*bytecode_, op_, dimRange, args.data(), args.size(), dimDomain, [&](size_t pp, const double* results) {
+      for (size_t ii = 0; ii < dimRange; ++ii)
+        ret[pp][ii] = results[ii];
+    });
+  } // ... evaluate(...)
+
+  /**
+   *  \brief ret[ii][jj] is the derivative of the ii-th expression w.r.t. the jj-th variable.
+   *
+   *  The derivatives are derived symbolically (ROperation::Diff) and compiled like the expressions themselves.
+   */
+  void jacobian(const Dune::FieldVector< DomainFieldType, dimDomain >& arg,
+                Dune::FieldMatrix< RangeFieldType, dimRange, dimDomain >& ret) const
+  {
+    jacobian_(&arg, 1, [&](size_t) -> Dune::FieldMatrix< RangeFieldType, dimRange, dimDomain >& { return ret; });
+  }
+
+  /**
+   *  \brief Computes the jacobians in all points at once, ret will be resized.
+   */
+  void jacobian(const std::vector< Dune::FieldVector< DomainFieldType, dimDomain > >& args,
+                std::vector< Dune::FieldMatrix< RangeFieldType, dimRange, dimDomain > >& ret) const
+  {
+    ret.resize(args.size());
+    jacobian_(args.data(), args.size(),
+              [&](size_t pp) -> Dune::FieldMatrix< RangeFieldType, dimRange, dimDomain >& { return ret[pp]; });
   }
 
   void report(const std::string _name = "dune.stuff.function.mathexpressionbase",
@@ -161,6 +180,83 @@ public:
   } // void report(const std::string, std::ostream&, const std::string&) const
 
 private:
+  static const size_t max_stack_registers = 256;
+
+  template< class ArgType >
+  static void copy_arg(const ArgType& arg, const size_t num_args, double* values)
+  {
+    for (size_t ii = 0; ii < dimDomain; ++ii)
+      values[ii] = (ii < num_args) ? arg[ii] : 0.0;
+  }
+
+  /**
+   *  Evaluates the operations in all num_points points and hands the results for the pp-th point to store(pp, results).
+   *  Coordinates beyond num_args are treated as 0. Thread safe as long as the operations could be compiled: the
+   *  coordinates, all intermediate values and the results only live on the stack.
+   */
+  template< class ArgType, class StoreType >
+  void apply(const MathExpressionBytecode& bytecode,
+             ROperation* const* operations,
+             const size_t num_operations,
+             const ArgType* args,
+             const size_t num_points,
+             const size_t num_args,
+             const StoreType& store) const
+  {
+    assert(num_operations <= dimRange*dimDomain);
+    double values[dimDomain];
+    double results[dimRange*dimDomain];
+    if (bytecode.compiled()) {
+      double stack_registers[max_stack_registers];
+      std::vector< double > heap_registers;
+      double* registers = stack_registers;
+      if (bytecode.num_registers() > max_stack_registers) {
+        heap_registers.resize(bytecode.num_registers());
+        registers = heap_registers.data();
+      }
+      bytecode.prepare(registers);
+      for (size_t pp = 0; pp < num_points; ++pp) {
+        copy_arg(args[pp], num_args, values);
+        bytecode.run(values, results, registers);
+        store(pp, results);
+      }
+    } else {
+      // ROperation::Val() works on the shared arg_ and on its own internal stack
+      std::lock_guard< std::mutex > guard(mutex_);
+      for (size_t pp = 0; pp < num_points; ++pp) {
+        copy_arg(args[pp], num_args, values);
+        for (size_t ii = 0; ii < dimDomain; ++ii)
+          *(arg_[ii]) = values[ii];
+        for (size_t ii = 0; ii < num_operations; ++ii)
+          results[ii] = operations[ii]->Val();
+        store(pp, results);
+      }
+    }
+  } // ... apply(...)
+
+  template< class ArgType, class RetType >
+  void evaluate_(const ArgType& arg, const size_t num_args, RetType& ret) const
+  {
+    apply(*bytecode_, op_, dimRange, &arg, 1, num_args, [&](size_t, const double* results) {
+      for (size_t ii = 0; ii < dimRange; ++ii)
+        ret[ii] = results[ii];
+    });
+  } // ... evaluate_(...)
+
+  template< class RetAccessType >
+  void jacobian_(const Dune::FieldVector< DomainFieldType, dimDomain >* args,
+                 const size_t num_points,
+                 const RetAccessType& ret) const
+  {
+    apply(*gradient_bytecode_, gradient_op_, dimRange*dimDomain, args, num_points, dimDomain,
+          [&](size_t pp, const double* results) {
+      auto& ret_pp = ret(pp);
+      for (size_t ii = 0; ii < dimRange; ++ii)
+        for (size_t jj = 0; jj < dimDomain; ++jj)
+          ret_pp[ii][jj] = results[ii*dimDomain + jj];
+    });
+  } // ... jacobian_(...)
+
 //  void evaluate(const Dune::DynamicVector< DomainFieldType >& arg, RangeFieldType& ret) const
 //  {
 //    assert(dimRange == 1 && "I'm only here to be used by Functions::Parametric::Coefficient, which has dimrange == 1");
@@ -200,10 +296,26 @@ private:
     for (size_t ii = 0; ii < dimRange; ++ ii) {
       op_[ii] = new ROperation(expressions_[ii].c_str(), dimDomain, vararray_);
     }
+    // derive the gradients
+    for (size_t ii = 0; ii < dimRange; ++ii)
+      for (size_t jj = 0; jj < dimDomain; ++jj)
+        gradient_op_[ii*dimDomain + jj] = new ROperation(op_[ii]->Diff(*(var_arg_[jj])));
+    // lower the expressions and the gradients into one program each, ROperation::Val() is only used if that fails
+    const std::vector< const double* > variables(arg_, arg_ + dimDomain);
+    bytecode_ = std::unique_ptr< MathExpressionBytecode >(
+          new MathExpressionBytecode(std::vector< const ROperation* >(op_, op_ + dimRange), variables));
+    gradient_bytecode_ = std::unique_ptr< MathExpressionBytecode >(
+          new MathExpressionBytecode(std::vector< const ROperation* >(gradient_op_, gradient_op_ + dimRange*dimDomain),
+                                     variables));
   } // void setup(const std::string& _variable, const std::vector< std::string >& expressions)
 
   void cleanup()
   {
+    bytecode_.reset();
+    gradient_bytecode_.reset();
+    for (size_t ii = 0; ii < dimRange*dimDomain; ++ii) {
+      delete gradient_op_[ii];
+    }
     for (size_t ii = 0; ii < dimRange; ++ii) {
       delete op_[ii];
     }
@@ -221,6 +333,11 @@ private:
   RVar* var_arg_[dimDomain];
   RVar* vararray_[dimDomain];
   ROperation* op_[dimRange];
+  ROperation* gradient_op_[dimRange*dimDomain];
+  //! the evaluation only uses the bytecode, arg_, op_ and gradient_op_ are kept for the fallback
+  std::unique_ptr< const MathExpressionBytecode > bytecode_;
+  std::unique_ptr< const MathExpressionBytecode > gradient_bytecode_;
+  mutable std::mutex mutex_;
 }; // class MathExpressionBase
 
 
@@ -0,0 +1,252 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "bytecode.hh"
+
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace Dune {
+namespace Stuff {
+namespace Functions {
+
+
+/**
+ *  Lowers the trees into a list of nodes (constants, variables and operations on other nodes), folding operations
+ *  on constants and hash-consing everything else. The registers are only assigned in the end, once the number of
+ *  constants is known.
+ */
+class MathExpressionBytecode::Compiler
+{
+public:
+  static const size_t invalid = std::numeric_limits< size_t >::max();
+
+  struct Node
+  {
+    enum class Kind { Constant, Variable, Operation } kind;
+    OpCode op;
+    size_t lhs;
+    size_t rhs;
+    double value;
+    size_t variable;
+  };
+
+  explicit Compiler(const std::vector< const double* >& variables)
+    : variables_(variables)
+    , variable_ids_(variables.size(), invalid)
+  {}
+
+  const std::vector< Node >& nodes() const
+  {
+    return nodes_;
+  }
+
+  size_t lower(const ROperation* operation)
+  {
+    if (operation == NULL)
+      return invalid;
+    switch (operation->op) {
+    case ErrOp:
+      return constant(ErrVal);
+    case Num:
+      return constant(operation->ValC);
+    case Var:
+      for (size_t ii = 0; ii < variables_.size(); ++ii)
+        if (variables_[ii] == operation->pvarval)
+          return variable(ii);
+      return invalid;
+    case Add:
+      return binary(OpCode::Add, operation->mmb1, operation->mmb2);
+    case Sub:
+      return binary(OpCode::Sub, operation->mmb1, operation->mmb2);
+    case Mult:
+      return binary(OpCode::Mult, operation->mmb1, operation->mmb2);
+    case Div:
+      return binary(OpCode::Div, operation->mmb1, operation->mmb2);
+    case Pow:
+      return binary(OpCode::Pow, operation->mmb1, operation->mmb2);
+    case NthRoot:
+      return binary(OpCode::NthRoot, operation->mmb1, operation->mmb2);
+    case E10:
+      return binary(OpCode::E10, operation->mmb1, operation->mmb2);
+    case Opp:
+      return unary(OpCode::Opp, operation->mmb2);
+    case Abs:
+      return unary(OpCode::Abs, operation->mmb2);
+    case Sqrt:
+      return unary(OpCode::Sqrt, operation->mmb2);
+    case Sin:
+      return unary(OpCode::Sin, operation->mmb2);
+    case Cos:
+      return unary(OpCode::Cos, operation->mmb2);
+    case Tg:
+      return unary(OpCode::Tg, operation->mmb2);
+    case Ln:
+      return unary(OpCode::Ln, operation->mmb2);
+    case Exp:
+      return unary(OpCode::Exp, operation->mmb2);
+    case Acos:
+      return unary(OpCode::Acos, operation->mmb2);
+    case Asin:
+      return unary(OpCode::Asin, operation->mmb2);
+    case Atan: {
+      const ROperation* argument = operation->mmb2;
+      if (argument == NULL || argument->op != Juxt)
+        return unary(OpCode::Atan, argument);
+      // atan(y, x), anything with more than two arguments is left to ROperation::Val()
+      if (argument->mmb1 == NULL || argument->mmb2 == NULL
+          || argument->mmb1->op == Juxt || argument->mmb2->op == Juxt)
+        return invalid;
+      return binary(OpCode::Atan2, argument->mmb1, argument->mmb2);
+    }
+    default:
+      // Juxt, Fun
+      return invalid;
+    }
+  } // ... lower(...)
+
+private:
+  size_t constant(const double value)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const auto result = constant_ids_.find(bits);
+    if (result != constant_ids_.end())
+      return result->second;
+    nodes_.push_back(Node{Node::Kind::Constant, OpCode::Add, invalid, invalid, value, invalid});
+    constant_ids_[bits] = nodes_.size() - 1;
+    return nodes_.size() - 1;
+  } // ... constant(...)
+
+  size_t variable(const size_t ii)
+  {
+    if (variable_ids_[ii] == invalid) {
+      nodes_.push_back(Node{Node::Kind::Variable, OpCode::Add, invalid, invalid, 0, ii});
+      variable_ids_[ii] = nodes_.size() - 1;
+    }
+    return variable_ids_[ii];
+  } // ... variable(...)
+
+  size_t operation(const OpCode op, const size_t lhs, const size_t rhs)
+  {
+    if (lhs == invalid || rhs == invalid)
+      return invalid;
+    if (nodes_[lhs].kind == Node::Kind::Constant && nodes_[rhs].kind == Node::Kind::Constant)
+      return constant(apply(op, nodes_[lhs].value, nodes_[rhs].value));
+    const auto key = std::make_tuple(op, lhs, rhs);
+    const auto result = operation_ids_.find(key);
+    if (result != operation_ids_.end())
+      return result->second;
+    nodes_.push_back(Node{Node::Kind::Operation, op, lhs, rhs, 0, invalid});
+    operation_ids_[key] = nodes_.size() - 1;
+    return nodes_.size() - 1;
+  } // ... operation(...)
+
+  size_t binary(const OpCode op, const ROperation* lhs, const ROperation* rhs)
+  {
+    const size_t lhs_id = lower(lhs);
+    if (lhs_id == invalid)
+      return invalid;
+    return operation(op, lhs_id, lower(rhs));
+  }
+
+  size_t unary(const OpCode op, const ROperation* argument)
+  {
+    const size_t id = lower(argument);
+    return operation(op, id, id);
+  }
+
+  const std::vector< const double* >& variables_;
+  std::vector< size_t > variable_ids_;
+  std::vector< Node > nodes_;
+  std::map< std::uint64_t, size_t > constant_ids_;
+  std::map< std::tuple< OpCode, size_t, size_t >, size_t > operation_ids_;
+}; // class MathExpressionBytecode::Compiler
+
+const size_t MathExpressionBytecode::Compiler::invalid;
+
+
+MathExpressionBytecode::MathExpressionBytecode(const std::vector< const ROperation* >& operations,
+                                               const std::vector< const double* >& variables)
+  : compiled_(false)
+  , num_constants_(0)
+  , num_variables_(variables.size())
+{
+  typedef Compiler::Node Node;
+  Compiler compiler(variables);
+  std::vector< size_t > output_ids;
+  for (const ROperation* operation : operations) {
+    output_ids.push_back(compiler.lower(operation));
+    if (output_ids.back() == Compiler::invalid)
+      return;
+  }
+  const std::vector< Node >& nodes = compiler.nodes();
+  // only keep the constants that are actually referenced, folding leaves the intermediate ones behind
+  std::vector< bool > referenced(nodes.size(), false);
+  for (size_t id : output_ids)
+    referenced[id] = true;
+  for (const Node& node : nodes)
+    if (node.kind == Node::Kind::Operation)
+      referenced[node.lhs] = referenced[node.rhs] = true;
+  // assign the registers
+  std::vector< std::uint32_t > registers(nodes.size(), 0);
+  for (size_t ii = 0; ii < nodes.size(); ++ii)
+    if (nodes[ii].kind == Node::Kind::Constant && referenced[ii]) {
+      registers[ii] = std::uint32_t(constants_.size());
+      constants_.push_back(nodes[ii].value);
+    }
+  num_constants_ = constants_.size();
+  size_t num_temporaries = 0;
+  for (size_t ii = 0; ii < nodes.size(); ++ii) {
+    if (nodes[ii].kind == Node::Kind::Variable)
+      registers[ii] = std::uint32_t(num_constants_ + nodes[ii].variable);
+    else if (nodes[ii].kind == Node::Kind::Operation)
+      registers[ii] = std::uint32_t(num_constants_ + num_variables_ + num_temporaries++);
+  }
+  // emit, the nodes are already topologically sorted
+  for (const Node& node : nodes)
+    if (node.kind == Node::Kind::Operation)
+      instructions_.push_back(Instruction{node.op, registers[node.lhs], registers[node.rhs]});
+  for (size_t id : output_ids)
+    outputs_.push_back(registers[id]);
+  compiled_ = true;
+} // MathExpressionBytecode(...)
+
+bool MathExpressionBytecode::compiled() const
+{
+  return compiled_;
+}
+
+size_t MathExpressionBytecode::num_constants() const
+{
+  return num_constants_;
+}
+
+size_t MathExpressionBytecode::num_variables() const
+{
+  return num_variables_;
+}
+
+size_t MathExpressionBytecode::num_instructions() const
+{
+  return instructions_.size();
+}
+
+size_t MathExpressionBytecode::num_registers() const
+{
+  return num_constants_ + num_variables_ + instructions_.size();
+}
+
+const std::vector< MathExpressionBytecode::Instruction >& MathExpressionBytecode::instructions() const
+{
+  return instructions_;
+}
+
+
+} // namespace Functions
+} // namespace Stuff
+} // namespace Dune
@@ -0,0 +1,214 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_FUNCTION_EXPRESSION_BYTECODE_HH
+#define DUNE_STUFF_FUNCTION_EXPRESSION_BYTECODE_HH
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include "mathexpr.hh"
+
+namespace Dune {
+namespace Stuff {
+namespace Functions {
+
+
+/**
+ *  \brief Register based bytecode for a set of ROperation trees sharing the same variables.
+ *
+ *  All trees are lowered into one straight-line program: subtrees depending only on numbers are folded into
+ *  constants and structurally identical subtrees (within one tree as well as across trees) are computed only once.
+ *  The register file is laid out as [ constants | variables | temporaries ], every instruction writes exactly one
+ *  temporary. The operations reproduce the semantics of mathexpr.cc (including the ErrVal handling), but are carried
+ *  out in double precision where mathexpr.cc uses the long double functions (sinl, powl, pow10l, ...). evaluate() thus
+ *  yields the same values as ROperation::Val() up to a relative difference in the order of the machine epsilon.
+ *
+ *  If one of the trees contains something the bytecode does not cover (user defined RFunctions, juxtapositions other
+ *  than the arguments of atan(y, x)), compiled() returns false and the caller is expected to use ROperation::Val().
+ */
+class MathExpressionBytecode
+{
+public:
+  enum class OpCode : std::uint8_t
+  {
+    Add, Sub, Mult, Div, Pow, NthRoot, E10, Atan2,
+    Opp, Abs, Sqrt, Sin, Cos, Tg, Ln, Exp, Acos, Asin, Atan
+  };
+
+  struct Instruction
+  {
+    OpCode op;
+    std::uint32_t lhs;
+    std::uint32_t rhs;
+  };
+
+  /**
+   * \param operations  the trees to compile, the i-th result of evaluate() corresponds to operations[i]
+   * \param variables   the addresses the RVars of the trees point to, in the order the values are given to evaluate()
+   */
+  MathExpressionBytecode(const std::vector< const ROperation* >& operations,
+                         const std::vector< const double* >& variables);
+
+  bool compiled() const;
+
+  size_t num_constants() const;
+
+  size_t num_variables() const;
+
+  size_t num_instructions() const;
+
+  size_t num_registers() const;
+
+  const std::vector< Instruction >& instructions() const;
+
+  /**
+   * \brief Evaluates all compiled trees.
+   * \param arg       num_variables() values of the variables
+   * \param ret       receives one value per compiled tree
+   * \param registers scratch space of at least num_registers() doubles
+   */
+  void evaluate(const double* arg, double* ret, double* registers) const
+  {
+    prepare(registers);
+    run(arg, ret, registers);
+  }
+
+  /**
+   * \brief Loads the constants into the registers, which can then be used for any number of calls to run().
+   */
+  void prepare(double* registers) const
+  {
+    assert(compiled_);
+    for (size_t ii = 0; ii < num_constants_; ++ii)
+      registers[ii] = constants_[ii];
+  }
+
+  /**
+   * \brief Same as evaluate(), but expects prepare() to have been called on the registers.
+   */
+  void run(const double* arg, double* ret, double* registers) const
+  {
+    assert(compiled_);
+    double* variables = registers + num_constants_;
+    for (size_t ii = 0; ii < num_variables_; ++ii)
+      variables[ii] = arg[ii];
+    double* temporary = variables + num_variables_;
+    const Instruction* const end = instructions_.data() + instructions_.size();
+    for (const Instruction* instruction = instructions_.data(); instruction != end; ++instruction, ++temporary)
+      *temporary = apply(instruction->op, registers[instruction->lhs], registers[instruction->rhs]);
+    for (size_t ii = 0; ii < outputs_.size(); ++ii)
+      ret[ii] = registers[outputs_[ii]];
+  } // ... run(...)
+
+  /**
+   * \brief Applies a single operation, unary operations only use rhs (as ROperation::mmb2 does).
+   */
+  static inline double apply(const OpCode op, const double lhs, const double rhs)
+  {
+    // the same bounds as in mathexpr.cc, sqrt(DBL_MAX) and sqrt(DBL_MIN) spelled out to keep them out of memory
+    // (ErrVal == DBL_MAX exceeds all of them, so the explicit ErrVal checks of mathexpr.cc are only kept where needed)
+    constexpr double sqrtmaxfloat = 1.3407807929942596e+154;
+    constexpr double sqrtminfloat = 1.4916681462400413e-154;
+    constexpr double inveps = .1/DBL_EPSILON;
+    switch (op) {
+    case OpCode::Add:
+      if (std::abs(rhs) > sqrtmaxfloat || std::abs(lhs) > sqrtmaxfloat)
+        return ErrVal;
+      return lhs + rhs;
+    case OpCode::Sub:
+      if (std::abs(rhs) > sqrtmaxfloat || std::abs(lhs) > sqrtmaxfloat)
+        return ErrVal;
+      return lhs - rhs;
+    case OpCode::Mult:
+      if (std::abs(rhs) < sqrtminfloat)
+        return 0;
+      if (std::abs(rhs) > sqrtmaxfloat)
+        return ErrVal;
+      if (std::abs(lhs) < sqrtminfloat)
+        return 0;
+      if (std::abs(lhs) > sqrtmaxfloat)
+        return ErrVal;
+      return lhs*rhs;
+    case OpCode::Div:
+      if (std::abs(rhs) < sqrtminfloat || std::abs(rhs) > sqrtmaxfloat)
+        return ErrVal;
+      if (std::abs(lhs) < sqrtminfloat)
+        return 0;
+      if (std::abs(lhs) > sqrtmaxfloat)
+        return ErrVal;
+      return lhs/rhs;
+    case OpCode::Pow:
+      if (!lhs)
+        return 0;
+      if (rhs == ErrVal || lhs == ErrVal || std::abs(rhs*std::log(std::abs(lhs))) > DBL_MAX_EXP)
+        return ErrVal;
+      return (lhs > 0 || !std::fmod(rhs, 1)) ? std::pow(lhs, rhs) : ErrVal;
+    case OpCode::NthRoot:
+      if (lhs == ErrVal || rhs == ErrVal || !lhs || rhs*std::log(std::abs(lhs)) < DBL_MIN_EXP)
+        return ErrVal;
+      if (rhs >= 0)
+        return std::pow(rhs, 1/lhs);
+      return (std::abs(std::fmod(lhs, 2)) == 1) ? -std::pow(-rhs, 1/lhs) : ErrVal;
+    case OpCode::E10:
+      if (std::abs(rhs) < sqrtminfloat)
+        return 0;
+      if (std::abs(rhs) > DBL_MAX_10_EXP)
+        return ErrVal;
+      if (std::abs(lhs) < sqrtminfloat)
+        return 0;
+      if (std::abs(lhs) > sqrtmaxfloat)
+        return ErrVal;
+      return lhs*std::pow(10, rhs);
+    case OpCode::Atan2:
+      if (std::abs(rhs) > inveps || std::abs(lhs) > inveps)
+        return ErrVal;
+      return (lhs || rhs) ? std::atan2(lhs, rhs) : ErrVal;
+    case OpCode::Opp:
+      return (rhs == ErrVal) ? ErrVal : -rhs;
+    case OpCode::Abs:
+      return (rhs == ErrVal) ? ErrVal : std::abs(rhs);
+    case OpCode::Sqrt:
+      return (rhs > sqrtmaxfloat || rhs < 0) ? ErrVal : std::sqrt(rhs);
+    case OpCode::Sin:
+      return (std::abs(rhs) > inveps) ? ErrVal : std::sin(rhs);
+    case OpCode::Cos:
+      return (std::abs(rhs) > inveps) ? ErrVal : std::cos(rhs);
+    case OpCode::Tg:
+      return (std::abs(rhs) > inveps) ? ErrVal : std::tan(rhs);
+    case OpCode::Ln:
+      return (rhs == ErrVal || rhs <= 0) ? ErrVal : std::log(rhs);
+    case OpCode::Exp:
+      return (rhs > DBL_MAX_EXP) ? ErrVal : std::exp(rhs);
+    case OpCode::Acos:
+      return (std::abs(rhs) > 1) ? ErrVal : std::acos(rhs);
+    case OpCode::Asin:
+      return (std::abs(rhs) > 1) ? ErrVal : std::asin(rhs);
+    case OpCode::Atan:
+      return (rhs == ErrVal) ? ErrVal : std::atan(rhs);
+    }
+    return ErrVal;
+  } // ... apply(...)
+
+private:
+  class Compiler;
+
+  bool compiled_;
+  size_t num_constants_;
+  size_t num_variables_;
+  std::vector< double > constants_;
+  std::vector< Instruction > instructions_;
+  std::vector< std::uint32_t > outputs_;
+}; // class MathExpressionBytecode
+
+
+} // namespace Functions
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_FUNCTION_EXPRESSION_BYTECODE_HH
@@ -85,19 +85,18 @@ public:
   public:
     Localfunction(const EntityImp& entity, const ThisType& global_function)
       : LocalfunctionBaseType(entity)
-      , geometry_(entity.geometry())
       , global_function_(global_function)
     {}
 
     virtual void evaluate(const DomainType& xx, RangeType& ret) const
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.evaluate(xx_global, ret);
     }
 
     virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.jacobian(xx_global, ret);
     }
 
@@ -107,7 +106,6 @@ public:
     }
 
   private:
-      const typename EntityImp::Geometry geometry_;
       const ThisType& global_function_;
   };
 
@@ -186,19 +184,18 @@ public:
   public:
     Localfunction(const EntityImp& entity, const ThisType& global_function)
       : LocalfunctionBaseType(entity)
-      , geometry_(entity.geometry())
       , global_function_(global_function)
     {}
 
     virtual void evaluate(const DomainType& xx, RangeType& ret) const
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.evaluate(xx_global, ret);
     }
 
     virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.jacobian(xx_global, ret);
     }
 
@@ -208,7 +205,6 @@ public:
     }
 
   private:
-      const typename EntityImp::Geometry geometry_;
       const ThisType& global_function_;
   };
 
@@ -249,7 +245,7 @@ public:
 
   virtual void jacobian(const DomainType& /*x*/, JacobianRangeType& ret) const DS_FINAL
   {
-    ret *= 0.0;
+    ret = JacobianRangeType(0);
   }
 
 private:
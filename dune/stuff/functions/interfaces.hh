@@ -80,10 +80,11 @@ class LocalfunctionSetInterface
     typedef Dune::FieldVector< RangeFieldType, dimRange > type;
   };
 
+  //! ret[ii] is the jacobian of the ii-th row
   template< int dimDomain, class RangeFieldType, int dimRange, int dimRangeCols >
   struct JacobianRangeTypeSelector
   {
-    typedef double type;
+    typedef Dune::FieldVector< Dune::FieldMatrix< RangeFieldType, dimRangeCols, dimDomain >, dimRange > type;
   };
 
   template< int dimDomain, class RangeFieldType, int dimRange >
@@ -106,14 +107,26 @@ public:
   typedef typename JacobianRangeTypeSelector< dimDomain, RangeFieldType, dimRange, dimRangeCols >::type JacobianRangeType;
 
   LocalfunctionSetInterface(const EntityType& ent)
-    : entity_(ent)
+    : entity_(&ent)
   {}
 
   virtual ~LocalfunctionSetInterface() {}
 
   virtual const EntityType& entity() const
   {
-    return entity_;
+    return *entity_;
+  }
+
+  /**
+   * \brief Rebinds this object to another entity, without allocating.
+   *
+   *        This allows to obtain one local function (per thread) and reuse it for all entities of a grid walk. The
+   *        entity has to outlive the binding (as for the constructor). Implementations which cache entity dependent
+   *        data have to override this and call the bind() of their base class first.
+   */
+  virtual void bind(const EntityType& ent)
+  {
+    entity_ = &ent;
   }
 
   /**
@@ -165,7 +178,7 @@ protected:
 #endif
   }
 
-  const EntityType& entity_;
+  const EntityType* entity_;
 }; // class LocalfunctionSetInterface
 
 
@@ -229,6 +242,26 @@ public:
   }
   /* @} */
 
+  /**
+   * \defgroup batched ´´These methods evaluate several points (i.e. a whole quadrature) at once and resize ret. The
+   *                    default loops over the points, implementations should override them if they can do better.''
+   * @{
+   **/
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      evaluate(xxs[ii], ret[ii]);
+  }
+
+  virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      jacobian(xxs[ii], ret[ii]);
+  }
+  /* @} */
+
   /**
    * \defgroup provided ´´These methods are provided by the interface.''
    * @{
@@ -293,6 +326,10 @@ public:
    * \defgroup haveto ´´These methods have to be implemented.''
    * @{
    **/
+  /**
+   * \note The returned local function can be moved to other entities by LocalfunctionType::bind(), so one call per
+   *       grid walk (and thread) suffices.
+   */
   virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& /*entity*/) const = 0;
 
   virtual ThisType* copy() const = 0;
@@ -385,6 +422,26 @@ public:
     DUNE_THROW(NotImplemented, "This does not make sense yet for matrix-valued functions!");
   }
 
+  /**
+   * \brief Evaluates several points at once and resizes ret, override if you can do better than this loop.
+   */
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      evaluate(xxs[ii], ret[ii]);
+  }
+
+  /**
+   * \brief Computes the jacobians in several points at once and resizes ret, override if you can do better.
+   */
+  virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      jacobian(xxs[ii], ret[ii]);
+  }
+
   virtual std::unique_ptr< LocalfunctionType > local_function(const EntityImp& entity) const DS_OVERRIDE DS_FINAL
   {
     return Common::make_unique< Localfunction >(entity, *this);
@@ -397,30 +454,49 @@ private:
   public:
     Localfunction(const EntityImp& entity, const ThisType& global_function)
       : LocalfunctionType(entity)
-      , geometry_(entity.geometry())
       , global_function_(global_function)
     {}
 
     virtual void evaluate(const DomainType& xx, RangeType& ret) const DS_OVERRIDE DS_FINAL
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.evaluate(xx_global, ret);
     }
 
     virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE DS_FINAL
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.jacobian(xx_global, ret);
     }
 
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE DS_FINAL
+    {
+      global_function_.evaluate(to_global(xxs), ret);
+    }
+
+    virtual void jacobian(const std::vector< DomainType >& xxs,
+                          std::vector< JacobianRangeType >& ret) const DS_OVERRIDE DS_FINAL
+    {
+      global_function_.jacobian(to_global(xxs), ret);
+    }
+
     virtual size_t order() const DS_OVERRIDE DS_FINAL
     {
       return global_function_.order();
     }
 
   private:
-      const typename EntityImp::Geometry geometry_;
+    const std::vector< DomainType >& to_global(const std::vector< DomainType >& xxs) const
+    {
+      const auto geometry = this->entity().geometry();
+      xxs_global_.resize(xxs.size());
+      for (size_t ii = 0; ii < xxs.size(); ++ii)
+        xxs_global_[ii] = geometry.global(xxs[ii]);
+      return xxs_global_;
+    }
+
       const ThisType& global_function_;
+      mutable std::vector< DomainType > xxs_global_;
   }; //class Localfunction
 }; // class GlobalFunctionInterface
 
@@ -488,6 +564,26 @@ public:
     DUNE_THROW(NotImplemented, "You have to imlement it if you intend to use it!");
   }
 
+  /**
+   * \brief Evaluates several points at once and resizes ret, override if you can do better than this loop.
+   */
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      evaluate(xxs[ii], ret[ii]);
+  }
+
+  /**
+   * \brief Computes the jacobians in several points at once and resizes ret, override if you can do better.
+   */
+  virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      jacobian(xxs[ii], ret[ii]);
+  }
+
   virtual std::unique_ptr< LocalfunctionType > local_function(const EntityImp& entity) const DS_OVERRIDE DS_FINAL
   {
     return Common::make_unique< Localfunction >(entity, *this);
@@ -500,30 +596,49 @@ private:
   public:
     Localfunction(const EntityImp& entity, const ThisType& global_function)
       : LocalfunctionType(entity)
-      , geometry_(entity.geometry())
       , global_function_(global_function)
     {}
 
     virtual void evaluate(const DomainType& xx, RangeType& ret) const DS_OVERRIDE DS_FINAL
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.evaluate(xx_global, ret);
     }
 
     virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE DS_FINAL
     {
-      const auto xx_global = geometry_.global(xx);
+      const auto xx_global = this->entity().geometry().global(xx);
       global_function_.jacobian(xx_global, ret);
     }
 
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE DS_FINAL
+    {
+      global_function_.evaluate(to_global(xxs), ret);
+    }
+
+    virtual void jacobian(const std::vector< DomainType >& xxs,
+                          std::vector< JacobianRangeType >& ret) const DS_OVERRIDE DS_FINAL
+    {
+      global_function_.jacobian(to_global(xxs), ret);
+    }
+
     virtual size_t order() const DS_OVERRIDE DS_FINAL
     {
       return global_function_.order();
     }
 
   private:
-      const typename EntityImp::Geometry geometry_;
+    const std::vector< DomainType >& to_global(const std::vector< DomainType >& xxs) const
+    {
+      const auto geometry = this->entity().geometry();
+      xxs_global_.resize(xxs.size());
+      for (size_t ii = 0; ii < xxs.size(); ++ii)
+        xxs_global_[ii] = geometry.global(xxs[ii]);
+      return xxs_global_;
+    }
+
       const ThisType& global_function_;
+      mutable std::vector< DomainType > xxs_global_;
   }; //class Localfunction
 }; // class GlobalFunctionInterface< ..., 1 >
 
@@ -587,6 +702,16 @@ public:
     return ret;
   }
 
+  /**
+   * \brief Evaluates several points at once and resizes ret, override if you can do better than this loop.
+   */
+  virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const
+  {
+    ret.resize(xxs.size());
+    for (size_t ii = 0; ii < xxs.size(); ++ii)
+      evaluate(xxs[ii], ret[ii]);
+  }
+
   virtual void jacobian(const DomainType& /*x*/, JacobianRangeType& /*ret*/) const
   {
     DUNE_THROW(Dune::NotImplemented, "You really have to implement this!");
@@ -8,25 +8,29 @@
 #ifdef DUNE_STUFF_FUNCTIONS_TO_LIB
 # include "spe10.hh"
 
-# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(etype, ddim, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_RANGEFIELDTYPES(etype, double, ddim, rdim, rcdim)
+# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(cname, etype, ddim, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_RANGEFIELDTYPES(cname, etype, double, ddim, rdim, rcdim)
 
-# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_RANGEFIELDTYPES(etype, dftype, ddim, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(etype, dftype, ddim, double, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(etype, dftype, ddim, long double, rdim, rcdim)
+# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_RANGEFIELDTYPES(cname, etype, dftype, ddim, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(cname, etype, dftype, ddim, double, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(cname, etype, dftype, ddim, long double, rdim, rcdim)
 
-# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(etype, dftype, ddim, rftype, rdim, rcdim) \
-  template class Dune::Stuff::Functions::Spe10Model1< etype, dftype, ddim, rftype, rdim, rcdim >;
+# define DUNE_STUFF_FUNCTIONS_SPE10_CC_LAST_EXPANSION(cname, etype, dftype, ddim, rftype, rdim, rcdim) \
+  template class Dune::Stuff::Functions::cname< etype, dftype, ddim, rftype, rdim, rcdim >;
 
 # if HAVE_DUNE_GRID
 
-DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesSGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesSGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesSGrid3dEntityType, 3, 3, 3)
 
-DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesYaspGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesYaspGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesYaspGrid3dEntityType, 3, 3, 3)
 
 #   if HAVE_ALUGRID_SERIAL_H || HAVE_ALUGRID_PARALLEL_H
 
-DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesAluSimplexGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesAluSimplexGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesAluSimplexGrid3dEntityType, 3, 3, 3)
+DUNE_STUFF_FUNCTIONS_SPE10_CC_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesAluCubeGrid3dEntityType, 3, 3, 3)
 
 #   endif // HAVE_ALUGRID_SERIAL_H || HAVE_ALUGRID_PARALLEL_H
 # endif // HAVE_DUNE_GRID
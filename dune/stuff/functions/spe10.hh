@@ -6,6 +6,8 @@
 #ifndef DUNE_STUFF_FUNCTIONS_SPE10_HH
 #define DUNE_STUFF_FUNCTIONS_SPE10_HH
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 
@@ -15,6 +17,7 @@
 #include <dune/stuff/common/string.hh>
 
 #include "checkerboard.hh"
+#include "spe10/permeability.hh"
 
 
 namespace Dune {
@@ -64,6 +67,10 @@ private:
   static const RangeFieldType minValue;
   static const RangeFieldType maxValue;
 
+  /**
+   * \brief Reads the Kx values of the first layer.
+   * \param filename either the original text file or a binary file written by Spe10::convert_to_binary()
+   */
   static std::vector< RangeType > read_values_from_file(const std::string& filename,
                                                         const RangeFieldType& min,
                                                         const RangeFieldType& max)
@@ -74,27 +81,13 @@ private:
                             "max (is " << max << ") has to be larger than min (is " << min << ")!");
     const RangeFieldType scale = (max - min) / (maxValue - minValue);
     const RangeType shift = min - scale*minValue;
-    // read all the data from the file
-    std::ifstream datafile(filename);
-    if (datafile.is_open()) {
-      static const size_t entriesPerDim = numXelements*numYelements*numZelements;
-      // create storage (there should be exactly 6000 values in the file, but we onyl read the first 2000)
-      std::vector< RangeType > data(entriesPerDim, RangeFieldType(0));
-      double tmp = 0;
-      size_t counter = 0;
-      while (datafile >> tmp && counter < entriesPerDim) {
-        data[counter] = (tmp * scale) + shift;
-        ++counter;
-      }
-      datafile.close();
-      if (counter != entriesPerDim)
-        DUNE_THROW_COLORFULLY(Dune::IOError,
-                              "wrong number of entries in '" << filename << "' (are " << counter << ", should be "
-                              << entriesPerDim << ")!");
-      return data;
-    } else
-      DUNE_THROW_COLORFULLY(Dune::IOError, "could not open '" << filename << "'!");
-  } // Spe10Model1()
+    const Spe10::PermeabilityData permeability(filename, {{numXelements, numYelements, numZelements}}, 1);
+    const double* const kx = permeability.component(0);
+    std::vector< RangeType > data(permeability.num_cells(), RangeFieldType(0));
+    for (size_t ii = 0; ii < data.size(); ++ii)
+      data[ii] = (kx[ii] * scale) + shift;
+    return data;
+  } // ... read_values_from_file(...)
 
 public:
   Spe10Model1(const std::string& filename,
@@ -165,30 +158,240 @@ template< class E, class D, class R >
 const typename Spe10Model1< E, D, 2, R, 1, 1 >::RangeFieldType Spe10Model1< E, D, 2, R, 1, 1 >::maxValue = 998.915;
 
 
+
+// default, to allow for specialization
+template< class EntityImp, class DomainFieldImp, int domainDim, class RangeFieldImp, int rangeDim, int rangeDimCols = 1 >
+class Spe10Model2
+{
+public:
+  Spe10Model2() = delete;
+}; // class Spe10Model2
+
+
+/**
+ *  \brief The permeability of the full 3d SPE10 model 2 (60 x 220 x 85 cells) as a diagonal tensor diag(Kx, Ky, Kz).
+ *
+ *  The values are not copied but used directly from the Spe10::PermeabilityData, which is shared between all copies
+ *  of the function. Use a binary file (see Spe10::convert_to_binary()) to have it memory mapped.
+ */
+template< class EntityImp, class DomainFieldImp, class RangeFieldImp >
+class Spe10Model2< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 >
+  : public LocalizableFunctionInterface< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 >
+{
+  typedef LocalizableFunctionInterface< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > BaseType;
+  typedef Spe10Model2< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > ThisType;
+
+  class Localfunction
+    : public LocalfunctionInterface< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 >
+  {
+    typedef LocalfunctionInterface< EntityImp, DomainFieldImp, 3, RangeFieldImp, 3, 3 > BaseType;
+  public:
+    typedef typename BaseType::EntityType EntityType;
+
+    typedef typename BaseType::DomainType        DomainType;
+    typedef typename BaseType::RangeType         RangeType;
+    typedef typename BaseType::JacobianRangeType JacobianRangeType;
+
+    Localfunction(const EntityType& ent,
+                  const std::shared_ptr< const Spe10::PermeabilityData >& permeability,
+                  const DomainType& lower_left,
+                  const DomainType& upper_right)
+      : BaseType(ent)
+      , permeability_(permeability)
+      , lower_left_(lower_left)
+      , upper_right_(upper_right)
+      , value_(value_of(*permeability_, lower_left_, upper_right_, ent))
+    {}
+
+    Localfunction(const Localfunction& /*other*/) = delete;
+
+    Localfunction& operator=(const Localfunction& /*other*/) = delete;
+
+    virtual void bind(const EntityType& ent) DS_OVERRIDE
+    {
+      BaseType::bind(ent);
+      value_ = value_of(*permeability_, lower_left_, upper_right_, ent);
+    }
+
+    virtual size_t order() const DS_OVERRIDE
+    {
+      return 0;
+    }
+
+    virtual void evaluate(const DomainType& xx, RangeType& ret) const DS_OVERRIDE
+    {
+      assert(this->is_a_valid_point(xx));
+      ret = value_;
+    }
+
+    virtual void jacobian(const DomainType& xx, JacobianRangeType& ret) const DS_OVERRIDE
+    {
+      assert(this->is_a_valid_point(xx));
+      ret = JacobianRangeType(0);
+    }
+
+    virtual void evaluate(const std::vector< DomainType >& xxs, std::vector< RangeType >& ret) const DS_OVERRIDE
+    {
+      ret.assign(xxs.size(), value_);
+    }
+
+    virtual void jacobian(const std::vector< DomainType >& xxs, std::vector< JacobianRangeType >& ret) const DS_OVERRIDE
+    {
+      ret.assign(xxs.size(), JacobianRangeType(0));
+    }
+
+  private:
+    // the data is owned jointly with the function, since bind() may be called after the function is gone
+    const std::shared_ptr< const Spe10::PermeabilityData > permeability_;
+    const DomainType lower_left_;
+    const DomainType upper_right_;
+    RangeType value_;
+  }; // class Localfunction
+
+public:
+  typedef typename BaseType::EntityType         EntityType;
+  typedef typename BaseType::LocalfunctionType  LocalfunctionType;
+
+  typedef typename BaseType::DomainFieldType  DomainFieldType;
+  static const int                            dimDomain = BaseType::dimDomain;
+  typedef typename BaseType::DomainType       DomainType;
+
+  typedef typename BaseType::RangeFieldType   RangeFieldType;
+  static const int                            dimRange = BaseType::dimRange;
+  static const int                            dimRangeCols = BaseType::dimRangeCols;
+  typedef typename BaseType::RangeType        RangeType;
+
+  static std::string static_id()
+  {
+    return BaseType::static_id() + ".spe10.model2";
+  }
+
+  static Common::ConfigTree default_config(const std::string sub_name = "")
+  {
+    Common::ConfigTree config;
+    config["filename"] = "spe_perm.dat";
+    config["lower_left"] = "[0.0 0.0 0.0]";
+    config["upper_right"] = "[365.76 670.56 51.816]";
+    config["name"] = static_id();
+    if (sub_name.empty())
+      return config;
+    else {
+      Common::ConfigTree tmp;
+      tmp.add(config, sub_name);
+      return tmp;
+    }
+  } // ... default_config(...)
+
+  static std::unique_ptr< ThisType > create(const Common::ConfigTree config = default_config(),
+                                            const std::string sub_name = static_id())
+  {
+    // get correct config
+    const Common::ConfigTree cfg = config.has_sub(sub_name) ? config.sub(sub_name) : config;
+    const Common::ConfigTree default_cfg = default_config();
+    // create
+    return Common::make_unique< ThisType >(
+          cfg.get("filename",     default_cfg.get< std::string >("filename")),
+          cfg.get("lower_left",   default_cfg.get< std::vector< DomainFieldType > >("lower_left"), dimDomain),
+          cfg.get("upper_right",  default_cfg.get< std::vector< DomainFieldType > >("upper_right"), dimDomain),
+          cfg.get("name",         default_cfg.get< std::string >("name")));
+  } // ... create(...)
+
+  /**
+   * \param filename  either the original spe_perm.dat or a binary file written by Spe10::convert_to_binary()
+   */
+  Spe10Model2(const std::string& filename,
+              std::vector< DomainFieldType >&& lowerLeft,
+              std::vector< DomainFieldType >&& upperRight,
+              const std::string nm = static_id())
+    : permeability_(std::make_shared< const Spe10::PermeabilityData >(filename,
+                                                                      Spe10::PermeabilityData::model2_cells(),
+                                                                      dimRange))
+    , name_(nm)
+  {
+    if (lowerLeft.size() < dimDomain)
+      DUNE_THROW(Dune::RangeError,
+                 "lowerLeft too small (is " << lowerLeft.size() << ", should be " << dimDomain << ")");
+    if (upperRight.size() < dimDomain)
+      DUNE_THROW(Dune::RangeError,
+                 "upperRight too small (is " << upperRight.size() << ", should be " << dimDomain << ")");
+    for (size_t dd = 0; dd < dimDomain; ++dd) {
+      if (!(lowerLeft[dd] < upperRight[dd]))
+        DUNE_THROW(Dune::RangeError, "lowerLeft has to be elementwise smaller than upperRight!");
+      lowerLeft_[dd] = lowerLeft[dd];
+      upperRight_[dd] = upperRight[dd];
+    }
+  } // Spe10Model2(...)
+
+  virtual ThisType* copy() const DS_OVERRIDE
+  {
+    return new ThisType(*this);
+  }
+
+  virtual std::string name() const DS_OVERRIDE
+  {
+    return name_;
+  }
+
+  virtual std::unique_ptr< LocalfunctionType > local_function(const EntityType& entity) const DS_OVERRIDE
+  {
+    return std::unique_ptr< Localfunction >(new Localfunction(entity, permeability_, lowerLeft_, upperRight_));
+  }
+
+private:
+  //! diag(Kx, Ky, Kz) of the cell the center of the entity belongs to
+  static RangeType value_of(const Spe10::PermeabilityData& permeability,
+                            const DomainType& lower_left,
+                            const DomainType& upper_right,
+                            const EntityType& entity)
+  {
+    const auto center = entity.geometry().center();
+    const auto& cells = permeability.cells();
+    size_t cell[dimDomain];
+    for (size_t dd = 0; dd < dimDomain; ++dd) {
+      const auto xx = cells[dd]*((center[dd] - lower_left[dd])/(upper_right[dd] - lower_left[dd]));
+      // cap points on upper_right (and outside, to be safe)
+      cell[dd] = std::min(size_t(std::max(std::floor(xx), DomainFieldType(0))), cells[dd] - 1);
+    }
+    RangeType ret(0);
+    for (size_t dd = 0; dd < dimRange; ++dd)
+      ret[dd][dd] = permeability.value(dd, cell[0], cell[1], cell[2]);
+    return ret;
+  } // ... value_of(...)
+
+  std::shared_ptr< const Spe10::PermeabilityData > permeability_;
+  DomainType lowerLeft_;
+  DomainType upperRight_;
+  std::string name_;
+}; // class Spe10Model2< ..., 3, ..., 3, 3 >
+
 } // namespace Functions
 } // namespace Stuff
 } // namespace Dune
 
 #ifdef DUNE_STUFF_FUNCTIONS_TO_LIB
-# define DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(etype, ddim, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_LIST_RANGEFIELDTYPES(etype, double, ddim, rdim, rcdim)
+# define DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(cname, etype, ddim, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_LIST_RANGEFIELDTYPES(cname, etype, double, ddim, rdim, rcdim)
 
-# define DUNE_STUFF_FUNCTIONS_SPE10_LIST_RANGEFIELDTYPES(etype, dftype, ddim, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(etype, dftype, ddim, double, rdim, rcdim) \
-  DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(etype, dftype, ddim, long double, rdim, rcdim)
+# define DUNE_STUFF_FUNCTIONS_SPE10_LIST_RANGEFIELDTYPES(cname, etype, dftype, ddim, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(cname, etype, dftype, ddim, double, rdim, rcdim) \
+  DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(cname, etype, dftype, ddim, long double, rdim, rcdim)
 
-# define DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(etype, dftype, ddim, rftype, rdim, rcdim) \
-  extern template class Dune::Stuff::Functions::Spe10Model1< etype, dftype, ddim, rftype, rdim, rcdim >;
+# define DUNE_STUFF_FUNCTIONS_SPE10_LAST_EXPANSION(cname, etype, dftype, ddim, rftype, rdim, rcdim) \
+  extern template class Dune::Stuff::Functions::cname< etype, dftype, ddim, rftype, rdim, rcdim >;
 
 # if HAVE_DUNE_GRID
 
-DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesSGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesSGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesSGrid3dEntityType, 3, 3, 3)
 
-DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesYaspGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesYaspGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesYaspGrid3dEntityType, 3, 3, 3)
 
 #   if HAVE_ALUGRID_SERIAL_H || HAVE_ALUGRID_PARALLEL_H
 
-DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(DuneStuffFunctionsInterfacesAluSimplexGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model1, DuneStuffFunctionsInterfacesAluSimplexGrid2dEntityType, 2, 1, 1)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesAluSimplexGrid3dEntityType, 3, 3, 3)
+DUNE_STUFF_FUNCTIONS_SPE10_LIST_DOMAINFIELDTYPES(Spe10Model2, DuneStuffFunctionsInterfacesAluCubeGrid3dEntityType, 3, 3, 3)
 
 #   endif // HAVE_ALUGRID_SERIAL_H || HAVE_ALUGRID_PARALLEL_H
 # endif // HAVE_DUNE_GRID
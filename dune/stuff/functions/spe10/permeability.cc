@@ -0,0 +1,195 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "config.h"
+
+#include "permeability.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <dune/stuff/common/exceptions.hh>
+
+namespace Dune {
+namespace Stuff {
+namespace Functions {
+namespace Spe10 {
+namespace {
+
+
+const char binary_magic[8] = {'D', 'S', 'S', 'P', 'E', '1', '0', '\n'};
+const std::uint32_t binary_version = 1;
+const std::uint32_t binary_byte_order_mark = 0x01020304;
+
+struct BinaryHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order_mark;
+  std::uint64_t num_components;
+  std::uint64_t cells[3];
+};
+
+static_assert(sizeof(BinaryHeader) == 48, "the values following the header have to be aligned");
+
+
+} // namespace
+
+
+class PermeabilityData::Mapping
+{
+public:
+  explicit Mapping(const std::string& filename)
+    : file_(filename.c_str(), boost::interprocess::read_only)
+    , region_(file_, boost::interprocess::read_only)
+  {}
+
+  const char* address() const
+  {
+    return static_cast< const char* >(region_.get_address());
+  }
+
+  size_t size() const
+  {
+    return region_.get_size();
+  }
+
+private:
+  boost::interprocess::file_mapping file_;
+  boost::interprocess::mapped_region region_;
+}; // class PermeabilityData::Mapping
+
+
+PermeabilityData::CellsType PermeabilityData::model1_cells()
+{
+  return CellsType{{100, 1, 20}};
+}
+
+PermeabilityData::CellsType PermeabilityData::model2_cells()
+{
+  return CellsType{{60, 220, 85}};
+}
+
+const size_t PermeabilityData::num_model_components;
+
+PermeabilityData::PermeabilityData(const std::string& filename, const CellsType& cells, const size_t num_components)
+  : cells_(cells)
+  , num_components_(num_components)
+  , values_(nullptr)
+{
+  if (num_components_ == 0 || num_cells() == 0)
+    DUNE_THROW_COLORFULLY(Exceptions::wrong_input_given, "cells and num_components must not be empty!");
+  if (is_binary(filename))
+    map_binary(filename);
+  else
+    read_text(filename);
+} // PermeabilityData(...)
+
+bool PermeabilityData::is_binary(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  char magic[sizeof(binary_magic)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, binary_magic, sizeof(magic)) == 0;
+}
+
+void PermeabilityData::write_binary(const std::string& filename) const
+{
+  BinaryHeader header;
+  std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+  header.version = binary_version;
+  header.byte_order_mark = binary_byte_order_mark;
+  header.num_components = num_components_;
+  for (size_t dd = 0; dd < 3; ++dd)
+    header.cells[dd] = cells_[dd];
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file)
+    DUNE_THROW_COLORFULLY(Dune::IOError, "could not open '" << filename << "' for writing!");
+  file.write(reinterpret_cast< const char* >(&header), sizeof(header));
+  file.write(reinterpret_cast< const char* >(values_), sizeof(double)*num_components_*num_cells());
+  if (!file)
+    DUNE_THROW_COLORFULLY(Dune::IOError, "could not write '" << filename << "'!");
+} // ... write_binary(...)
+
+bool PermeabilityData::mapped() const
+{
+  return bool(mapping_);
+}
+
+void PermeabilityData::read_text(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    DUNE_THROW_COLORFULLY(Dune::IOError, "could not open '" << filename << "'!");
+  // read the file in one go and parse in memory, which is much faster than operator>> on the stream
+  std::vector< char > content((std::istreambuf_iterator< char >(file)), std::istreambuf_iterator< char >());
+  content.push_back('\0');
+  const size_t num_values = num_components_*num_cells();
+  text_values_.resize(num_values);
+  const char* position = content.data();
+  size_t counter = 0;
+  while (counter < num_values) {
+    char* end = nullptr;
+    const double value = std::strtod(position, &end);
+    if (end == position)
+      break;
+    text_values_[counter++] = value;
+    position = end;
+  }
+  if (counter != num_values)
+    DUNE_THROW_COLORFULLY(Dune::IOError,
+                          "wrong number of entries in '" << filename << "' (are " << counter << ", should be at least "
+                          << num_values << ")!");
+  values_ = text_values_.data();
+} // ... read_text(...)
+
+void PermeabilityData::map_binary(const std::string& filename)
+{
+  try {
+    mapping_ = std::make_shared< const Mapping >(filename);
+  } catch (boost::interprocess::interprocess_exception& ee) {
+    DUNE_THROW_COLORFULLY(Dune::IOError, "could not map '" << filename << "': " << ee.what());
+  }
+  if (mapping_->size() < sizeof(BinaryHeader))
+    DUNE_THROW_COLORFULLY(Dune::IOError, "'" << filename << "' is too short!");
+  BinaryHeader header;
+  std::memcpy(&header, mapping_->address(), sizeof(header));
+  if (header.version != binary_version || header.byte_order_mark != binary_byte_order_mark)
+    DUNE_THROW_COLORFULLY(Dune::IOError,
+                          "'" << filename << "' was written by another version or on a machine of different byte "
+                          << "order, please convert it again!");
+  for (size_t dd = 0; dd < 3; ++dd)
+    if (header.cells[dd] != cells_[dd])
+      DUNE_THROW_COLORFULLY(Dune::IOError,
+                            "'" << filename << "' has " << header.cells[dd] << " cells in direction " << dd
+                            << " (should be " << cells_[dd] << ")!");
+  if (header.num_components < num_components_)
+    DUNE_THROW_COLORFULLY(Dune::IOError,
+                          "'" << filename << "' has only " << header.num_components << " components (should be at least "
+                          << num_components_ << ")!");
+  if (mapping_->size() != sizeof(BinaryHeader) + sizeof(double)*header.num_components*num_cells())
+    DUNE_THROW_COLORFULLY(Dune::IOError, "'" << filename << "' has the wrong size!");
+  values_ = reinterpret_cast< const double* >(mapping_->address() + sizeof(BinaryHeader));
+} // ... map_binary(...)
+
+
+void convert_to_binary(const std::string& text_filename,
+                       const std::string& binary_filename,
+                       const PermeabilityData::CellsType& cells,
+                       const size_t num_components)
+{
+  PermeabilityData(text_filename, cells, num_components).write_binary(binary_filename);
+}
+
+
+} // namespace Spe10
+} // namespace Functions
+} // namespace Stuff
+} // namespace Dune
@@ -0,0 +1,128 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_FUNCTIONS_SPE10_PERMEABILITY_HH
+#define DUNE_STUFF_FUNCTIONS_SPE10_PERMEABILITY_HH
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Dune {
+namespace Stuff {
+namespace Functions {
+namespace Spe10 {
+
+
+/**
+ *  \brief The permeability values of an SPE10 dataset.
+ *
+ *  The values are stored component by component (Kx, Ky, Kz), each component cell by cell with x running fastest,
+ *  then y, then z, as in the text files of the SPE (perm_case1.dat for model 1, spe_perm.dat for model 2).
+ *
+ *  Besides those text files, the binary format written by write_binary() can be read. Binary files are memory mapped
+ *  read only instead of being read, so opening them is instantaneous and all processes on a node (e.g. all MPI ranks)
+ *  share the same physical pages. The binary layout (in native byte order) is
+ *  \code
+ * char[8]   "DSSPE10\n"
+ * uint32    format version (1)
+ * uint32    byte order mark (0x01020304)
+ * uint64    number of components
+ * uint64[3] number of cells in x, y and z direction
+ * double[]  the values, as described above
+ *  \endcode
+ */
+class PermeabilityData
+{
+public:
+  typedef std::array< size_t, 3 > CellsType;
+
+  //! number of cells of the model 1 dataset (the y direction has a single layer)
+  static CellsType model1_cells();
+
+  //! number of cells of the model 2 dataset
+  static CellsType model2_cells();
+
+  static const size_t num_model_components = 3;
+
+  /**
+   * \brief Reads (text) or maps (binary) filename.
+   * \param cells           the expected number of cells in each direction
+   * \param num_components  the number of components which are needed, the file may contain more (which are ignored)
+   */
+  PermeabilityData(const std::string& filename, const CellsType& cells, const size_t num_components);
+
+  PermeabilityData(const PermeabilityData& /*other*/) = delete;
+
+  PermeabilityData& operator=(const PermeabilityData& /*other*/) = delete;
+
+  //! \return true, if filename starts like a file written by write_binary()
+  static bool is_binary(const std::string& filename);
+
+  //! writes the values in the binary format, to be opened by all subsequent runs
+  void write_binary(const std::string& filename) const;
+
+  const CellsType& cells() const
+  {
+    return cells_;
+  }
+
+  size_t num_cells() const
+  {
+    return cells_[0]*cells_[1]*cells_[2];
+  }
+
+  size_t num_components() const
+  {
+    return num_components_;
+  }
+
+  //! \return true, if the values are memory mapped
+  bool mapped() const;
+
+  //! \return the num_cells() values of the given component
+  const double* component(const size_t cc) const
+  {
+    assert(cc < num_components_);
+    return values_ + cc*num_cells();
+  }
+
+  double value(const size_t cc, const size_t xx, const size_t yy, const size_t zz) const
+  {
+    assert(xx < cells_[0] && yy < cells_[1] && zz < cells_[2]);
+    return component(cc)[xx + cells_[0]*(yy + cells_[1]*zz)];
+  }
+
+private:
+  class Mapping;
+
+  void read_text(const std::string& filename);
+
+  void map_binary(const std::string& filename);
+
+  CellsType cells_;
+  size_t num_components_;
+  std::vector< double > text_values_;
+  std::shared_ptr< const Mapping > mapping_;
+  const double* values_;
+}; // class PermeabilityData
+
+
+//! one time conversion of an SPE10 text file to the binary format of PermeabilityData
+void convert_to_binary(const std::string& text_filename,
+                       const std::string& binary_filename,
+                       const PermeabilityData::CellsType& cells,
+                       const size_t num_components = PermeabilityData::num_model_components);
+
+
+} // namespace Spe10
+} // namespace Functions
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_FUNCTIONS_SPE10_PERMEABILITY_HH
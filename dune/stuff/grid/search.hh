@@ -6,10 +6,14 @@
 #ifndef DUNE_STUFF_GRID_SEARCH_HH
 #define DUNE_STUFF_GRID_SEARCH_HH
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <vector>
 
-#include <boost/range/iterator_range.hpp>
-
 #if HAVE_DUNE_GEOMETRY
   #include <dune/geometry/referenceelements.hh>
 #else
@@ -20,12 +24,115 @@
 #include <dune/stuff/aliases.hh>
 #include <dune/stuff/common/ranges.hh>
 #include <dune/stuff/common/memory.hh>
+#include <dune/stuff/common/threadmanager.hh>
 
 namespace Dune {
 namespace Stuff {
 namespace Grid {
 
 
+/**
+ *  \brief The result of a search for a batch of points, one entry per point.
+ *
+ *  Only stores the positions of the found entities in the table of entity seeds of the search, so filling it does not
+ *  allocate once the result has been used for a batch of the same size (reuse one result for many searches). The
+ *  entries refer to the search that produced them and are only valid until the next search on the same object (for
+ *  searches that are not const) and as long as the search exists.
+ */
+template< class GridViewType >
+class EntitySearchResult
+{
+public:
+  typedef typename GridViewType::Grid GridType;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  typedef typename GridType::template Codim< 0 >::EntityPointer EntityPointerType;
+  typedef std::vector< EntitySeedType > EntitySeedVectorType;
+
+  static const size_t not_found = std::numeric_limits< size_t >::max();
+
+  EntitySearchResult()
+    : grid_(nullptr)
+    , seeds_(nullptr)
+  {}
+
+  size_t size() const
+  {
+    return positions_.size();
+  }
+
+  //! \return false, if point ii does not lie in the grid (view) that was searched
+  bool found(const size_t ii) const
+  {
+    assert(ii < positions_.size());
+    return positions_[ii] != not_found;
+  }
+
+  const EntitySeedType& seed(const size_t ii) const
+  {
+    assert(found(ii));
+    return (seeds_ ? *seeds_ : own_seeds_)[positions_[ii]];
+  }
+
+  EntityPointerType entityPointer(const size_t ii) const
+  {
+    assert(grid_);
+    return grid_->entityPointer(seed(ii));
+  }
+
+  /**
+   * \brief Prepares the result for a batch of size points, none of them found.
+   * \param seeds the table of entity seeds the positions refer to, has to outlive the result (or the next reset)
+   */
+  void reset(const GridType& grid, const EntitySeedVectorType& seeds, const size_t size)
+  {
+    grid_ = &grid;
+    seeds_ = &seeds;
+    positions_.assign(size, not_found);
+  }
+
+  /**
+   * \brief Prepares the result for a batch of size points, none of them found, the positions refer to the own table
+   *        of entity seeds of the result (see own_seeds()), which is emptied.
+   */
+  void reset(const GridType& grid, const size_t size)
+  {
+    grid_ = &grid;
+    seeds_ = nullptr;
+    own_seeds_.clear();
+    positions_.assign(size, not_found);
+  }
+
+  //! the table of entity seeds used after reset(grid, size), for searches without a table of their own
+  EntitySeedVectorType& own_seeds()
+  {
+    return own_seeds_;
+  }
+
+  //! the position of the entity containing point ii in the table of entity seeds or not_found
+  size_t& position(const size_t ii)
+  {
+    assert(ii < positions_.size());
+    return positions_[ii];
+  }
+
+  const size_t& position(const size_t ii) const
+  {
+    assert(ii < positions_.size());
+    return positions_[ii];
+  }
+
+private:
+  const GridType* grid_;
+  const EntitySeedVectorType* seeds_;
+  EntitySeedVectorType own_seeds_;
+  std::vector< size_t > positions_;
+}; // class EntitySearchResult
+
+template< class GridViewType >
+const size_t EntitySearchResult< GridViewType >::not_found;
+
+
 template< class GridViewType >
 class EntitySearchBase
 {
@@ -37,6 +144,18 @@ public:
   typedef typename EntityType::Geometry::LocalCoordinate LocalCoordinateType;
   typedef typename EntityType::Geometry::GlobalCoordinate GlobalCoordinateType;
   typedef std::vector< std::unique_ptr<typename EntityType::EntityPointer> > EntityPointerVectorType;
+  typedef EntitySearchResult< GridViewType > ResultType;
+
+protected:
+  //! converts result into one (possibly empty) pointer per point
+  static EntityPointerVectorType toEntityPointers(const ResultType& result)
+  {
+    EntityPointerVectorType ret(result.size());
+    for (size_t ii = 0; ii < result.size(); ++ii)
+      if (result.found(ii))
+        ret[ii] = DSC::make_unique< typename EntityType::EntityPointer >(*result.entityPointer(ii));
+    return ret;
+  }
 }; // class EntitySearchBase
 
 
@@ -50,78 +169,392 @@ class EntityInlevelSearch
   typedef typename GridViewType::template Codim< 0 >::Iterator IteratorType;
 public:
   typedef typename BaseType::EntityPointerVectorType EntityPointerVectorType;
+  typedef typename BaseType::ResultType ResultType;
 
 private:
-  inline typename EntityPointerVectorType::value_type check_add(const typename BaseType::EntityType& entity,
-                        const typename BaseType::GlobalCoordinateType& point) const {
+  inline bool contains(const typename BaseType::EntityType& entity,
+                       const typename BaseType::GlobalCoordinateType& point) const {
     const auto& geometry = entity.geometry();
     const auto& refElement = RefElementType::general(geometry.type());
-    if(refElement.checkInside(geometry.local(point)))
-    {
-      return DSC::make_unique<typename BaseType::EntityType::EntityPointer>(entity);
-    }
-    return nullptr;
+    return refElement.checkInside(geometry.local(point));
   }
 
 public:
   EntityInlevelSearch(const GridViewType& gridview)
     : gridview_(gridview)
     , it_last_(gridview_.template begin< 0 >())
-  {}
+    , position_last_(0)
+  {
+    seeds_.reserve(gridview_.size(0));
+    for (const auto& entity : DSC::viewRange(gridview_))
+      seeds_.push_back(entity.seed());
+  }
 
   template < class PointContainerType >
   EntityPointerVectorType operator() (const PointContainerType& points)
   {
-    const auto max_size = points.size();
+    ResultType result;
+    (*this)(points, result);
+    return BaseType::toEntityPointers(result);
+  } // ... operator()
 
+  //! searches all points, starting for each point with the entity the previous point was found in
+  template < class PointContainerType >
+  void operator() (const PointContainerType& points, ResultType& result)
+  {
+    result.reset(gridview_.grid(), seeds_, points.size());
     const IteratorType begin = gridview_.template begin< 0 >();
     const IteratorType end = gridview_.template end< 0 >();
-    EntityPointerVectorType ret(points.size());
-    typename EntityPointerVectorType::size_type idx(0);
+    size_t idx(0);
     for(const auto& point : points)
     {
       IteratorType it_current = it_last_;
+      size_t position = position_last_;
       bool it_reset = true;
-      typename EntityPointerVectorType::value_type tmp_ptr(nullptr);
-      for(; it_current != end; ++it_current)
+      for(; it_current != end; ++it_current, ++position)
       {
-        if((tmp_ptr = check_add(*it_current, point))) {
-          ret[idx++] = std::move(tmp_ptr);
-          tmp_ptr = nullptr;
+        if(contains(*it_current, point)) {
           it_reset = false;
-          it_last_ = it_current;
           break;
         }
       }
-      if(!it_reset)
-        continue;
-      for(it_current = begin;
-          it_current != it_last_;
-          ++it_current)
-      {
-        if((tmp_ptr = check_add(*it_current, point))) {
-          ret[idx++] = std::move(tmp_ptr);
-          tmp_ptr = nullptr;
-          it_reset = false;
-          it_last_ = it_current;
-          break;
+      if(it_reset) {
+        for(it_current = begin, position = 0;
+            it_current != it_last_;
+            ++it_current, ++position)
+        {
+          if(contains(*it_current, point)) {
+            it_reset = false;
+            break;
+          }
         }
       }
+      if(!it_reset) {
+        result.position(idx) = position;
+        it_last_ = it_current;
+        position_last_ = position;
+      }
+      ++idx;
     }
-    return ret;
   } // ... operator()
 
 private:
   const GridViewType gridview_;
+  typename ResultType::EntitySeedVectorType seeds_;
   IteratorType it_last_;
+  size_t position_last_;
 }; // class EntityInlevelSearch
 
 
+/**
+ *  \brief Locates points by means of an axis aligned bounding box tree over the elements of the grid view.
+ *
+ *  The tree is built once on construction (median splits along the longest axis of the element centers, a few
+ *  elements per leaf), a point query then only checks the elements whose bounding boxes contain the point, which is
+ *  O(log(#elements)) for reasonably shaped grids. Only entity seeds are stored, so the grid view has to stay unchanged
+ *  during the lifetime of the search. Queries are const and do not modify the search, but the candidates of the tree
+ *  are checked by means of their geometries, so concurrent queries are only safe if the grid may be accessed
+ *  concurrently (which is not the case for ALUGrid, for instance). Batches are thus searched on the calling thread.
+ *
+ *  If the elements turn out to be the cells of a uniform axis aligned tensor grid (as created by Providers::Cube with
+ *  cubes for YaspGrid, SGrid or ALUCubeGrid, also after global refinement), no tree is built and the cell containing
+ *  a point is computed arithmetically in O(1) instead, see structured(). This does not access the grid at all, so
+ *  large batches are then distributed over the threads of the ThreadManager.
+ */
+template< class GridViewType >
+class EntityBoundingBoxSearch
+  : public EntitySearchBase< GridViewType >
+{
+  typedef EntitySearchBase< GridViewType > BaseType;
+  typedef typename BaseType::EntityType EntityType;
+  typedef typename BaseType::GlobalCoordinateType GlobalCoordinateType;
+  typedef typename GlobalCoordinateType::value_type CoordinateFieldType;
+  static const int dimWorld = GlobalCoordinateType::dimension;
+  typedef GenericReferenceElements< typename  BaseType::LocalCoordinateType::value_type,
+                                              BaseType::LocalCoordinateType::dimension > RefElementType;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+
+  struct BoundingBox
+  {
+    bool contains(const GlobalCoordinateType& point) const
+    {
+      for (int dd = 0; dd < dimWorld; ++dd)
+        if (point[dd] < lower[dd] || point[dd] > upper[dd])
+          return false;
+      return true;
+    }
+
+    void merge(const BoundingBox& other)
+    {
+      for (int dd = 0; dd < dimWorld; ++dd) {
+        lower[dd] = std::min(lower[dd], other.lower[dd]);
+        upper[dd] = std::max(upper[dd], other.upper[dd]);
+      }
+    }
+
+    GlobalCoordinateType lower;
+    GlobalCoordinateType upper;
+  }; // struct BoundingBox
+
+  //! the first child of an inner node is the next node, leafs have second_child == 0
+  struct Node
+  {
+    BoundingBox box;
+    size_t first;
+    size_t last;
+    size_t second_child;
+  }; // struct Node
+
+  //! the median split bounds the depth of the tree by log2(#elements) + 1, so this suffices for the traversal stack
+  static const size_t max_stack_size = 2*std::numeric_limits< size_t >::digits;
+  static const size_t max_leaf_size = 4;
+
+public:
+  typedef typename BaseType::EntityPointerVectorType EntityPointerVectorType;
+  typedef typename BaseType::ResultType ResultType;
+
+  //! batches with at least this many points are searched in parallel, if structured()
+  static const size_t min_parallel_batch_size = 512;
+
+  EntityBoundingBoxSearch(const GridViewType& gridview)
+    : gridview_(gridview)
+  {
+    const size_t num_entities = gridview_.size(0);
+    seeds_.reserve(num_entities);
+    boxes_.reserve(num_entities);
+    std::vector< GlobalCoordinateType > centers;
+    centers.reserve(num_entities);
+    bool axis_aligned = (int(BaseType::LocalCoordinateType::dimension) == dimWorld);
+    for (const auto& entity : DSC::viewRange(gridview_)) {
+      const auto& geometry = entity.geometry();
+      BoundingBox box{geometry.corner(0), geometry.corner(0)};
+      for (int ii = 1; ii < geometry.corners(); ++ii)
+        box.merge(BoundingBox{geometry.corner(ii), geometry.corner(ii)});
+      // a cube filling its bounding box is the bounding box
+      if (axis_aligned) {
+        CoordinateFieldType box_volume(1);
+        for (int dd = 0; dd < dimWorld; ++dd)
+          box_volume *= box.upper[dd] - box.lower[dd];
+        axis_aligned = geometry.type().isCube() && std::abs(box_volume - geometry.volume()) <= 1e-10*box_volume;
+      }
+      seeds_.push_back(entity.seed());
+      boxes_.push_back(box);
+      centers.push_back(geometry.center());
+    }
+    if (seeds_.empty())
+      return;
+    if (axis_aligned && detect_structured(centers)) {
+      boxes_.clear();
+      return;
+    }
+    // a little slack, so that points on the boundary of an element are not lost due to rounding
+    for (auto& box : boxes_) {
+      CoordinateFieldType extent(0);
+      for (int dd = 0; dd < dimWorld; ++dd)
+        extent = std::max(extent, box.upper[dd] - box.lower[dd]);
+      for (int dd = 0; dd < dimWorld; ++dd) {
+        box.lower[dd] -= 1e-8*extent;
+        box.upper[dd] += 1e-8*extent;
+      }
+    }
+    std::vector< size_t > order(seeds_.size());
+    for (size_t ii = 0; ii < order.size(); ++ii)
+      order[ii] = ii;
+    nodes_.reserve(2*(order.size()/max_leaf_size + 1));
+    build(order, centers, 0, order.size());
+    // store the elements in the order of the leafs, so that each leaf covers a contiguous range
+    std::vector< EntitySeedType > seeds;
+    std::vector< BoundingBox > boxes;
+    seeds.reserve(order.size());
+    boxes.reserve(order.size());
+    for (size_t ii : order) {
+      seeds.push_back(seeds_[ii]);
+      boxes.push_back(boxes_[ii]);
+    }
+    seeds_.swap(seeds);
+    boxes_.swap(boxes);
+  } // EntityBoundingBoxSearch(...)
+
+  //! \return true, if the points are located arithmetically on a uniform tensor grid instead of using the tree
+  bool structured() const
+  {
+    return !cells_.empty();
+  }
+
+  /**
+   * \return one pointer per point, the entity containing the point or nullptr, if the point does not lie in the grid
+   *         view
+   */
+  template< class PointContainerType >
+  EntityPointerVectorType operator() (const PointContainerType& points) const
+  {
+    ResultType result;
+    (*this)(points, result);
+    return BaseType::toEntityPointers(result);
+  } // ... operator()
+
+  template< class PointContainerType >
+  void operator() (const PointContainerType& points, ResultType& result) const
+  {
+    result.reset(gridview_.grid(), seeds_, points.size());
+    const auto points_begin = std::begin(points);
+    const auto search_range = [&](const size_t first, const size_t last) {
+      auto point = points_begin;
+      std::advance(point, first);
+      for (size_t ii = first; ii < last; ++ii, ++point)
+        result.position(ii) = position_of(*point);
+    };
+    // only the arithmetic location does without the grid, see the class documentation
+    if (!structured() || result.size() < min_parallel_batch_size)
+      search_range(0, result.size());
+    else
+      ThreadManager::parallel_for(0, result.size(), search_range);
+  } // ... operator()
+
+private:
+  //! \return the position of the entity containing point in seeds_ or ResultType::not_found
+  size_t position_of(const GlobalCoordinateType& point) const
+  {
+    if (structured()) {
+      const size_t cell = cell_of(point);
+      return (cell == ResultType::not_found) ? cell : cells_[cell];
+    }
+    if (nodes_.empty())
+      return ResultType::not_found;
+    size_t stack[max_stack_size];
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+      const size_t node_index = stack[--stack_size];
+      const Node& node = nodes_[node_index];
+      if (!node.box.contains(point))
+        continue;
+      if (node.second_child == 0) {
+        for (size_t ii = node.first; ii < node.last; ++ii) {
+          if (!boxes_[ii].contains(point))
+            continue;
+          const auto entity_pointer = gridview_.grid().entityPointer(seeds_[ii]);
+          const auto& geometry = entity_pointer->geometry();
+          const auto& refElement = RefElementType::general(geometry.type());
+          if (refElement.checkInside(geometry.local(point)))
+            return ii;
+        }
+      } else {
+        assert(stack_size + 2 <= max_stack_size);
+        stack[stack_size++] = node.second_child;
+        stack[stack_size++] = node_index + 1;
+      }
+    }
+    return ResultType::not_found;
+  } // ... position_of(...)
+
+  /**
+   * \brief Checks if boxes_ are the cells of a uniform tensor grid and fills cells_ if so.
+   *
+   * The elements are known to coincide with their bounding boxes, so it suffices that they all have the same extents,
+   * that their number matches the one of the tensor grid and that no two elements share a cell.
+   */
+  bool detect_structured(const std::vector< GlobalCoordinateType >& centers)
+  {
+    BoundingBox domain = boxes_[0];
+    GlobalCoordinateType width(0);
+    for (int dd = 0; dd < dimWorld; ++dd)
+      width[dd] = boxes_[0].upper[dd] - boxes_[0].lower[dd];
+    for (const auto& box : boxes_) {
+      for (int dd = 0; dd < dimWorld; ++dd)
+        if (std::abs(box.upper[dd] - box.lower[dd] - width[dd]) > 1e-10*width[dd])
+          return false;
+      domain.merge(box);
+    }
+    size_t num_cells = 1;
+    for (int dd = 0; dd < dimWorld; ++dd) {
+      const CoordinateFieldType extent = domain.upper[dd] - domain.lower[dd];
+      const CoordinateFieldType num = std::round(extent/width[dd]);
+      if (num < 1 || std::abs(num*width[dd] - extent) > 1e-8*extent)
+        return false;
+      num_cells_[dd] = size_t(num);
+      strides_[dd] = num_cells;
+      cell_width_[dd] = extent/num;
+      num_cells *= num_cells_[dd];
+    }
+    if (num_cells != seeds_.size())
+      return false;
+    lower_left_ = domain.lower;
+    cells_.assign(num_cells, ResultType::not_found);
+    for (size_t ii = 0; ii < centers.size(); ++ii) {
+      const size_t cell = cell_of(centers[ii]);
+      if (cell == ResultType::not_found || cells_[cell] != ResultType::not_found) {
+        cells_.clear();
+        return false;
+      }
+      cells_[cell] = ii;
+    }
+    return true;
+  } // ... detect_structured(...)
+
+  //! \return the linear index of the cell of the tensor grid containing point or ResultType::not_found
+  size_t cell_of(const GlobalCoordinateType& point) const
+  {
+    size_t cell = 0;
+    for (int dd = 0; dd < dimWorld; ++dd) {
+      const CoordinateFieldType xx = (point[dd] - lower_left_[dd])/cell_width_[dd];
+      if (xx < -1e-8 || xx > num_cells_[dd] + 1e-8)
+        return ResultType::not_found;
+      // points on the boundary of the domain belong to the first and last cell, respectively
+      const size_t ii = std::min(size_t(std::max(xx, CoordinateFieldType(0))), num_cells_[dd] - 1);
+      cell += ii*strides_[dd];
+    }
+    return cell;
+  } // ... cell_of(...)
+
+  //! builds the subtree for order[first, last), in preorder
+  void build(std::vector< size_t >& order, const std::vector< GlobalCoordinateType >& centers,
+             const size_t first, const size_t last)
+  {
+    const size_t node_index = nodes_.size();
+    nodes_.push_back(Node{boxes_[order[first]], first, last, 0});
+    BoundingBox center_box{centers[order[first]], centers[order[first]]};
+    for (size_t ii = first + 1; ii < last; ++ii) {
+      nodes_[node_index].box.merge(boxes_[order[ii]]);
+      center_box.merge(BoundingBox{centers[order[ii]], centers[order[ii]]});
+    }
+    if (last - first <= max_leaf_size)
+      return;
+    int axis = 0;
+    for (int dd = 1; dd < dimWorld; ++dd)
+      if (center_box.upper[dd] - center_box.lower[dd] > center_box.upper[axis] - center_box.lower[axis])
+        axis = dd;
+    const size_t middle = first + (last - first)/2;
+    std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last,
+                     [&](const size_t lhs, const size_t rhs) { return centers[lhs][axis] < centers[rhs][axis]; });
+    build(order, centers, first, middle);
+    nodes_[node_index].second_child = nodes_.size();
+    build(order, centers, middle, last);
+  } // ... build(...)
+
+  const GridViewType gridview_;
+  typename ResultType::EntitySeedVectorType seeds_;
+  std::vector< BoundingBox > boxes_;
+  std::vector< Node > nodes_;
+  // only used for tensor grids: the position in seeds_ for each cell (lexicographically ordered)
+  std::vector< size_t > cells_;
+  GlobalCoordinateType lower_left_;
+  GlobalCoordinateType cell_width_;
+  std::array< size_t, dimWorld > num_cells_;
+  std::array< size_t, dimWorld > strides_;
+}; // class EntityBoundingBoxSearch
+
+template< class GridViewType >
+const size_t EntityBoundingBoxSearch< GridViewType >::min_parallel_batch_size;
+
+
 template< class GridViewType >
 class EntityHierarchicSearch
   : public EntitySearchBase< GridViewType >
 {
   typedef EntitySearchBase< GridViewType > BaseType;
+  typedef GenericReferenceElements< typename BaseType::LocalCoordinateType::value_type,
+                                    BaseType::LocalCoordinateType::dimension > RefElementType;
 
   const GridViewType gridview_;
   const int start_level_;
@@ -133,47 +566,57 @@ public:
   {}
 
   typedef typename BaseType::EntityPointerVectorType EntityPointerVectorType;
+  typedef typename BaseType::ResultType ResultType;
 
   template< class PointContainerType >
   EntityPointerVectorType operator() (const PointContainerType& points) const
   {
+    ResultType result;
+    (*this)(points, result);
+    return BaseType::toEntityPointers(result);
+  }
+
+  //! the found entities are collected in the own table of entity seeds of result
+  template< class PointContainerType >
+  void operator() (const PointContainerType& points, ResultType& result) const
+  {
+    result.reset(gridview_.grid(), points.size());
+    auto& seeds = result.own_seeds();
     auto level = std::min(gridview_.grid().maxLevel(), start_level_);
     auto range = DSC::viewRange(gridview_.grid().levelView(level));
-    return process(points, range);
+    size_t idx(0);
+    for (const auto& point : points) {
+      for (const auto& entity : range) {
+        if (process(entity, point, seeds)) {
+          result.position(idx) = seeds.size() - 1;
+          break;
+        }
+      }
+      ++idx;
+    }
   }
 
 private:
-  template <class QuadpointContainerType, class RangeType>
-  EntityPointerVectorType process(const QuadpointContainerType& quad_points,
-                                  const RangeType& range) const
-  {
-    typedef GenericReferenceElements< typename BaseType::LocalCoordinateType::value_type,
-        BaseType::LocalCoordinateType::dimension > RefElementType;
-    EntityPointerVectorType ret;
-
-    for(const auto& my_ent : range) {
-      const int my_level = my_ent.level();
-      const auto& geometry = my_ent.geometry();
-      const auto& refElement = RefElementType::general(geometry.type());
-      for(const auto& point : quad_points)
-      {
-        if(refElement.checkInside(geometry.local(point)))
-        {
-          //if I cannot descend further add this entity even if it's not my view
-          if(gridview_.grid().maxLevel() <= my_level || gridview_.contains(my_ent)) {
-            ret.emplace_back(my_ent);
-          }
-          else {
-            const auto h_end = my_ent.hend(my_level+1);
-            const auto h_begin = my_ent.hbegin(my_level+1);
-            const auto h_range = boost::make_iterator_range(h_begin, h_end);
-            const auto kids = process(QuadpointContainerType(1, point), h_range);
-            ret.insert(ret.end(), kids.begin(), kids.end());
-          }
-        }
-      }
+  //! descends from my_ent to the entity of the grid view containing point, which is appended to seeds
+  template< class PointType >
+  bool process(const typename BaseType::EntityType& my_ent, const PointType& point,
+               typename ResultType::EntitySeedVectorType& seeds) const
+  {
+    const int my_level = my_ent.level();
+    const auto& geometry = my_ent.geometry();
+    const auto& refElement = RefElementType::general(geometry.type());
+    if (!refElement.checkInside(geometry.local(point)))
+      return false;
+    //if I cannot descend further add this entity even if it's not my view
+    if(gridview_.grid().maxLevel() <= my_level || gridview_.contains(my_ent)) {
+      seeds.push_back(my_ent.seed());
+      return true;
     }
-    return ret;
+    const auto h_end = my_ent.hend(my_level+1);
+    for (auto h_it = my_ent.hbegin(my_level+1); h_it != h_end; ++h_it)
+      if (process(*h_it, point, seeds))
+        return true;
+    return false;
   }
 }; // class EntityHierarchicSearch
 
@@ -9,14 +9,18 @@
 #include <dune/common/static_assert.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/deprecated.hh>
+#include <dune/common/exceptions.hh>
 #include <dune/stuff/aliases.hh>
 #include <dune/stuff/common/math.hh>
 #include <dune/stuff/common/misc.hh>
 #include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/threadmanager.hh>
 #include <dune/grid/common/geometry.hh>
 #include <dune/stuff/aliases.hh>
 
 #include <vector>
+#include <cstdint>
+#include <type_traits>
 #include <boost/format.hpp>
 
 namespace Dune {
@@ -42,6 +46,32 @@ namespace {
   const GridWalkDummyFunctor gridWalkDummyFunctor;
 }
 
+/** \brief Opt in to the threaded walks for a grid by specializing this to std::true_type.
+ *
+ *  Only do so if several threads may access the grid concurrently, i.e. create entity pointers from seeds, compute
+ *  geometries and indices and iterate over intersections at the same time. Grids with mutable caches or lazily built
+ *  data structures do not allow this.
+ **/
+template< class GridType >
+struct AllowsConcurrentAccess
+  : public std::false_type
+{};
+
+namespace internal {
+
+//! calls target.reduce(other) if the functor provides this method
+template< class Functor, class OtherFunctor >
+auto reduceFunctor(Functor& target, const OtherFunctor& other, int) -> decltype(target.reduce(other), void())
+{
+  target.reduce(other);
+}
+
+template< class Functor, class OtherFunctor >
+void reduceFunctor(Functor& /*target*/, const OtherFunctor& /*other*/, long)
+{}
+
+} // namespace internal
+
 /** \brief applies Functors on each \ref Entity/\ref Intersection of a given \ref GridView
  *  \todo allow stacking of functor to save gridwalks?
  *  \tparam GridViewImp any \ref GridView interface compliant type
@@ -53,6 +83,7 @@ class GridWalk {
 public:
   GridWalk ( const GridViewType& gp )
     : gridView_( gp )
+    , cachedSize_( 0 )
   {}
 
   /** \param entityFunctor is applied on all codim 0 entities presented by \var gridView_
@@ -89,9 +120,216 @@ public:
   template< class Functor >
   void walkCodim0(Functor& f) const DUNE_DEPRECATED_MSG("use operator()(Functor) instead ");
 
+  /** \brief threaded variant of operator()(entityFunctor, intersectionFunctor)
+   *
+   *  Only threaded if AllowsConcurrentAccess is specialized to std::true_type for the grid, otherwise this calls
+   *  operator()(entityFunctor, intersectionFunctor). The entities are split into ThreadManager::max_threads() contiguous chunks, which are walked on the threads of
+   *  ThreadManager::run_in_parallel(). The calling thread applies the given functors, every other thread a copy of them
+   *  (made before the walk). Afterwards the copies are merged back by calling
+   *  entityFunctor.reduce(copy) and intersectionFunctor.reduce(copy), if the functors provide such a method.
+   *  The functors must thus not share mutable state between copies and must not write to data belonging to other
+   *  entities (like vertices or intersections), use walkColored() for the latter.
+   *  The seeds of the entities are collected on first use and kept for subsequent walks, see clearCache().
+   *  \note only instantiable for codim == 0
+   */
+  template < class EntityFunctor, class IntersectionFunctor >
+  void walkParallel(EntityFunctor& entityFunctor, IntersectionFunctor& intersectionFunctor) const
+  {
+    dune_static_assert( codim == 0, "walking in parallel is only possible for codim 0 entities" );
+    if (allowsConcurrentAccess)
+      walkPartitions(entitySeeds(), entityFunctor, intersectionFunctor);
+    else
+      (*this)(entityFunctor, intersectionFunctor);
+  }
+
+  //! threaded variant of operator()(entityFunctor), \sa walkParallel
+  template < class EntityFunctor >
+  void walkParallel(EntityFunctor& entityFunctor) const
+  {
+    dune_static_assert( codim == 0, "walking in parallel is only possible for codim 0 entities" );
+    if (allowsConcurrentAccess)
+      walkPartitions(entitySeeds(), entityFunctor);
+    else
+      (*this)(entityFunctor);
+  }
+
+  /** \brief threaded walk for functors which scatter into data shared between neighboring entities
+   *
+   *  The entities are greedily colored such that no two entities sharing a vertex have the same color. The colors are
+   *  walked one after another, the entities of each color in parallel as in walkParallel(). The coloring is computed
+   *  on first use and kept for subsequent walks, see clearCache(). Like walkParallel(), this is only threaded (and
+   *  only colors the grid) if AllowsConcurrentAccess is specialized to std::true_type for the grid.
+   *  \note only instantiable for codim == 0
+   */
+  template < class EntityFunctor, class IntersectionFunctor >
+  void walkColored(EntityFunctor& entityFunctor, IntersectionFunctor& intersectionFunctor) const
+  {
+    dune_static_assert( codim == 0, "walking in parallel is only possible for codim 0 entities" );
+    if (allowsConcurrentAccess)
+      walkPartitions(entityColors(), entityFunctor, intersectionFunctor);
+    else
+      (*this)(entityFunctor, intersectionFunctor);
+  }
+
+  //! \sa walkColored
+  template < class EntityFunctor >
+  void walkColored(EntityFunctor& entityFunctor) const
+  {
+    dune_static_assert( codim == 0, "walking in parallel is only possible for codim 0 entities" );
+    if (allowsConcurrentAccess)
+      walkPartitions(entityColors(), entityFunctor);
+    else
+      (*this)(entityFunctor);
+  }
+
+  //! number of colors used by walkColored()
+  size_t numColors() const
+  {
+    return entityColors().size();
+  }
+
+  /** \brief drops the entity seeds and colors kept by walkParallel() and walkColored()
+   *
+   *  Both are recomputed automatically if the number of entities of the grid view changed, but this does not cover
+   *  all modifications (e.g. refining and coarsening the same number of entities, or load balancing). Call this after
+   *  every adaptation of the grid.
+   */
+  void clearCache() const
+  {
+    seeds_.clear();
+    colors_.clear();
+    cachedSize_ = 0;
+  }
 
 private:
+  static const bool allowsConcurrentAccess
+      = AllowsConcurrentAccess< typename std::remove_const< typename GridViewType::Grid >::type >::value;
+  typedef typename GridViewType::template Codim< 0 >::Entity EntityType;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  typedef std::vector< std::vector< EntitySeedType > > PartitionsType;
+
+  //! drops the cached seeds and colors if the grid view has obviously changed
+  void checkCache() const
+  {
+    const size_t size = gridView_.size(0);
+    if (size != cachedSize_) {
+      clearCache();
+      cachedSize_ = size;
+    }
+  } // ... checkCache(...)
+
+  //! all entities as a single partition
+  const PartitionsType& entitySeeds() const
+  {
+    checkCache();
+    if (seeds_.empty()) {
+      seeds_.resize(1);
+      seeds_[0].reserve(gridView_.size(0));
+      for (const auto& entity : DSC::viewRange(gridView_))
+        seeds_[0].push_back(entity.seed());
+    }
+    return seeds_;
+  } // ... entitySeeds(...)
+
+  //! one partition per color, entities of the same color do not share a vertex
+  const PartitionsType& entityColors() const
+  {
+    checkCache();
+    if (colors_.empty()) {
+      static const int dimension = GridViewType::dimension;
+      static const size_t max_colors = 64;
+      const auto& index_set = gridView_.indexSet();
+      // bit c is set if the vertex belongs to an entity of color c
+      std::vector< std::uint64_t > vertex_colors(index_set.size(dimension), 0);
+      for (const auto& entity : DSC::viewRange(gridView_)) {
+        const int num_vertices = entity.template count< dimension >();
+        std::uint64_t used = 0;
+        for (int ii = 0; ii < num_vertices; ++ii)
+          used |= vertex_colors[index_set.subIndex(entity, ii, dimension)];
+        size_t color = 0;
+        while (color < max_colors && (used & (std::uint64_t(1) << color)))
+          ++color;
+        if (color == max_colors)
+          DUNE_THROW(Dune::NotImplemented, "Coloring grids which need more than " << max_colors << " colors!");
+        for (int ii = 0; ii < num_vertices; ++ii)
+          vertex_colors[index_set.subIndex(entity, ii, dimension)] |= std::uint64_t(1) << color;
+        if (color >= colors_.size())
+          colors_.resize(color + 1);
+        colors_[color].push_back(entity.seed());
+      }
+    }
+    return colors_;
+  } // ... entityColors(...)
+
+  template < class EntityFunctor, class IntersectionFunctor >
+  void walkSeeds(const std::vector< EntitySeedType >& seeds, const size_t first, const size_t last,
+                 EntityFunctor& entityFunctor, IntersectionFunctor& intersectionFunctor) const
+  {
+    for (size_t ii = first; ii < last; ++ii) {
+      const auto entityPointer = gridView_.grid().entityPointer(seeds[ii]);
+      const auto& entity = *entityPointer;
+      entityFunctor(entity, gridView_.indexSet().index(entity));
+      for (const auto& intersection : DSC::intersectionRange(gridView_, entity))
+        intersectionFunctor(entity, intersection);
+    }
+  } // ... walkSeeds(...)
+
+  template < class EntityFunctor >
+  void walkSeeds(const std::vector< EntitySeedType >& seeds, const size_t first, const size_t last,
+                 EntityFunctor& entityFunctor) const
+  {
+    for (size_t ii = first; ii < last; ++ii) {
+      const auto entityPointer = gridView_.grid().entityPointer(seeds[ii]);
+      const auto& entity = *entityPointer;
+      entityFunctor(entity, gridView_.indexSet().index(entity));
+    }
+  } // ... walkSeeds(...)
+
+  template < class EntityFunctor, class IntersectionFunctor >
+  void walkPartitions(const PartitionsType& partitions,
+                      EntityFunctor& entityFunctor, IntersectionFunctor& intersectionFunctor) const
+  {
+    const unsigned int num_threads = ThreadManager::max_threads();
+    std::vector< typename std::remove_const< EntityFunctor >::type > entityFunctors(num_threads - 1, entityFunctor);
+    std::vector< typename std::remove_const< IntersectionFunctor >::type >
+        intersectionFunctors(num_threads - 1, intersectionFunctor);
+    for (const auto& seeds : partitions)
+      ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+        const size_t first = (chunk*seeds.size())/num_chunks;
+        const size_t last = ((chunk + 1)*seeds.size())/num_chunks;
+        if (chunk == 0)
+          walkSeeds(seeds, first, last, entityFunctor, intersectionFunctor);
+        else
+          walkSeeds(seeds, first, last, entityFunctors[chunk - 1], intersectionFunctors[chunk - 1]);
+      });
+    for (const auto& functor : entityFunctors)
+      internal::reduceFunctor(entityFunctor, functor, 0);
+    for (const auto& functor : intersectionFunctors)
+      internal::reduceFunctor(intersectionFunctor, functor, 0);
+  } // ... walkPartitions(...)
+
+  template < class EntityFunctor >
+  void walkPartitions(const PartitionsType& partitions, EntityFunctor& entityFunctor) const
+  {
+    const unsigned int num_threads = ThreadManager::max_threads();
+    std::vector< typename std::remove_const< EntityFunctor >::type > entityFunctors(num_threads - 1, entityFunctor);
+    for (const auto& seeds : partitions)
+      ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+        const size_t first = (chunk*seeds.size())/num_chunks;
+        const size_t last = ((chunk + 1)*seeds.size())/num_chunks;
+        if (chunk == 0)
+          walkSeeds(seeds, first, last, entityFunctor);
+        else
+          walkSeeds(seeds, first, last, entityFunctors[chunk - 1]);
+      });
+    for (const auto& functor : entityFunctors)
+      internal::reduceFunctor(entityFunctor, functor, 0);
+  } // ... walkPartitions(...)
+
   const GridViewType& gridView_;
+  mutable PartitionsType seeds_;
+  mutable PartitionsType colors_;
+  mutable size_t cachedSize_;
 };
 
 template< class V, int i >
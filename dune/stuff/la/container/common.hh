@@ -19,6 +19,8 @@
 #include <dune/common/typetraits.hh>
 
 #include "interfaces.hh"
+#include "expressions.hh"
+#include "kernels.hh"
 #include "pattern.hh"
 
 namespace Dune {
@@ -61,6 +63,7 @@ public:
   typedef CommonDenseVectorTraits< ScalarImp >  Traits;
   typedef typename Traits::ScalarType           ScalarType;
   typedef typename Traits::BackendType          BackendType;
+  typedef typename VectorInterfaceType::VectorReferencesType VectorReferencesType;
 
   CommonDenseVector(const size_t ss = 0, const ScalarType value = ScalarType(0))
     : backend_(new BackendType(ss, value))
@@ -109,6 +112,34 @@ public:
     return *this;
   } // ... operator=(...)
 
+  /**
+   *  \brief Evaluates the expression into this.
+   *  \see   assign()
+   */
+  template< class E >
+  ThisType& operator=(const Expressions::VectorExpression< E >& expression)
+  {
+    return assign(expression);
+  }
+
+  /**
+   *  \brief Evaluates the expression into this in a single loop, without any temporaries.
+   *  \see   Expressions
+   */
+  template< class E >
+  ThisType& assign(const Expressions::VectorExpression< E >& expression)
+  {
+    const E& expr = expression.as_imp();
+    if (expr.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the expression (" << expr.size() << ") does not match the size of this ("
+                            << size() << ")!");
+    ScalarType* this_entries = entries();
+    for (size_t ii = 0; ii < expr.size(); ++ii)
+      this_entries[ii] = expr[ii];
+    return *this;
+  } // ... assign(...)
+
   /**
    * \defgroup backend ´´These methods are required by the ProvidesBackend interface.``
    * \{
@@ -182,6 +213,18 @@ public:
     backend_->operator[](ii) += value;
   } // ... add_to_entry(...)
 
+  template< class IndicesType, class LocalVectorType >
+  void add_to_entries(const IndicesType& indices, const LocalVectorType& local_vector)
+  {
+    assert(local_vector.size() == indices.size());
+    ensure_uniqueness();
+    BackendType& vector = *backend_;
+    for (size_t ii = 0; ii < indices.size(); ++ii) {
+      assert(size_t(indices[ii]) < size());
+      vector[indices[ii]] += local_vector[ii];
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const ScalarType& value)
   {
     assert(ii < size());
@@ -216,28 +259,63 @@ public:
    * \{
    */
 
+  virtual std::pair< size_t, ScalarType > amax() const DS_OVERRIDE DS_FINAL
+  {
+    return Kernels::amax(entries(), size());
+  }
+
+  virtual bool almost_equal(const ThisType& other,
+                            const ScalarType epsilon = Dune::FloatCmp::DefaultEpsilon< ScalarType >::value()) const
+    DS_OVERRIDE DS_FINAL
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    return Kernels::almost_equal(entries(), other.entries(), size(), epsilon);
+  } // ... almost_equal(...)
+
   virtual ScalarType dot(const ThisType& other) const DS_OVERRIDE DS_FINAL
   {
     if (other.size() != size())
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    return backend_->operator*(*(other.backend_));
+    return Kernels::dot(entries(), other.entries(), size());
   } // ... dot(...)
 
   virtual ScalarType l1_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->one_norm();
+    return Kernels::l1_norm(entries(), size());
   }
 
   virtual ScalarType l2_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->two_norm();
+    return std::sqrt(Kernels::dot(entries(), entries(), size()));
   }
 
   virtual ScalarType sup_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->infinity_norm();
+    return amax().second;
+  }
+
+  virtual ScalarType compensated_dot(const ThisType& other) const DS_OVERRIDE DS_FINAL
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    return Kernels::compensated_dot(entries(), other.entries(), size());
+  } // ... compensated_dot(...)
+
+  virtual ScalarType compensated_l1_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return Kernels::compensated_l1_norm(entries(), size());
+  }
+
+  virtual ScalarType compensated_l2_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return std::sqrt(Kernels::compensated_dot(entries(), entries(), size()));
   }
 
   virtual void add(const ThisType& other, ThisType& result) const DS_OVERRIDE DS_FINAL
@@ -250,9 +328,9 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of result (" << result.size() << ") does not match the size of this (" << size()
                             << ")!");
-    BackendType& result_ref = result.backend();
-    for (size_t ii = 0; ii < size(); ++ii)
-      result_ref[ii] = backend_->operator[](ii) + other.backend_->operator[](ii);
+    // result may share its backend with this or other, so it has to be made unique first
+    ScalarType* result_entries = result.entries();
+    Kernels::add(entries(), other.entries(), result_entries, size());
   } // ... add(...)
 
   virtual void iadd(const ThisType& other) DS_OVERRIDE DS_FINAL
@@ -261,7 +339,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    backend() += *(other.backend_);
+    ScalarType* this_entries = entries();
+    Kernels::add(this_entries, other.entries(), this_entries, size());
   } // ... iadd(...)
 
   virtual void sub(const ThisType& other, ThisType& result) const DS_OVERRIDE DS_FINAL
@@ -274,9 +353,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of result (" << result.size() << ") does not match the size of this (" << size()
                             << ")!");
-    BackendType& result_ref = result.backend();
-    for (size_t ii = 0; ii < size(); ++ii)
-      result_ref[ii] = backend_->operator[](ii) - other.backend_->operator[](ii);
+    ScalarType* result_entries = result.entries();
+    Kernels::sub(entries(), other.entries(), result_entries, size());
   } // ... sub(...)
 
   virtual void isub(const ThisType& other) DS_OVERRIDE DS_FINAL
@@ -285,9 +363,53 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    backend() -= *(other.backend_);
+    ScalarType* this_entries = entries();
+    Kernels::sub(this_entries, other.entries(), this_entries, size());
   } // ... isub(...)
 
+  virtual void axpby(const ScalarType& alpha, const ThisType& xx, const ScalarType& beta) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = entries();
+    Kernels::axpby(alpha, xx.entries(), beta, this_entries, size());
+  } // ... axpby(...)
+
+  virtual ScalarType axpy_and_norm(const ScalarType& alpha, const ThisType& xx) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = entries();
+    return Kernels::axpy_and_norm(alpha, xx.entries(), this_entries, size());
+  } // ... axpy_and_norm(...)
+
+  virtual void linear_combination(const std::vector< ScalarType >& coefficients,
+                                  const VectorReferencesType& vectors) DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(coefficients, vectors);
+    ScalarType* this_entries = entries();
+    const auto vectors_entries = VectorInterfaceType::entries_of(vectors);
+    Kernels::linear_combination(coefficients.data(), vectors_entries.data(), vectors.size(), this_entries, size());
+  } // ... linear_combination(...)
+
+  virtual std::vector< ScalarType > dot_many(const VectorReferencesType& others) const DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(others);
+    std::vector< ScalarType > result(others.size());
+    Kernels::dot_many(entries(), VectorInterfaceType::entries_of(others).data(), others.size(), result.data(), size());
+    return result;
+  } // ... dot_many(...)
+
+  //! \see VectorInterface::gram_matrix()
+  static std::vector< std::vector< ScalarType > > gram_matrix(const VectorReferencesType& vectors)
+  {
+    return VectorInterfaceType::contiguous_gram_matrix(vectors);
+  }
+
   /**
    * \}
    */
@@ -309,6 +431,18 @@ private:
       backend_ = std::make_shared< BackendType >(*backend_);
   } // ... ensure_uniqueness(...)
 
+  //! \return the contiguous storage of the backend for the Kernels, nullptr if empty
+  inline const ScalarType* entries() const
+  {
+    return size() > 0 ? &(backend_->operator[](0)) : nullptr;
+  }
+
+  inline ScalarType* entries()
+  {
+    ensure_uniqueness();
+    return size() > 0 ? &(backend_->operator[](0)) : nullptr;
+  }
+
   friend class VectorInterface< CommonDenseVectorTraits< ScalarType > >;
   friend class CommonDenseMatrix< ScalarType >;
 
@@ -369,6 +503,13 @@ public:
                                ScalarType(0)))
   {}
 
+  /// This constructors ignores the given pattern and initializes the matrix with 0.
+  CommonDenseMatrix(const size_t rr, const size_t cc, const SparsityPatternCompressed& /*pattern*/)
+    : backend_(new BackendType(MatrixInterfaceType::assert_is_size_t_compatible_and_convert(rr),
+                               MatrixInterfaceType::assert_is_size_t_compatible_and_convert(cc),
+                               ScalarType(0)))
+  {}
+
   CommonDenseMatrix(const ThisType& other)
     : backend_(other.backend_)
   {}
@@ -470,17 +611,23 @@ public:
     return backend_->cols();
   }
 
-  inline void mv(const VectorInterface< CommonDenseVectorTraits< ScalarType > >& xx,
-                 VectorInterface< CommonDenseVectorTraits< ScalarType > >& yy) const
-  {
-    mv(static_cast< const typename CommonDenseVectorTraits< ScalarType >::derived_type& >(xx),
-       static_cast< typename CommonDenseVectorTraits< ScalarType >::derived_type& >(yy));
-  }
-
   inline void mv(const CommonDenseVector< ScalarType >& xx, CommonDenseVector< ScalarType >& yy) const
   {
+    if (xx.size() != cols() || yy.size() != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
     backend_->mv(*(xx.backend_), yy.backend());
-  }
+  } // ... mv(...)
+
+  inline void mtv(const CommonDenseVector< ScalarType >& xx, CommonDenseVector< ScalarType >& yy) const
+  {
+    if (xx.size() != rows() || yy.size() != cols())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    backend_->mtv(*(xx.backend_), yy.backend());
+  } // ... mtv(...)
 
   void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
@@ -489,6 +636,24 @@ public:
     backend()[ii][jj] += value;
   } // ... add_to_entry(...)
 
+  template< class RowIndicesType, class ColIndicesType, class LocalMatrixType >
+  void add_to_entries(const RowIndicesType& row_indices,
+                      const ColIndicesType& col_indices,
+                      const LocalMatrixType& local_matrix)
+  {
+    assert(local_matrix.size() == row_indices.size());
+    BackendType& matrix = backend();
+    for (size_t ii = 0; ii < row_indices.size(); ++ii) {
+      assert(size_t(row_indices[ii]) < rows());
+      assert(local_matrix[ii].size() == col_indices.size());
+      auto& row = matrix[row_indices[ii]];
+      for (size_t jj = 0; jj < col_indices.size(); ++jj) {
+        assert(size_t(col_indices[jj]) < cols());
+        row[col_indices[jj]] += local_matrix[ii][jj];
+      }
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     assert(ii < rows());
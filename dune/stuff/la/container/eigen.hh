@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #if HAVE_EIGEN
 # include <dune/stuff/common/disable_warnings.hh>
@@ -24,7 +25,10 @@
 #include <dune/stuff/common/crtp.hh>
 
 #include "interfaces.hh"
+#include "expressions.hh"
+#include "kernels.hh"
 #include "pattern.hh"
+#include "sparse_products.hh"
 
 namespace Dune {
 namespace Pymor {
@@ -82,6 +86,7 @@ public:
   typedef typename Traits::ScalarType   ScalarType;
   typedef typename Traits::BackendType  BackendType;
   typedef typename Traits::derived_type VectorImpType;
+  typedef typename VectorInterfaceType::VectorReferencesType VectorReferencesType;
 private:
 
   void ensure_uniqueness() const
@@ -96,6 +101,24 @@ public:
     return *this;
   } // ... operator=(...)
 
+  /**
+   *  \brief Evaluates the expression into this in a single loop, without any temporaries.
+   *  \see   Expressions
+   */
+  template< class E >
+  VectorImpType& assign(const Expressions::VectorExpression< E >& expression)
+  {
+    const E& expr = expression.as_imp();
+    if (expr.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the expression (" << expr.size() << ") does not match the size of this ("
+                            << size() << ")!");
+    ScalarType* this_entries = backend().data();
+    for (size_t ii = 0; ii < expr.size(); ++ii)
+      this_entries[ii] = expr[ii];
+    return VectorInterfaceType::as_imp(*this);
+  } // ... assign(...)
+
   /**
    * \defgroup backend ´´These methods are required by the ProvidesBackend interface.``
    * \{
@@ -162,6 +185,17 @@ public:
     backend()(ii) += value;
   } // ... add_to_entry(...)
 
+  template< class IndicesType, class LocalVectorType >
+  void add_to_entries(const IndicesType& indices, const LocalVectorType& local_vector)
+  {
+    assert(local_vector.size() == indices.size());
+    ScalarType* entries = backend().data();
+    for (size_t ii = 0; ii < indices.size(); ++ii) {
+      assert(size_t(indices[ii]) < size());
+      entries[indices[ii]] += local_vector[ii];
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const ScalarType& value)
   {
     assert(ii < size());
@@ -195,20 +229,8 @@ public:
    */
   virtual std::pair< size_t, ScalarType > amax() const DS_OVERRIDE DS_FINAL
   {
-    auto result = std::make_pair(size_t(0), ScalarType(0));
-    size_t min_index = 0;
-    size_t max_index = 0;
-    const ScalarType minimum = backend_->minCoeff(&min_index);
-    const ScalarType maximum = backend_->maxCoeff(&max_index);
-    if (std::abs(maximum) < std::abs(minimum) || (std::abs(maximum) == std::abs(minimum) && max_index > min_index)) {
-      result.first = min_index;
-      result.second = std::abs(minimum);
-    } else {
-      result.first = max_index;
-      result.second = std::abs(maximum);
-    }
-    return result;
-  } // ... amax(...)
+    return Kernels::amax(backend_->data(), size());
+  }
 
   template< class T >
   bool almost_equal(const EigenBaseVector< T, ScalarType >& other,
@@ -218,10 +240,7 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    for (size_t ii = 0; ii < size(); ++ii)
-      if (!Dune::FloatCmp::eq< ScalarType >(get_entry(ii), other.get_entry(ii), epsilon))
-        return false;
-      return true;
+    return Kernels::almost_equal(backend_->data(), other.backend_->data(), size(), epsilon);
   } // ... almost_equal(...)
 
   virtual bool almost_equal(const VectorImpType& other,
@@ -262,6 +281,31 @@ public:
     return backend_->template lpNorm< ::Eigen::Infinity >();
   }
 
+  template< class T >
+  ScalarType compensated_dot(const EigenBaseVector< T, ScalarType >& other) const
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    return Kernels::compensated_dot(backend_->data(), other.backend_->data(), size());
+  } // ... compensated_dot(...)
+
+  virtual ScalarType compensated_dot(const VectorImpType& other) const DS_OVERRIDE DS_FINAL
+  {
+    return this->template compensated_dot< Traits >(other);
+  }
+
+  virtual ScalarType compensated_l1_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return Kernels::compensated_l1_norm(backend_->data(), size());
+  }
+
+  virtual ScalarType compensated_l2_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return std::sqrt(Kernels::compensated_dot(backend_->data(), backend_->data(), size()));
+  }
+
   template< class T1, class T2 >
   void add(const EigenBaseVector< T1, ScalarType >& other, EigenBaseVector< T2, ScalarType >& result) const
   {
@@ -329,11 +373,60 @@ public:
   {
     this->template isub< Traits >(other);
   }
+
+  virtual void axpby(const ScalarType& alpha, const VectorImpType& xx, const ScalarType& beta) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = backend().data();
+    Kernels::axpby(alpha, xx.backend_->data(), beta, this_entries, size());
+  } // ... axpby(...)
+
+  virtual ScalarType axpy_and_norm(const ScalarType& alpha, const VectorImpType& xx) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = backend().data();
+    return Kernels::axpy_and_norm(alpha, xx.backend_->data(), this_entries, size());
+  } // ... axpy_and_norm(...)
+
+  virtual void linear_combination(const std::vector< ScalarType >& coefficients,
+                                  const VectorReferencesType& vectors) DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(coefficients, vectors);
+    ScalarType* this_entries = backend().data();
+    const auto vectors_entries = VectorInterfaceType::entries_of(vectors);
+    Kernels::linear_combination(coefficients.data(), vectors_entries.data(), vectors.size(), this_entries, size());
+  } // ... linear_combination(...)
+
+  virtual std::vector< ScalarType > dot_many(const VectorReferencesType& others) const DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(others);
+    std::vector< ScalarType > result(others.size());
+    Kernels::dot_many(entries(), VectorInterfaceType::entries_of(others).data(), others.size(), result.data(), size());
+    return result;
+  } // ... dot_many(...)
+
+  //! \see VectorInterface::gram_matrix()
+  static std::vector< std::vector< ScalarType > > gram_matrix(const VectorReferencesType& vectors)
+  {
+    return VectorInterfaceType::contiguous_gram_matrix(vectors);
+  }
   /**
    * \}
    */
 
 private:
+  //! for VectorInterface::entries_of()
+  inline const ScalarType* entries() const
+  {
+    return backend_->data();
+  }
+
   friend class VectorInterface< Traits >;
   friend class EigenDenseMatrix< ScalarType >;
   friend class EigenRowMajorSparseMatrix< ScalarType >;
@@ -435,6 +528,13 @@ public:
     return *this;
   } // ... operator=(...)
 
+  //! \see EigenBaseVector::assign()
+  template< class E >
+  ThisType& operator=(const Expressions::VectorExpression< E >& expression)
+  {
+    return this->assign(expression);
+  }
+
   using VectorInterfaceType::add;
   using VectorInterfaceType::sub;
   using BaseType::backend;
@@ -572,6 +672,13 @@ public:
     return *this;
   }
 
+  //! \see EigenBaseVector::assign()
+  template< class E >
+  ThisType& operator=(const Expressions::VectorExpression< E >& expression)
+  {
+    return this->assign(expression);
+  }
+
   using VectorInterfaceType::add;
   using VectorInterfaceType::sub;
   using BaseType::backend;
@@ -667,6 +774,14 @@ public:
     backend_->setZero();
   }
 
+  /// This constructors ignores the given pattern and initializes the matrix with 0.
+  EigenDenseMatrix(const size_t rr, const size_t cc, const SparsityPatternCompressed& /*pattern*/)
+    : backend_(new BackendType(MatrixInterfaceType::assert_is_size_t_compatible_and_convert(rr),
+                               MatrixInterfaceType::assert_is_size_t_compatible_and_convert(cc)))
+  {
+    backend_->setZero();
+  }
+
   EigenDenseMatrix(const ThisType& other)
     : backend_(other.backend_)
   {}
@@ -717,6 +832,17 @@ public:
     ensure_uniqueness();
     return *backend_;
   } // ... backend(...)
+
+  /**
+   *  \brief Identifies the current backend, e.g. to cache something computed from it (see LA::SolverCache).
+   *  \note  In contrast to the address of the backend, the handle can not be mistaken for a backend allocated later on
+   *         at the same address: it expires once the backend is freed.
+   */
+  std::weak_ptr< const BackendType > backend_handle() const
+  {
+    ensure_uniqueness();
+    return backend_;
+  }
   /**
    * \}
    */
@@ -786,8 +912,22 @@ public:
   template< class T1, class T2 >
   inline void mv(const EigenBaseVector< T1, ScalarType >& xx, EigenBaseVector< T2, ScalarType >& yy) const
   {
+    if (xx.size() != cols() || yy.size() != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
     yy.backend().transpose() = backend_->operator*(*xx.backend_);
-  }
+  } // ... mv(...)
+
+  template< class T1, class T2 >
+  inline void mtv(const EigenBaseVector< T1, ScalarType >& xx, EigenBaseVector< T2, ScalarType >& yy) const
+  {
+    if (xx.size() != rows() || yy.size() != cols())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    yy.backend() = backend_->transpose()*(*xx.backend_);
+  } // ... mtv(...)
 
   void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
@@ -796,6 +936,23 @@ public:
     backend()(ii, jj) += value;
   } // ... add_to_entry(...)
 
+  template< class RowIndicesType, class ColIndicesType, class LocalMatrixType >
+  void add_to_entries(const RowIndicesType& row_indices,
+                      const ColIndicesType& col_indices,
+                      const LocalMatrixType& local_matrix)
+  {
+    assert(local_matrix.size() == row_indices.size());
+    BackendType& matrix = backend();
+    for (size_t ii = 0; ii < row_indices.size(); ++ii) {
+      assert(size_t(row_indices[ii]) < rows());
+      assert(local_matrix[ii].size() == col_indices.size());
+      for (size_t jj = 0; jj < col_indices.size(); ++jj) {
+        assert(size_t(col_indices[jj]) < cols());
+        matrix(row_indices[ii], col_indices[jj]) += local_matrix[ii][jj];
+      }
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     assert(ii < rows());
@@ -908,21 +1065,17 @@ public:
   EigenRowMajorSparseMatrix(const size_t rr, const size_t cc, const SparsityPatternDefault& pattern)
     : backend_(new BackendType(rr, cc))
   {
-    if (size_t(pattern.size()) != rr)
-      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
-                            "The size of the pattern (" << pattern.size()
-                            << ") does not match the number of rows of this (" << rows() << ")!");
-    for (size_t row = 0; row < size_t(pattern.size()); ++row) {
-      backend_->startVec(row);
-      const auto& columns = pattern.inner(row);
-      for (auto& column : columns)
-        backend_->insertBackByOuterInner(row, column);
-      // create diagonal entry (insertBackByOuterInner() can not handle empty rows)
-      if (columns.size() == 0)
-        backend_->insertBackByOuterInner(row, row);
-    }
-    backend_->finalize();
-    backend_->makeCompressed();
+    build_sparse_layout(pattern);
+  }
+
+  /**
+   * \brief Creates a sparse matrix from a compressed pattern, allocating exactly the required number of nonzeros.
+   */
+  EigenRowMajorSparseMatrix(const size_t rr, const size_t cc, const SparsityPatternCompressed& pattern)
+    : backend_(new BackendType(rr, cc))
+  {
+    backend_->reserve(pattern.num_nonzeros());
+    build_sparse_layout(pattern);
   }
 
   EigenRowMajorSparseMatrix(const size_t rr = 0, const size_t cc = 0)
@@ -990,6 +1143,17 @@ public:
     ensure_uniqueness();
     return *backend_;
   } // ... backend(...)
+
+  /**
+   *  \brief Identifies the current backend, e.g. to cache something computed from it (see LA::SolverCache).
+   *  \note  In contrast to the address of the backend, the handle can not be mistaken for a backend allocated later on
+   *         at the same address: it expires once the backend is freed.
+   */
+  std::weak_ptr< const BackendType > backend_handle() const
+  {
+    ensure_uniqueness();
+    return backend_;
+  }
   /**
    * \}
    */
@@ -1042,11 +1206,53 @@ public:
     return backend_->cols();
   }
 
+  /**
+   * \brief yy = A*xx, threaded (see SparseProducts).
+   */
   template< class T1, class T2 >
   inline void mv(const EigenBaseVector< T1, ScalarType >& xx, EigenBaseVector< T2, ScalarType >& yy) const
   {
-    yy.backend().transpose() = backend_->operator*(*xx.backend_);
-  }
+    if (xx.size() != cols() || yy.size() != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    ScalarType* result = yy.backend().data();
+    std::vector< ScalarType > tmp;
+    const ScalarType* source = unaliased(xx.backend_->data(), result, cols(), tmp);
+    const BackendType& matrix = *backend_;
+    SparseProducts::for_each_range(row_partition(), [&](const size_t first, const size_t last) {
+      for (size_t ii = first; ii < last; ++ii) {
+        ScalarType sum(0);
+        for (typename BackendType::InnerIterator entry(matrix, ii); entry; ++entry)
+          sum += entry.value()*source[entry.index()];
+        result[ii] = sum;
+      }
+    });
+  } // ... mv(...)
+
+  /**
+   * \brief yy = A^T*xx, threaded (see SparseProducts).
+   */
+  template< class T1, class T2 >
+  inline void mtv(const EigenBaseVector< T1, ScalarType >& xx, EigenBaseVector< T2, ScalarType >& yy) const
+  {
+    if (xx.size() != rows() || yy.size() != cols())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    ScalarType* result = yy.backend().data();
+    std::vector< ScalarType > tmp;
+    const ScalarType* source = unaliased(xx.backend_->data(), result, rows(), tmp);
+    const BackendType& matrix = *backend_;
+    SparseProducts::accumulate_ranges(row_partition(), result, cols(),
+                                      [&](const size_t first, const size_t last, ScalarType* target) {
+      for (size_t ii = first; ii < last; ++ii) {
+        const ScalarType source_entry = source[ii];
+        for (typename BackendType::InnerIterator entry(matrix, ii); entry; ++entry)
+          target[entry.index()] += entry.value()*source_entry;
+      }
+    });
+  } // ... mtv(...)
 
   void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
@@ -1054,6 +1260,37 @@ public:
     backend().coeffRef(ii, jj) += value;
   } // ... add_to_entry(...)
 
+  template< class RowIndicesType, class ColIndicesType, class LocalMatrixType >
+  void add_to_entries(const RowIndicesType& row_indices,
+                      const ColIndicesType& col_indices,
+                      const LocalMatrixType& local_matrix)
+  {
+    assert(local_matrix.size() == row_indices.size());
+    const Kernels::SortedOrder<> order(col_indices);
+    BackendType& matrix = backend();
+    for (size_t ii = 0; ii < row_indices.size(); ++ii) {
+      const size_t row = row_indices[ii];
+      assert(row < rows());
+      assert(local_matrix[ii].size() == col_indices.size());
+      const size_t row_begin = matrix.outerIndexPtr()[row];
+      const size_t row_size = matrix.isCompressed() ? matrix.outerIndexPtr()[row + 1] - row_begin
+                                                    : matrix.innerNonZeroPtr()[row];
+      const auto* row_cols = matrix.innerIndexPtr() + row_begin;
+      ScalarType* row_values = matrix.valuePtr() + row_begin;
+      // the columns are visited in ascending order, so the position in the row only moves forward
+      size_t position = 0;
+      for (const size_t jj : order) {
+        const size_t col = col_indices[jj];
+        while (position < row_size && size_t(row_cols[position]) < col)
+          ++position;
+        if (position == row_size || size_t(row_cols[position]) != col)
+          DUNE_THROW_COLORFULLY(Exceptions::index_out_of_range,
+                                "Entry (" << row << ", " << col << ") is not contained in the sparsity pattern!");
+        row_values[position] += local_matrix[ii][jj];
+      }
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     assert(these_are_valid_indices(ii, jj));
@@ -1130,6 +1367,46 @@ public:
    */
 
 private:
+  SparseProducts::RowPartition row_partition() const
+  {
+    if (backend_->isCompressed())
+      return SparseProducts::RowPartition(rows(), backend_->outerIndexPtr());
+    const auto* row_sizes = backend_->innerNonZeroPtr();
+    return SparseProducts::RowPartition::from_row_sizes(rows(), [&](const size_t ii) {
+      return size_t(row_sizes[ii]);
+    });
+  } // ... row_partition(...)
+
+  //! \return source, or a copy of it in tmp if it coincides with result
+  static const ScalarType* unaliased(const ScalarType* source, const ScalarType* result, const size_t size,
+                                     std::vector< ScalarType >& tmp)
+  {
+    if (source != result)
+      return source;
+    tmp.assign(source, source + size);
+    return tmp.data();
+  } // ... unaliased(...)
+
+  template< class PatternType >
+  void build_sparse_layout(const PatternType& pattern)
+  {
+    if (size_t(pattern.size()) != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the pattern (" << pattern.size()
+                            << ") does not match the number of rows of this (" << rows() << ")!");
+    for (size_t row = 0; row < size_t(pattern.size()); ++row) {
+      backend_->startVec(row);
+      const auto& columns = pattern.inner(row);
+      for (auto& column : columns)
+        backend_->insertBackByOuterInner(row, column);
+      // create diagonal entry (insertBackByOuterInner() can not handle empty rows)
+      if (columns.size() == 0)
+        backend_->insertBackByOuterInner(row, row);
+    }
+    backend_->finalize();
+    backend_->makeCompressed();
+  } // ... build_sparse_layout(...)
+
   bool these_are_valid_indices(const size_t ii, const size_t jj) const
   {
     if (ii >= rows())
@@ -0,0 +1,263 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_LA_CONTAINER_EXPRESSIONS_HH
+#define DUNE_STUFF_LA_CONTAINER_EXPRESSIONS_HH
+
+#include <type_traits>
+#include <utility>
+
+#include <dune/stuff/common/exceptions.hh>
+
+#include "interfaces.hh"
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+
+/**
+ *  \brief Lazy arithmetic for vectors.
+ *
+ *  The operators +, - and scalar * on vectors (and on expressions of vectors) do not compute anything, they return an
+ *  expression which holds references to the vectors involved. The expression is evaluated entry by entry in a single
+ *  loop once it is assigned to a vector, so
+\code
+u = a + b - 2.0*c;
+\endcode
+ *  neither allocates temporaries nor passes over memory more than once. Converting an expression to a vector, as in
+ *  VectorType u = a + b, allocates that vector only. Since expressions hold references, they must not outlive the
+ *  vectors they refer to, i.e. do not store them (as in auto e = a + b) but assign them right away.
+ *
+ *  \note These operators replace the virtual members operator+, operator- and operator*(alpha) of VectorInterface,
+ *        which returned a copy. Those are still there for code which knows a vector as a VectorInterface alone, where
+ *        they are the better match and remain eager. Any other use (e.g. auto u = a + b) now yields an expression.
+ */
+namespace Expressions {
+
+
+template< class ExpressionImp >
+class VectorExpression
+{
+public:
+  typedef ExpressionImp derived_type;
+
+  const derived_type& as_imp() const
+  {
+    return static_cast< const derived_type& >(*this);
+  }
+}; // class VectorExpression
+
+
+//! The leaf of an expression, refers to a vector (which may be given as a VectorInterface).
+template< class VectorImp >
+class Terminal
+  : public VectorExpression< Terminal< VectorImp > >
+{
+  template< class Traits >
+  static typename Traits::derived_type derived(const VectorInterface< Traits >&);
+
+public:
+  typedef decltype(derived(std::declval< const VectorImp& >())) VectorType;
+  typedef typename VectorImp::ScalarType                         ScalarType;
+
+  explicit Terminal(const VectorImp& vector)
+    : vector_(vector)
+  {}
+
+  size_t size() const
+  {
+    return vector_.size();
+  }
+
+  ScalarType operator[](const size_t ii) const
+  {
+    return vector_.get_entry(ii);
+  }
+
+private:
+  const VectorImp& vector_;
+}; // class Terminal
+
+
+struct Plus
+{
+  template< class S >
+  static S apply(const S& lhs, const S& rhs)
+  {
+    return lhs + rhs;
+  }
+};
+
+
+struct Minus
+{
+  template< class S >
+  static S apply(const S& lhs, const S& rhs)
+  {
+    return lhs - rhs;
+  }
+};
+
+
+template< class LeftImp, class RightImp, class OperationImp >
+class Binary
+  : public VectorExpression< Binary< LeftImp, RightImp, OperationImp > >
+{
+public:
+  typedef typename LeftImp::VectorType VectorType;
+  typedef typename LeftImp::ScalarType ScalarType;
+  static_assert(std::is_same< ScalarType, typename RightImp::ScalarType >::value,
+                "Only expressions of the same ScalarType can be combined!");
+
+  Binary(const LeftImp& lhs, const RightImp& rhs)
+    : lhs_(lhs)
+    , rhs_(rhs)
+  {
+    if (rhs_.size() != lhs_.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the right operand (" << rhs_.size()
+                            << ") does not match the size of the left operand (" << lhs_.size() << ")!");
+  }
+
+  size_t size() const
+  {
+    return lhs_.size();
+  }
+
+  ScalarType operator[](const size_t ii) const
+  {
+    return OperationImp::apply(lhs_[ii], rhs_[ii]);
+  }
+
+  operator VectorType() const
+  {
+    VectorType result(size());
+    result.assign(*this);
+    return result;
+  }
+
+private:
+  const LeftImp lhs_;
+  const RightImp rhs_;
+}; // class Binary
+
+
+template< class ExpressionImp >
+class Scaled
+  : public VectorExpression< Scaled< ExpressionImp > >
+{
+public:
+  typedef typename ExpressionImp::VectorType VectorType;
+  typedef typename ExpressionImp::ScalarType ScalarType;
+
+  Scaled(const ScalarType& alpha, const ExpressionImp& expression)
+    : alpha_(alpha)
+    , expression_(expression)
+  {}
+
+  size_t size() const
+  {
+    return expression_.size();
+  }
+
+  ScalarType operator[](const size_t ii) const
+  {
+    return alpha_*expression_[ii];
+  }
+
+  operator VectorType() const
+  {
+    VectorType result(size());
+    result.assign(*this);
+    return result;
+  }
+
+private:
+  const ScalarType alpha_;
+  const ExpressionImp expression_;
+}; // class Scaled
+
+
+/**
+ *  Maps the operands of the operators below to expressions: vectors are wrapped into a Terminal, expressions are taken
+ *  as they are. Anything else is no operand, so the operators do not apply.
+ */
+template< class T, bool is_vector = std::is_base_of< Tags::VectorInterface, T >::value,
+          bool is_expression = std::is_base_of< VectorExpression< T >, T >::value >
+struct Operand
+{
+  static const bool value = false;
+};
+
+template< class T >
+struct Operand< T, true, false >
+{
+  static const bool value = true;
+  typedef Terminal< T > type;
+
+  static type make(const T& vector)
+  {
+    return type(vector);
+  }
+};
+
+template< class T >
+struct Operand< T, false, true >
+{
+  static const bool value = true;
+  typedef T type;
+
+  static const type& make(const T& expression)
+  {
+    return expression;
+  }
+};
+
+
+} // namespace Expressions
+
+
+template< class L, class R >
+typename std::enable_if< Expressions::Operand< L >::value && Expressions::Operand< R >::value,
+                         Expressions::Binary< typename Expressions::Operand< L >::type,
+                                              typename Expressions::Operand< R >::type,
+                                              Expressions::Plus > >::type
+operator+(const L& lhs, const R& rhs)
+{
+  return {Expressions::Operand< L >::make(lhs), Expressions::Operand< R >::make(rhs)};
+}
+
+template< class L, class R >
+typename std::enable_if< Expressions::Operand< L >::value && Expressions::Operand< R >::value,
+                         Expressions::Binary< typename Expressions::Operand< L >::type,
+                                              typename Expressions::Operand< R >::type,
+                                              Expressions::Minus > >::type
+operator-(const L& lhs, const R& rhs)
+{
+  return {Expressions::Operand< L >::make(lhs), Expressions::Operand< R >::make(rhs)};
+}
+
+template< class E >
+typename std::enable_if< Expressions::Operand< E >::value,
+                         Expressions::Scaled< typename Expressions::Operand< E >::type > >::type
+operator*(const typename Expressions::Operand< E >::type::ScalarType& alpha, const E& expression)
+{
+  return {alpha, Expressions::Operand< E >::make(expression)};
+}
+
+template< class E >
+typename std::enable_if< Expressions::Operand< E >::value,
+                         Expressions::Scaled< typename Expressions::Operand< E >::type > >::type
+operator*(const E& expression, const typename Expressions::Operand< E >::type::ScalarType& alpha)
+{
+  return {alpha, Expressions::Operand< E >::make(expression)};
+}
+
+
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_LA_CONTAINER_EXPRESSIONS_HH
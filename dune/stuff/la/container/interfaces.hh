@@ -12,8 +12,11 @@
 # define DUNE_STUFF_SSIZE_T long int
 #endif
 
+#include <cmath>
+#include <functional>
 #include <limits>
 #include <iostream>
+#include <vector>
 
 #include <dune/common/float_cmp.hh>
 
@@ -21,9 +24,20 @@
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/exceptions.hh>
 
+#include "kernels.hh"
+
 namespace Dune {
 namespace Stuff {
 namespace LA {
+namespace Expressions {
+
+
+// forward, see expressions.hh
+template< class ExpressionImp >
+class VectorExpression;
+
+
+} // namespace Expressions
 
 
 enum class ChooseBackend {
@@ -219,6 +233,8 @@ class VectorInterface
 public:
   typedef typename Traits::derived_type derived_type;
   typedef typename Traits::ScalarType   ScalarType;
+  //! used to pass several vectors to the fused operations, e.g. {std::cref(v), std::cref(w)}
+  typedef std::vector< std::reference_wrapper< const derived_type > > VectorReferencesType;
 
   virtual ~VectorInterface() {}
 
@@ -245,6 +261,18 @@ public:
     CHECK_AND_CALL_CRTP(this->as_imp(*this).add_to_entry(ii, value));
   }
 
+  /**
+   * \brief Adds local_vector[ii] to the indices[ii]th entry, for all ii in [0, indices.size()).
+   *
+   *        Meant for assembly: the copy-on-write check is done once for all entries. Indices may repeat. IndicesType
+   *        and LocalVectorType have to provide size() and operator[], e.g. std::vector or Dune::DynamicVector.
+   */
+  template< class IndicesType, class LocalVectorType >
+  inline void add_to_entries(const IndicesType& indices, const LocalVectorType& local_vector)
+  {
+    CHECK_AND_CALL_CRTP(this->as_imp(*this).add_to_entries(indices, local_vector));
+  }
+
   /**
    * \brief Set the iith entry to given scalar.
    */
@@ -397,6 +425,48 @@ public:
     return amax().second;
   }
 
+  /**
+   *  \brief  Variant of dot() using compensated summation, i.e. with an error independent of the size of the vectors.
+   *  \param  other The second factor.
+   *  \return The scalar product.
+   *  \see    Kernels
+   *  \note   If you override this method please use exceptions instead of assertions (for the python bindings).
+   */
+  virtual ScalarType compensated_dot(const derived_type& other) const
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType sum = 0;
+    ScalarType compensation = 0;
+    for (size_t ii = 0; ii < size(); ++ii)
+      Kernels::internal::compensated_add(sum, compensation, ScalarType(get_entry(ii) * other.get_entry(ii)));
+    return sum + compensation;
+  } // ... compensated_dot(...)
+
+  /**
+   *  \brief  Variant of l1_norm() using compensated summation.
+   *  \see    compensated_dot()
+   */
+  virtual ScalarType compensated_l1_norm() const
+  {
+    ScalarType sum = 0;
+    ScalarType compensation = 0;
+    for (size_t ii = 0; ii < size(); ++ii)
+      Kernels::internal::compensated_add(sum, compensation, ScalarType(std::abs(get_entry(ii))));
+    return sum + compensation;
+  } // ... compensated_l1_norm(...)
+
+  /**
+   *  \brief  Variant of l2_norm() using compensated summation.
+   *  \see    compensated_dot()
+   */
+  virtual ScalarType compensated_l2_norm() const
+  {
+    return std::sqrt(compensated_dot(this->as_imp(*this)));
+  }
+
   /**
    *  \brief  Adds two vectors.
    *  \param  other   The right summand.
@@ -495,10 +565,116 @@ public:
       set_entry(ii, get_entry(ii) - other.get_entry(ii));
   } // ... isub(...)
 
+  /**
+   *  \brief  BLAS AXPBY operation, i.e. this = alpha*xx + beta*this in one pass.
+   *  \note   If you override this method please use exceptions instead of assertions (for the python bindings).
+   */
+  virtual void axpby(const ScalarType& alpha, const derived_type& xx, const ScalarType& beta)
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    for (size_t ii = 0; ii < size(); ++ii)
+      set_entry(ii, alpha*xx.get_entry(ii) + beta*get_entry(ii));
+  } // ... axpby(...)
+
+  /**
+   *  \brief  Fused variant of axpy() and l2_norm(), as needed for residual updates.
+   *  \return The l2-norm of this after the update.
+   *  \note   If you override this method please use exceptions instead of assertions (for the python bindings).
+   */
+  virtual ScalarType axpy_and_norm(const ScalarType& alpha, const derived_type& xx)
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType result = 0;
+    for (size_t ii = 0; ii < size(); ++ii) {
+      const ScalarType value = get_entry(ii) + alpha*xx.get_entry(ii);
+      set_entry(ii, value);
+      result += value*value;
+    }
+    return std::sqrt(result);
+  } // ... axpy_and_norm(...)
+
+  /**
+   *  \brief  Sets this to sum_ii coefficients[ii]*vectors[ii], reading each vector once.
+   *  \note   this may be one of vectors.
+   *  \note   If you override this method please use exceptions instead of assertions (for the python bindings).
+   */
+  virtual void linear_combination(const std::vector< ScalarType >& coefficients, const VectorReferencesType& vectors)
+  {
+    check_sizes(coefficients, vectors);
+    for (size_t ii = 0; ii < size(); ++ii) {
+      ScalarType value = 0;
+      for (size_t jj = 0; jj < vectors.size(); ++jj)
+        value += coefficients[jj]*vectors[jj].get().get_entry(ii);
+      set_entry(ii, value);
+    }
+  } // ... linear_combination(...)
+
+  /**
+   *  \brief  Computes the scalar products of this with several vectors, reading this only once.
+   *  \return The vector of the scalar products with each of others.
+   *  \note   If you override this method please use exceptions instead of assertions (for the python bindings).
+   */
+  virtual std::vector< ScalarType > dot_many(const VectorReferencesType& others) const
+  {
+    check_sizes(others);
+    std::vector< ScalarType > result(others.size(), ScalarType(0));
+    for (size_t ii = 0; ii < size(); ++ii) {
+      const ScalarType value = get_entry(ii);
+      for (size_t jj = 0; jj < others.size(); ++jj)
+        result[jj] += value*others[jj].get().get_entry(ii);
+    }
+    return result;
+  } // ... dot_many(...)
+
+  /**
+   *  \brief  Computes the Gram matrix of the given vectors, i.e. result[ii][jj] = vectors[ii].dot(vectors[jj]).
+   *  \note   The dense vectors hide this by a variant reading each vector only once, so call it as
+   *          VectorType::gram_matrix(vectors).
+   */
+  static std::vector< std::vector< ScalarType > > gram_matrix(const VectorReferencesType& vectors)
+  {
+    std::vector< std::vector< ScalarType > > result(vectors.size(), std::vector< ScalarType >(vectors.size()));
+    for (size_t ii = 0; ii < vectors.size(); ++ii) {
+      const VectorReferencesType others(vectors.begin() + ii, vectors.end());
+      const auto products = vectors[ii].get().dot_many(others);
+      for (size_t jj = ii; jj < vectors.size(); ++jj)
+        result[ii][jj] = result[jj][ii] = products[jj - ii];
+    }
+    return result;
+  } // ... gram_matrix(...)
+
+  /**
+   *  \brief  Evaluates a lazy expression of vectors (as returned by +, - and scalar *) into this, in a single pass.
+   *  \note   The dense vectors hide this by a variant writing directly to their storage.
+   *  \see    Expressions
+   */
+  template< class E >
+  derived_type& assign(const Expressions::VectorExpression< E >& expression)
+  {
+    const E& expr = expression.as_imp();
+    if (expr.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the expression (" << expr.size() << ") does not match the size of this ("
+                            << size() << ")!");
+    for (size_t ii = 0; ii < size(); ++ii)
+      set_entry(ii, expr[ii]);
+    return this->as_imp(*this);
+  } // ... assign(...)
+
   /**
    *  \brief  Multiplies every component of this by a scalar.
    *  \param  alpha The scalar.
    *  \return The scaled copy of this.
+   *  \note   Since the lazy operators of expressions.hh, this eager variant (as well as operator+ and operator- below)
+   *          is only chosen where this is known as a VectorInterface alone, e.g. in code templated on the Traits. For
+   *          operands of the derived types the lazy operators are the better match, so overriding these in a derived
+   *          class has no effect there.
    */
   virtual derived_type operator*(const ScalarType& alpha)
   {
@@ -544,6 +720,7 @@ public:
    *  \brief  Adds two vectors.
    *  \param  other The second summand.
    *  \return The sum of the two vectors.
+   *  \see    operator*(const ScalarType&)
    */
   virtual derived_type operator+(const derived_type& other) const
   {
@@ -554,6 +731,7 @@ public:
    *  \brief  Substracts two vectors.
    *  \param  other The subtrahend
    *  \return The difference.
+   *  \see    operator*(const ScalarType&)
    */
   virtual derived_type operator-(const derived_type& other) const
   {
@@ -690,6 +868,55 @@ public:
    * \}
    */
 
+protected:
+  //! throws if any of vectors does not match the size of this
+  void check_sizes(const VectorReferencesType& vectors) const
+  {
+    for (const auto& vector : vectors)
+      if (vector.get().size() != size())
+        DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                              "The size of a given vector (" << vector.get().size()
+                              << ") does not match the size of this (" << size() << ")!");
+  } // ... check_sizes(...)
+
+  //! additionally throws if the number of coefficients does not match the number of vectors
+  void check_sizes(const std::vector< ScalarType >& coefficients, const VectorReferencesType& vectors) const
+  {
+    if (coefficients.size() != vectors.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The number of coefficients (" << coefficients.size()
+                            << ") does not match the number of vectors (" << vectors.size() << ")!");
+    check_sizes(vectors);
+  } // ... check_sizes(...)
+
+  /**
+   *  \return the contiguous storage of each of vectors, for the Kernels
+   *  \note   Only for vectors with contiguous storage, which have to provide entries() const (which may be private).
+   */
+  static std::vector< const ScalarType* > entries_of(const VectorReferencesType& vectors)
+  {
+    std::vector< const ScalarType* > result(vectors.size());
+    for (size_t ii = 0; ii < vectors.size(); ++ii)
+      result[ii] = vectors[ii].get().entries();
+    return result;
+  } // ... entries_of(...)
+
+  //! gram_matrix() reading each vector only once, for vectors with contiguous storage (see entries_of())
+  static std::vector< std::vector< ScalarType > > contiguous_gram_matrix(const VectorReferencesType& vectors)
+  {
+    const size_t num_vectors = vectors.size();
+    for (const auto& vector : vectors)
+      if (vector.get().size() != vectors[0].get().size())
+        DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match, "All vectors have to be of the same size!");
+    std::vector< ScalarType > products(num_vectors*num_vectors);
+    Kernels::gram_matrix(entries_of(vectors).data(), num_vectors, products.data(),
+                         num_vectors > 0 ? vectors[0].get().size() : 0);
+    std::vector< std::vector< ScalarType > > result(num_vectors);
+    for (size_t ii = 0; ii < num_vectors; ++ii)
+      result[ii].assign(products.begin() + ii*num_vectors, products.begin() + (ii + 1)*num_vectors);
+    return result;
+  } // ... contiguous_gram_matrix(...)
+
 private:
   template< class T >
   friend std::ostream& operator<<(std::ostream& /*out*/, const VectorInterface< T >& /*vector*/);
@@ -740,17 +967,44 @@ public:
     return this->as_imp(*this).cols();
   }
 
+  //! yy = A*xx, the sparse matrices compute this in parallel (see SparseProducts)
   template< class XX, class YY >
   inline void mv(const XX& xx, YY& yy) const
   {
     CHECK_AND_CALL_CRTP(this->as_imp(*this).mv(xx, yy));
   }
 
+  //! yy = A^T*xx
+  template< class XX, class YY >
+  inline void mtv(const XX& xx, YY& yy) const
+  {
+    CHECK_AND_CALL_CRTP(this->as_imp(*this).mtv(xx, yy));
+  }
+
   inline void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     CHECK_AND_CALL_CRTP(this->as_imp(*this).add_to_entry(ii, jj, value));
   }
 
+  /**
+   * \brief Adds local_matrix[ii][jj] to the entry (row_indices[ii], col_indices[jj]), for all ii in
+   *        [0, row_indices.size()) and jj in [0, col_indices.size()).
+   *
+   *        Meant for assembly: the copy-on-write check is done once for the whole block and the sparse matrices locate
+   *        all columns of a row in one pass over that row. Indices may repeat. All entries have to be contained in the
+   *        sparsity pattern, otherwise Exceptions::index_out_of_range is thrown by the sparse matrices (the entries
+   *        before the missing one have been added then). local_matrix has to be of size row_indices.size() times
+   *        col_indices.size() (which is asserted), so LocalMatrixType has to provide size() and local_matrix[ii][jj]
+   *        with local_matrix[ii].size(), e.g. Dune::DynamicMatrix or Dune::FieldMatrix.
+   */
+  template< class RowIndicesType, class ColIndicesType, class LocalMatrixType >
+  inline void add_to_entries(const RowIndicesType& row_indices,
+                             const ColIndicesType& col_indices,
+                             const LocalMatrixType& local_matrix)
+  {
+    CHECK_AND_CALL_CRTP(this->as_imp(*this).add_to_entries(row_indices, col_indices, local_matrix));
+  }
+
   inline void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     CHECK_AND_CALL_CRTP(this->as_imp(*this).set_entry(ii, jj, value));
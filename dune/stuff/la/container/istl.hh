@@ -8,6 +8,8 @@
 #ifndef DUNE_STUFF_LA_CONTAINER_ISTL_HH
 #define DUNE_STUFF_LA_CONTAINER_ISTL_HH
 
+#include <memory>
+
 #include <dune/common/static_assert.hh>
 
 #include <dune/common/fvector.hh>
@@ -22,7 +24,10 @@
 #endif // HAVE_DUNE_ISTL
 
 #include "interfaces.hh"
+#include "expressions.hh"
+#include "kernels.hh"
 #include "pattern.hh"
+#include "sparse_products.hh"
 
 namespace Dune {
 namespace Stuff {
@@ -66,6 +71,7 @@ public:
   typedef IstlDenseVectorTraits< ScalarImp > Traits;
   typedef typename Traits::ScalarType         ScalarType;
   typedef typename Traits::BackendType        BackendType;
+  typedef typename VectorInterfaceType::VectorReferencesType VectorReferencesType;
 
   IstlDenseVector(const size_t ss = 0, const ScalarType value = ScalarType(0))
     : backend_(new BackendType(ss))
@@ -117,6 +123,34 @@ public:
     return *this;
   } // ... operator=(...)
 
+  /**
+   *  \brief Evaluates the expression into this.
+   *  \see   assign()
+   */
+  template< class E >
+  ThisType& operator=(const Expressions::VectorExpression< E >& expression)
+  {
+    return assign(expression);
+  }
+
+  /**
+   *  \brief Evaluates the expression into this in a single loop, without any temporaries.
+   *  \see   Expressions
+   */
+  template< class E >
+  ThisType& assign(const Expressions::VectorExpression< E >& expression)
+  {
+    const E& expr = expression.as_imp();
+    if (expr.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the expression (" << expr.size() << ") does not match the size of this ("
+                            << size() << ")!");
+    ScalarType* this_entries = entries();
+    for (size_t ii = 0; ii < expr.size(); ++ii)
+      this_entries[ii] = expr[ii];
+    return *this;
+  } // ... assign(...)
+
   /**
    * \defgroup backend ´´These methods are required by the ProvidesBackend interface.``
    * \{
@@ -185,6 +219,17 @@ public:
     backend()[ii][0] += value;
   } // ... add_to_entry(...)
 
+  template< class IndicesType, class LocalVectorType >
+  void add_to_entries(const IndicesType& indices, const LocalVectorType& local_vector)
+  {
+    assert(local_vector.size() == indices.size());
+    ScalarType* this_entries = entries();
+    for (size_t ii = 0; ii < indices.size(); ++ii) {
+      assert(size_t(indices[ii]) < size());
+      this_entries[indices[ii]] += local_vector[ii];
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const ScalarType& value)
   {
     assert(ii < size());
@@ -218,28 +263,63 @@ public:
    * \{
    */
 
+  virtual std::pair< size_t, ScalarType > amax() const DS_OVERRIDE DS_FINAL
+  {
+    return Kernels::amax(entries(), size());
+  }
+
+  virtual bool almost_equal(const ThisType& other,
+                            const ScalarType epsilon = Dune::FloatCmp::DefaultEpsilon< ScalarType >::value()) const
+    DS_OVERRIDE DS_FINAL
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    return Kernels::almost_equal(entries(), other.entries(), size(), epsilon);
+  } // ... almost_equal(...)
+
   virtual ScalarType dot(const ThisType& other) const DS_OVERRIDE DS_FINAL
   {
     if (other.size() != size())
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    return backend_->dot(*(other.backend_));
+    return Kernels::dot(entries(), other.entries(), size());
   } // ... dot(...)
 
   virtual ScalarType l1_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->one_norm();
+    return Kernels::l1_norm(entries(), size());
   }
 
   virtual ScalarType l2_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->two_norm();
+    return std::sqrt(Kernels::dot(entries(), entries(), size()));
   }
 
   virtual ScalarType sup_norm() const DS_OVERRIDE DS_FINAL
   {
-    return backend_->infinity_norm();
+    return amax().second;
+  }
+
+  virtual ScalarType compensated_dot(const ThisType& other) const DS_OVERRIDE DS_FINAL
+  {
+    if (other.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of other (" << other.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    return Kernels::compensated_dot(entries(), other.entries(), size());
+  } // ... compensated_dot(...)
+
+  virtual ScalarType compensated_l1_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return Kernels::compensated_l1_norm(entries(), size());
+  }
+
+  virtual ScalarType compensated_l2_norm() const DS_OVERRIDE DS_FINAL
+  {
+    return std::sqrt(Kernels::compensated_dot(entries(), entries(), size()));
   }
 
   virtual void add(const ThisType& other, ThisType& result) const DS_OVERRIDE DS_FINAL
@@ -252,8 +332,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of result (" << result.size() << ") does not match the size of this (" << size()
                             << ")!");
-    result.backend() = *(backend_);
-    result.backend() += *(other.backend_);
+    ScalarType* result_entries = result.entries();
+    Kernels::add(entries(), other.entries(), result_entries, size());
   } // ... add(...)
 
   virtual ThisType add(const ThisType& other) const DS_OVERRIDE DS_FINAL
@@ -262,8 +342,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    ThisType result = copy();
-    result.backend_->operator+=(*(other.backend_));
+    ThisType result(size());
+    Kernels::add(entries(), other.entries(), result.entries(), size());
     return result;
   } // ... add(...)
 
@@ -273,7 +353,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    backend()+=(*(other.backend_));
+    ScalarType* this_entries = entries();
+    Kernels::add(this_entries, other.entries(), this_entries, size());
   } // ... iadd(...)
 
   virtual void sub(const ThisType& other, ThisType& result) const DS_OVERRIDE DS_FINAL
@@ -286,8 +367,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of result (" << result.size() << ") does not match the size of this (" << size()
                             << ")!");
-    result.backend() = *(backend_);
-    result.backend() -= *(other.backend_);
+    ScalarType* result_entries = result.entries();
+    Kernels::sub(entries(), other.entries(), result_entries, size());
   } // ... sub(...)
 
   virtual ThisType sub(const ThisType& other) const DS_OVERRIDE DS_FINAL
@@ -296,8 +377,8 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    ThisType result = copy();
-    result.backend_->operator-=(*(other.backend_));
+    ThisType result(size());
+    Kernels::sub(entries(), other.entries(), result.entries(), size());
     return result;
   } // ... sub(...)
 
@@ -307,9 +388,53 @@ public:
       DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
                             "The size of other (" << other.size() << ") does not match the size of this (" << size()
                             << ")!");
-    backend()-=(*(other.backend_));
+    ScalarType* this_entries = entries();
+    Kernels::sub(this_entries, other.entries(), this_entries, size());
   } // ... isub(...)
 
+  virtual void axpby(const ScalarType& alpha, const ThisType& xx, const ScalarType& beta) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = entries();
+    Kernels::axpby(alpha, xx.entries(), beta, this_entries, size());
+  } // ... axpby(...)
+
+  virtual ScalarType axpy_and_norm(const ScalarType& alpha, const ThisType& xx) DS_OVERRIDE DS_FINAL
+  {
+    if (xx.size() != size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") does not match the size of this (" << size()
+                            << ")!");
+    ScalarType* this_entries = entries();
+    return Kernels::axpy_and_norm(alpha, xx.entries(), this_entries, size());
+  } // ... axpy_and_norm(...)
+
+  virtual void linear_combination(const std::vector< ScalarType >& coefficients,
+                                  const VectorReferencesType& vectors) DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(coefficients, vectors);
+    ScalarType* this_entries = entries();
+    const auto vectors_entries = VectorInterfaceType::entries_of(vectors);
+    Kernels::linear_combination(coefficients.data(), vectors_entries.data(), vectors.size(), this_entries, size());
+  } // ... linear_combination(...)
+
+  virtual std::vector< ScalarType > dot_many(const VectorReferencesType& others) const DS_OVERRIDE DS_FINAL
+  {
+    this->check_sizes(others);
+    std::vector< ScalarType > result(others.size());
+    Kernels::dot_many(entries(), VectorInterfaceType::entries_of(others).data(), others.size(), result.data(), size());
+    return result;
+  } // ... dot_many(...)
+
+  //! \see VectorInterface::gram_matrix()
+  static std::vector< std::vector< ScalarType > > gram_matrix(const VectorReferencesType& vectors)
+  {
+    return VectorInterfaceType::contiguous_gram_matrix(vectors);
+  }
+
   /**
    * \}
    */
@@ -321,6 +446,23 @@ private:
       backend_ = std::make_shared< BackendType >(*backend_);
   } // ... ensure_uniqueness(...)
 
+  /**
+   *  \return the contiguous storage of the backend for the Kernels, nullptr if empty
+   *  \note   A BlockVector of FieldVector< ScalarType, 1 > stores its blocks (and thus the scalars) contiguously.
+   */
+  inline const ScalarType* entries() const
+  {
+    static_assert(sizeof(typename BackendType::block_type) == sizeof(ScalarType),
+                  "The scalars of the backend have to be stored contiguously!");
+    return size() > 0 ? &(backend_->operator[](0)[0]) : nullptr;
+  }
+
+  inline ScalarType* entries()
+  {
+    ensure_uniqueness();
+    return size() > 0 ? &(backend_->operator[](0)[0]) : nullptr;
+  }
+
   friend class VectorInterface< IstlDenseVectorTraits< ScalarType > >;
   friend class IstlRowMajorSparseMatrix< ScalarType >;
 
@@ -356,6 +498,7 @@ public:
   typedef IstlRowMajorSparseMatrixTraits< ScalarImp > Traits;
   typedef typename Traits::BackendType  BackendType;
   typedef typename Traits::ScalarType   ScalarType;
+  typedef typename IstlDenseVector< ScalarType >::BackendType VectorBackendType;
 
   /**
    * \brief This is the constructor of interest which creates a sparse matrix.
@@ -363,19 +506,16 @@ public:
   IstlRowMajorSparseMatrix(const size_t rr, const size_t cc, const SparsityPatternDefault& pattern)
     : backend_(new BackendType(rr, cc, BackendType::row_wise))
   {
-    if (size_t(pattern.size()) != rr)
-      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
-                            "The size of the pattern (" << pattern.size()
-                            << ") does not match the number of rows of this (" << rows() << ")!");
-    size_t row_index = 0;
-    for (auto row = backend_->createbegin(); row != backend_->createend(); ++row) {
-      assert(row_index < pattern.size());
-      const auto& cols = pattern.inner(row_index);
-      for (const auto& col : cols)
-        row.insert(col);
-      ++row_index;
-    }
-    backend_->operator*=(ScalarType(0));
+    build_sparse_layout(pattern);
+  }
+
+  /**
+   * \brief Creates a sparse matrix from a compressed pattern, allocating exactly the required number of nonzeros.
+   */
+  IstlRowMajorSparseMatrix(const size_t rr, const size_t cc, const SparsityPatternCompressed& pattern)
+    : backend_(new BackendType(rr, cc, pattern.num_nonzeros(), BackendType::row_wise))
+  {
+    build_sparse_layout(pattern);
   }
 
   IstlRowMajorSparseMatrix(const size_t rr = 0, const size_t cc = 0)
@@ -446,6 +586,17 @@ public:
     ensure_uniqueness();
     return *backend_;
   } // ... backend(...)
+
+  /**
+   *  \brief Identifies the current backend, e.g. to cache something computed from it (see LA::SolverCache).
+   *  \note  In contrast to the address of the backend, the handle can not be mistaken for a backend allocated later on
+   *         at the same address: it expires once the backend is freed.
+   */
+  std::weak_ptr< const BackendType > backend_handle() const
+  {
+    ensure_uniqueness();
+    return backend_;
+  }
   /**
    * \}
    */
@@ -503,10 +654,44 @@ public:
     static_assert(Dune::AlwaysFalse< SourceType >::value, "Not available for this combination of xx and yy!");
   }
 
+  /**
+   * \brief yy = A*xx, threaded (see SparseProducts).
+   */
   inline void mv(const IstlDenseVector< ScalarType >& xx, IstlDenseVector< ScalarType >& yy) const
   {
-    backend_->mv(*(xx.backend_), yy.backend());
-  }
+    if (&xx == &yy) {
+      const IstlDenseVector< ScalarType > tmp = xx.copy();
+      mv(tmp, yy);
+    } else
+      mv(*(xx.backend_), yy.backend(), row_partition());
+  } // ... mv(...)
+
+  /**
+   * \brief yy = A^T*xx, threaded (see SparseProducts).
+   */
+  void mtv(const IstlDenseVector< ScalarType >& xx, IstlDenseVector< ScalarType >& yy) const
+  {
+    if (xx.size() != rows() || yy.size() != cols())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    if (&xx == &yy) {
+      const IstlDenseVector< ScalarType > tmp = xx.copy();
+      mtv(tmp, yy);
+      return;
+    }
+    const BackendType& matrix = *backend_;
+    const VectorBackendType& source = *(xx.backend_);
+    SparseProducts::accumulate_ranges(row_partition(), yy.entries(), cols(),
+                                      [&](const size_t first, const size_t last, ScalarType* target) {
+      for (size_t ii = first; ii < last; ++ii) {
+        const ScalarType source_entry = source[ii][0];
+        const auto& row = matrix[ii];
+        for (auto entry = row.begin(); entry != row.end(); ++entry)
+          target[entry.index()] += (*entry)[0][0]*source_entry;
+      }
+    });
+  } // ... mtv(...)
 
   void add_to_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
@@ -514,6 +699,34 @@ public:
     backend()[ii][jj][0][0] += value;
   } // ... add_to_entry(...)
 
+  template< class RowIndicesType, class ColIndicesType, class LocalMatrixType >
+  void add_to_entries(const RowIndicesType& row_indices,
+                      const ColIndicesType& col_indices,
+                      const LocalMatrixType& local_matrix)
+  {
+    assert(local_matrix.size() == row_indices.size());
+    const Kernels::SortedOrder<> order(col_indices);
+    BackendType& matrix = backend();
+    for (size_t ii = 0; ii < row_indices.size(); ++ii) {
+      const size_t row_index = row_indices[ii];
+      assert(row_index < rows());
+      assert(local_matrix[ii].size() == col_indices.size());
+      auto& row = matrix[row_index];
+      // the columns are visited in ascending order, so the position in the row only moves forward
+      auto entry = row.begin();
+      const auto row_end = row.end();
+      for (const size_t jj : order) {
+        const size_t col = col_indices[jj];
+        while (entry != row_end && size_t(entry.index()) < col)
+          ++entry;
+        if (entry == row_end || size_t(entry.index()) != col)
+          DUNE_THROW_COLORFULLY(Exceptions::index_out_of_range,
+                                "Entry (" << row_index << ", " << col << ") is not contained in the sparsity pattern!");
+        (*entry)[0][0] += local_matrix[ii][jj];
+      }
+    }
+  } // ... add_to_entries(...)
+
   void set_entry(const size_t ii, const size_t jj, const ScalarType& value)
   {
     assert(these_are_valid_indices(ii, jj));
@@ -585,7 +798,78 @@ public:
    * \}
    */
 
+  /**
+   * \defgroup threaded_products ´´These methods work on the backends, they are used by the dune-istl solvers.``
+   * \{
+   */
+
+  //! The partition of the rows used by the threaded products, compute it once to apply the matrix repeatedly.
+  SparseProducts::RowPartition row_partition() const
+  {
+    const BackendType& matrix = *backend_;
+    return SparseProducts::RowPartition::from_row_sizes(rows(), [&](const size_t ii) {
+      return size_t(matrix[ii].getsize());
+    });
+  } // ... row_partition(...)
+
+  //! yy = A*xx, xx and yy must not coincide
+  void mv(const VectorBackendType& xx, VectorBackendType& yy, const SparseProducts::RowPartition& partition) const
+  {
+    apply_rows(ScalarType(1), xx, yy, partition, false);
+  }
+
+  //! yy += alpha*A*xx, xx and yy must not coincide
+  void usmv(const ScalarType& alpha, const VectorBackendType& xx, VectorBackendType& yy,
+            const SparseProducts::RowPartition& partition) const
+  {
+    apply_rows(alpha, xx, yy, partition, true);
+  }
+  /**
+   * \}
+   */
+
 private:
+  void apply_rows(const ScalarType& alpha, const VectorBackendType& xx, VectorBackendType& yy,
+                  const SparseProducts::RowPartition& partition, const bool add) const
+  {
+    if (size_t(xx.size()) != cols() || size_t(yy.size()) != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of xx (" << xx.size() << ") or yy (" << yy.size()
+                            << ") does not match the shape of this (" << rows() << "x" << cols() << ")!");
+    assert(partition.rows() == rows());
+    const BackendType& matrix = *backend_;
+    SparseProducts::for_each_range(partition, [&](const size_t first, const size_t last) {
+      for (size_t ii = first; ii < last; ++ii) {
+        ScalarType sum(0);
+        const auto& row = matrix[ii];
+        for (auto entry = row.begin(); entry != row.end(); ++entry)
+          sum += (*entry)[0][0]*xx[entry.index()][0];
+        if (add)
+          yy[ii][0] += alpha*sum;
+        else
+          yy[ii][0] = sum;
+      }
+    });
+  } // ... apply_rows(...)
+
+  template< class PatternType >
+  void build_sparse_layout(const PatternType& pattern)
+  {
+    if (size_t(pattern.size()) != rows())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The size of the pattern (" << pattern.size()
+                            << ") does not match the number of rows of this (" << rows() << ")!");
+    size_t row_index = 0;
+    for (auto row = backend_->createbegin(); row != backend_->createend(); ++row) {
+      assert(row_index < pattern.size());
+      const auto& cols = pattern.inner(row_index);
+      for (const auto& col : cols)
+        row.insert(col);
+      ++row_index;
+    }
+    backend_->operator*=(ScalarType(0));
+  } // ... build_sparse_layout(...)
+
   bool these_are_valid_indices(const size_t ii, const size_t jj) const
   {
     if (ii >= rows())
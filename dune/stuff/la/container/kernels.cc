@@ -0,0 +1,522 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "config.h"
+
+#include "kernels.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define DUNE_STUFF_LA_KERNELS_X86 1
+# include <immintrin.h>
+# define DUNE_STUFF_LA_KERNELS_AVX2 __attribute__((target("avx2,fma")))
+# define DUNE_STUFF_LA_KERNELS_AVX512 __attribute__((target("avx512f")))
+#else
+# define DUNE_STUFF_LA_KERNELS_X86 0
+#endif
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+namespace Kernels {
+namespace internal {
+
+
+/**
+ *  Compensated summation of a few values, used to combine the lanes (and the remainders) of the vectorized compensated
+ *  kernels. Each lane holds a sum and the accumulated rounding errors of that sum.
+ */
+class CompensatedSum
+{
+public:
+  CompensatedSum()
+    : sum_(0)
+    , compensation_(0)
+  {}
+
+  void add(const double value)
+  {
+    compensated_add(sum_, compensation_, value);
+  }
+
+  void add_lanes(const double* sums, const double* compensations, const size_t num_lanes)
+  {
+    for (size_t ii = 0; ii < num_lanes; ++ii) {
+      add(sums[ii]);
+      compensation_ += compensations[ii];
+    }
+  } // ... add_lanes(...)
+
+  double sum() const
+  {
+    return sum_ + compensation_;
+  }
+
+private:
+  double sum_;
+  double compensation_;
+}; // class CompensatedSum
+
+
+//! combines the per lane maxima (and their indices) of the vectorized amax kernels
+std::pair< size_t, double > reduce_amax(const double* values, const double* indices, const size_t num_lanes)
+{
+  auto result = std::make_pair(size_t(0), 0.0);
+  for (size_t ii = 0; ii < num_lanes; ++ii) {
+    const size_t index = size_t(indices[ii]);
+    if (values[ii] > result.second || (values[ii] == result.second && index < result.first)) {
+      result.first = index;
+      result.second = values[ii];
+    }
+  }
+  return result;
+} // ... reduce_amax(...)
+
+
+#if DUNE_STUFF_LA_KERNELS_X86
+
+
+// =============
+// ==== AVX2 ===
+// =============
+DUNE_STUFF_LA_KERNELS_AVX2
+inline __m256d avx2_abs(const __m256d xx)
+{
+  return _mm256_andnot_pd(_mm256_set1_pd(-0.0), xx);
+}
+
+DUNE_STUFF_LA_KERNELS_AVX2
+inline void avx2_compensated_add(__m256d& sum, __m256d& compensation, const __m256d value)
+{
+  const __m256d tmp = _mm256_add_pd(sum, value);
+  const __m256d virtual_value = _mm256_sub_pd(tmp, sum);
+  const __m256d error = _mm256_add_pd(_mm256_sub_pd(sum, _mm256_sub_pd(tmp, virtual_value)),
+                                      _mm256_sub_pd(value, virtual_value));
+  compensation = _mm256_add_pd(compensation, error);
+  sum = tmp;
+} // ... avx2_compensated_add(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+double avx2_dot(const double* xx, const double* yy, const size_t size)
+{
+  __m256d sum_0 = _mm256_setzero_pd();
+  __m256d sum_1 = _mm256_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8) {
+    sum_0 = _mm256_fmadd_pd(_mm256_loadu_pd(xx + ii), _mm256_loadu_pd(yy + ii), sum_0);
+    sum_1 = _mm256_fmadd_pd(_mm256_loadu_pd(xx + ii + 4), _mm256_loadu_pd(yy + ii + 4), sum_1);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_add_pd(sum_0, sum_1));
+  double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; ii < size; ++ii)
+    result += xx[ii] * yy[ii];
+  return result;
+} // ... avx2_dot(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+double avx2_compensated_dot(const double* xx, const double* yy, const size_t size)
+{
+  __m256d sum = _mm256_setzero_pd();
+  __m256d compensation = _mm256_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4)
+    avx2_compensated_add(sum, compensation, _mm256_mul_pd(_mm256_loadu_pd(xx + ii), _mm256_loadu_pd(yy + ii)));
+  double sums[4];
+  double compensations[4];
+  _mm256_storeu_pd(sums, sum);
+  _mm256_storeu_pd(compensations, compensation);
+  CompensatedSum result;
+  result.add_lanes(sums, compensations, 4);
+  for (; ii < size; ++ii)
+    result.add(xx[ii] * yy[ii]);
+  return result.sum();
+} // ... avx2_compensated_dot(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+double avx2_l1_norm(const double* xx, const size_t size)
+{
+  __m256d sum_0 = _mm256_setzero_pd();
+  __m256d sum_1 = _mm256_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8) {
+    sum_0 = _mm256_add_pd(sum_0, avx2_abs(_mm256_loadu_pd(xx + ii)));
+    sum_1 = _mm256_add_pd(sum_1, avx2_abs(_mm256_loadu_pd(xx + ii + 4)));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_add_pd(sum_0, sum_1));
+  double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; ii < size; ++ii)
+    result += std::abs(xx[ii]);
+  return result;
+} // ... avx2_l1_norm(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+double avx2_compensated_l1_norm(const double* xx, const size_t size)
+{
+  __m256d sum = _mm256_setzero_pd();
+  __m256d compensation = _mm256_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4)
+    avx2_compensated_add(sum, compensation, avx2_abs(_mm256_loadu_pd(xx + ii)));
+  double sums[4];
+  double compensations[4];
+  _mm256_storeu_pd(sums, sum);
+  _mm256_storeu_pd(compensations, compensation);
+  CompensatedSum result;
+  result.add_lanes(sums, compensations, 4);
+  for (; ii < size; ++ii)
+    result.add(std::abs(xx[ii]));
+  return result.sum();
+} // ... avx2_compensated_l1_norm(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+std::pair< size_t, double > avx2_amax(const double* xx, const size_t size)
+{
+  // the indices are kept as doubles, which is exact for all sizes that fit into memory
+  __m256d values = _mm256_setzero_pd();
+  __m256d indices = _mm256_setzero_pd();
+  __m256d current = _mm256_set_pd(3, 2, 1, 0);
+  const __m256d increment = _mm256_set1_pd(4);
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4) {
+    const __m256d value = avx2_abs(_mm256_loadu_pd(xx + ii));
+    // ordered comparison, so NaNs are never taken
+    const __m256d greater = _mm256_cmp_pd(value, values, _CMP_GT_OQ);
+    values = _mm256_blendv_pd(values, value, greater);
+    indices = _mm256_blendv_pd(indices, current, greater);
+    current = _mm256_add_pd(current, increment);
+  }
+  double lane_values[4];
+  double lane_indices[4];
+  _mm256_storeu_pd(lane_values, values);
+  _mm256_storeu_pd(lane_indices, indices);
+  auto result = reduce_amax(lane_values, lane_indices, 4);
+  for (; ii < size; ++ii) {
+    const double value = std::abs(xx[ii]);
+    if (value > result.second) {
+      result.first = ii;
+      result.second = value;
+    }
+  }
+  return result;
+} // ... avx2_amax(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+bool avx2_almost_equal(const double* xx, const double* yy, const size_t size, const double epsilon)
+{
+  const __m256d eps = _mm256_set1_pd(epsilon);
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4) {
+    const __m256d xx_ii = _mm256_loadu_pd(xx + ii);
+    const __m256d yy_ii = _mm256_loadu_pd(yy + ii);
+    const __m256d difference = avx2_abs(_mm256_sub_pd(xx_ii, yy_ii));
+    const __m256d bound = _mm256_mul_pd(eps, _mm256_max_pd(avx2_abs(xx_ii), avx2_abs(yy_ii)));
+    if (_mm256_movemask_pd(_mm256_cmp_pd(difference, bound, _CMP_LE_OQ)) != 0xF)
+      return false;
+  }
+  return almost_equal< double >(xx + ii, yy + ii, size - ii, epsilon);
+} // ... avx2_almost_equal(...)
+
+DUNE_STUFF_LA_KERNELS_AVX2
+void avx2_add(const double* xx, const double* yy, double* result, const size_t size)
+{
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4)
+    _mm256_storeu_pd(result + ii, _mm256_add_pd(_mm256_loadu_pd(xx + ii), _mm256_loadu_pd(yy + ii)));
+  for (; ii < size; ++ii)
+    result[ii] = xx[ii] + yy[ii];
+}
+
+DUNE_STUFF_LA_KERNELS_AVX2
+void avx2_sub(const double* xx, const double* yy, double* result, const size_t size)
+{
+  size_t ii = 0;
+  for (; ii + 4 <= size; ii += 4)
+    _mm256_storeu_pd(result + ii, _mm256_sub_pd(_mm256_loadu_pd(xx + ii), _mm256_loadu_pd(yy + ii)));
+  for (; ii < size; ++ii)
+    result[ii] = xx[ii] - yy[ii];
+}
+
+
+// ================
+// ==== AVX-512 ===
+// ================
+DUNE_STUFF_LA_KERNELS_AVX512
+inline __m512d avx512_abs(const __m512d xx)
+{
+  return _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(xx),
+                                              _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+}
+
+DUNE_STUFF_LA_KERNELS_AVX512
+inline void avx512_compensated_add(__m512d& sum, __m512d& compensation, const __m512d value)
+{
+  const __m512d tmp = _mm512_add_pd(sum, value);
+  const __m512d virtual_value = _mm512_sub_pd(tmp, sum);
+  const __m512d error = _mm512_add_pd(_mm512_sub_pd(sum, _mm512_sub_pd(tmp, virtual_value)),
+                                      _mm512_sub_pd(value, virtual_value));
+  compensation = _mm512_add_pd(compensation, error);
+  sum = tmp;
+} // ... avx512_compensated_add(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+double avx512_sum_lanes(const __m512d xx)
+{
+  double lanes[8];
+  _mm512_storeu_pd(lanes, xx);
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+DUNE_STUFF_LA_KERNELS_AVX512
+double avx512_dot(const double* xx, const double* yy, const size_t size)
+{
+  __m512d sum_0 = _mm512_setzero_pd();
+  __m512d sum_1 = _mm512_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 16 <= size; ii += 16) {
+    sum_0 = _mm512_fmadd_pd(_mm512_loadu_pd(xx + ii), _mm512_loadu_pd(yy + ii), sum_0);
+    sum_1 = _mm512_fmadd_pd(_mm512_loadu_pd(xx + ii + 8), _mm512_loadu_pd(yy + ii + 8), sum_1);
+  }
+  double result = avx512_sum_lanes(_mm512_add_pd(sum_0, sum_1));
+  for (; ii < size; ++ii)
+    result += xx[ii] * yy[ii];
+  return result;
+} // ... avx512_dot(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+double avx512_compensated_dot(const double* xx, const double* yy, const size_t size)
+{
+  __m512d sum = _mm512_setzero_pd();
+  __m512d compensation = _mm512_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8)
+    avx512_compensated_add(sum, compensation, _mm512_mul_pd(_mm512_loadu_pd(xx + ii), _mm512_loadu_pd(yy + ii)));
+  double sums[8];
+  double compensations[8];
+  _mm512_storeu_pd(sums, sum);
+  _mm512_storeu_pd(compensations, compensation);
+  CompensatedSum result;
+  result.add_lanes(sums, compensations, 8);
+  for (; ii < size; ++ii)
+    result.add(xx[ii] * yy[ii]);
+  return result.sum();
+} // ... avx512_compensated_dot(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+double avx512_l1_norm(const double* xx, const size_t size)
+{
+  __m512d sum_0 = _mm512_setzero_pd();
+  __m512d sum_1 = _mm512_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 16 <= size; ii += 16) {
+    sum_0 = _mm512_add_pd(sum_0, avx512_abs(_mm512_loadu_pd(xx + ii)));
+    sum_1 = _mm512_add_pd(sum_1, avx512_abs(_mm512_loadu_pd(xx + ii + 8)));
+  }
+  double result = avx512_sum_lanes(_mm512_add_pd(sum_0, sum_1));
+  for (; ii < size; ++ii)
+    result += std::abs(xx[ii]);
+  return result;
+} // ... avx512_l1_norm(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+double avx512_compensated_l1_norm(const double* xx, const size_t size)
+{
+  __m512d sum = _mm512_setzero_pd();
+  __m512d compensation = _mm512_setzero_pd();
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8)
+    avx512_compensated_add(sum, compensation, avx512_abs(_mm512_loadu_pd(xx + ii)));
+  double sums[8];
+  double compensations[8];
+  _mm512_storeu_pd(sums, sum);
+  _mm512_storeu_pd(compensations, compensation);
+  CompensatedSum result;
+  result.add_lanes(sums, compensations, 8);
+  for (; ii < size; ++ii)
+    result.add(std::abs(xx[ii]));
+  return result.sum();
+} // ... avx512_compensated_l1_norm(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+std::pair< size_t, double > avx512_amax(const double* xx, const size_t size)
+{
+  __m512d values = _mm512_setzero_pd();
+  __m512d indices = _mm512_setzero_pd();
+  __m512d current = _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0);
+  const __m512d increment = _mm512_set1_pd(8);
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8) {
+    const __m512d value = avx512_abs(_mm512_loadu_pd(xx + ii));
+    const __mmask8 greater = _mm512_cmp_pd_mask(value, values, _CMP_GT_OQ);
+    values = _mm512_mask_blend_pd(greater, values, value);
+    indices = _mm512_mask_blend_pd(greater, indices, current);
+    current = _mm512_add_pd(current, increment);
+  }
+  double lane_values[8];
+  double lane_indices[8];
+  _mm512_storeu_pd(lane_values, values);
+  _mm512_storeu_pd(lane_indices, indices);
+  auto result = reduce_amax(lane_values, lane_indices, 8);
+  for (; ii < size; ++ii) {
+    const double value = std::abs(xx[ii]);
+    if (value > result.second) {
+      result.first = ii;
+      result.second = value;
+    }
+  }
+  return result;
+} // ... avx512_amax(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+bool avx512_almost_equal(const double* xx, const double* yy, const size_t size, const double epsilon)
+{
+  const __m512d eps = _mm512_set1_pd(epsilon);
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8) {
+    const __m512d xx_ii = _mm512_loadu_pd(xx + ii);
+    const __m512d yy_ii = _mm512_loadu_pd(yy + ii);
+    const __m512d difference = avx512_abs(_mm512_sub_pd(xx_ii, yy_ii));
+    const __m512d bound = _mm512_mul_pd(eps, _mm512_max_pd(avx512_abs(xx_ii), avx512_abs(yy_ii)));
+    if (_mm512_cmp_pd_mask(difference, bound, _CMP_LE_OQ) != 0xFF)
+      return false;
+  }
+  return almost_equal< double >(xx + ii, yy + ii, size - ii, epsilon);
+} // ... avx512_almost_equal(...)
+
+DUNE_STUFF_LA_KERNELS_AVX512
+void avx512_add(const double* xx, const double* yy, double* result, const size_t size)
+{
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8)
+    _mm512_storeu_pd(result + ii, _mm512_add_pd(_mm512_loadu_pd(xx + ii), _mm512_loadu_pd(yy + ii)));
+  for (; ii < size; ++ii)
+    result[ii] = xx[ii] + yy[ii];
+}
+
+DUNE_STUFF_LA_KERNELS_AVX512
+void avx512_sub(const double* xx, const double* yy, double* result, const size_t size)
+{
+  size_t ii = 0;
+  for (; ii + 8 <= size; ii += 8)
+    _mm512_storeu_pd(result + ii, _mm512_sub_pd(_mm512_loadu_pd(xx + ii), _mm512_loadu_pd(yy + ii)));
+  for (; ii < size; ++ii)
+    result[ii] = xx[ii] - yy[ii];
+}
+
+
+#endif // DUNE_STUFF_LA_KERNELS_X86
+
+
+InstructionSet detect_instruction_set()
+{
+#if DUNE_STUFF_LA_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return InstructionSet::avx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return InstructionSet::avx2;
+#endif // DUNE_STUFF_LA_KERNELS_X86
+  return InstructionSet::scalar;
+} // ... detect_instruction_set(...)
+
+
+std::atomic< int >& current_instruction_set()
+{
+  static std::atomic< int > instruction_set(static_cast< int >(supported_instruction_set()));
+  return instruction_set;
+}
+
+
+} // namespace internal
+
+
+std::string to_string(const InstructionSet instruction_set)
+{
+  switch (instruction_set) {
+    case InstructionSet::avx512: return "avx512";
+    case InstructionSet::avx2:   return "avx2";
+    default:                     return "scalar";
+  }
+} // ... to_string(...)
+
+InstructionSet supported_instruction_set()
+{
+  static const InstructionSet supported = internal::detect_instruction_set();
+  return supported;
+}
+
+InstructionSet instruction_set()
+{
+  return InstructionSet(internal::current_instruction_set().load(std::memory_order_relaxed));
+}
+
+void use_instruction_set(const InstructionSet instruction_set)
+{
+  internal::current_instruction_set().store(std::min(int(instruction_set), int(supported_instruction_set())));
+}
+
+
+#if DUNE_STUFF_LA_KERNELS_X86
+# define DUNE_STUFF_LA_KERNELS_DISPATCH(name, ...) \
+  switch (instruction_set()) { \
+    case InstructionSet::avx512: return internal::avx512_ ## name(__VA_ARGS__); \
+    case InstructionSet::avx2:   return internal::avx2_ ## name(__VA_ARGS__); \
+    default:                     return name< double >(__VA_ARGS__); \
+  }
+#else
+# define DUNE_STUFF_LA_KERNELS_DISPATCH(name, ...) return name< double >(__VA_ARGS__);
+#endif
+
+double dot(const double* xx, const double* yy, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(dot, xx, yy, size)
+}
+
+double compensated_dot(const double* xx, const double* yy, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(compensated_dot, xx, yy, size)
+}
+
+double l1_norm(const double* xx, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(l1_norm, xx, size)
+}
+
+double compensated_l1_norm(const double* xx, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(compensated_l1_norm, xx, size)
+}
+
+std::pair< size_t, double > amax(const double* xx, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(amax, xx, size)
+}
+
+bool almost_equal(const double* xx, const double* yy, const size_t size, const double epsilon)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(almost_equal, xx, yy, size, epsilon)
+}
+
+void add(const double* xx, const double* yy, double* result, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(add, xx, yy, result, size)
+}
+
+void sub(const double* xx, const double* yy, double* result, const size_t size)
+{
+  DUNE_STUFF_LA_KERNELS_DISPATCH(sub, xx, yy, result, size)
+}
+
+#undef DUNE_STUFF_LA_KERNELS_DISPATCH
+
+
+} // namespace Kernels
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
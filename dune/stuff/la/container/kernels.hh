@@ -0,0 +1,320 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_LA_CONTAINER_KERNELS_HH
+#define DUNE_STUFF_LA_CONTAINER_KERNELS_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+
+/**
+ *  \brief Vector kernels working on contiguous storage, used by the dense vectors to implement VectorInterface.
+ *
+ *  The double overloads are implemented in kernels.cc, where an AVX2 and an AVX-512 variant of each kernel are compiled
+ *  (on x86 with gcc or clang) in addition to the scalar one. The variant is selected at runtime depending on the cpu,
+ *  so the library does not have to be compiled with -march=native. The templates are used for all other scalar types.
+ *
+ *  The compensated_* variants use the Kahan-Babuska (Neumaier) variant of compensated summation: the rounding error of
+ *  each addition is computed exactly (Knuth's TwoSum) and accumulated separately, so the error of the result
+ *  does not grow with the size of the vectors. This costs roughly twice the time of the plain variants (which are bound
+ *  by the memory bandwidth for large vectors anyway). They rely on strict IEEE semantics, i.e. they are useless if
+ *  compiled with -ffast-math.
+ *
+ *  The results of dot() and the norms may differ in the last bits between the instruction sets, since the order of
+ *  summation differs.
+ */
+namespace Kernels {
+
+
+enum class InstructionSet
+{
+    scalar
+  , avx2
+  , avx512
+}; // enum class InstructionSet
+
+std::string to_string(const InstructionSet instruction_set);
+
+//! the best instruction set supported by the cpu (and the compiler)
+InstructionSet supported_instruction_set();
+
+//! the instruction set used by the double kernels, supported_instruction_set() unless restricted
+InstructionSet instruction_set();
+
+/**
+ *  \brief Restricts the double kernels to the given instruction set (or the supported one, if less).
+ *  \note  Meant for tests and benchmarks, not thread safe with respect to running kernels.
+ */
+void use_instruction_set(const InstructionSet instruction_set);
+
+
+double dot(const double* xx, const double* yy, const size_t size);
+
+double compensated_dot(const double* xx, const double* yy, const size_t size);
+
+double l1_norm(const double* xx, const size_t size);
+
+double compensated_l1_norm(const double* xx, const size_t size);
+
+//! \return the lowest index at which the maximum absolute value is attained and that value, NaNs are ignored
+std::pair< size_t, double > amax(const double* xx, const size_t size);
+
+//! \return |xx[ii] - yy[ii]| <= epsilon*max(|xx[ii]|, |yy[ii]|) for all ii, as Dune::FloatCmp::eq
+bool almost_equal(const double* xx, const double* yy, const size_t size, const double epsilon);
+
+//! result[ii] = xx[ii] + yy[ii], result may coincide with xx or yy
+void add(const double* xx, const double* yy, double* result, const size_t size);
+
+//! result[ii] = xx[ii] - yy[ii], result may coincide with xx or yy
+void sub(const double* xx, const double* yy, double* result, const size_t size);
+
+
+namespace internal {
+
+
+//! adds value to sum and the rounding error of that addition to compensation (Knuth's TwoSum)
+template< class S >
+inline void compensated_add(S& sum, S& compensation, const S& value)
+{
+  const S tmp = sum + value;
+  const S virtual_value = tmp - sum;
+  compensation += (sum - (tmp - virtual_value)) + (value - virtual_value);
+  sum = tmp;
+} // ... compensated_add(...)
+
+
+} // namespace internal
+
+
+template< class S >
+S dot(const S* xx, const S* yy, const size_t size)
+{
+  S result = 0;
+  for (size_t ii = 0; ii < size; ++ii)
+    result += xx[ii] * yy[ii];
+  return result;
+}
+
+template< class S >
+S compensated_dot(const S* xx, const S* yy, const size_t size)
+{
+  S sum = 0;
+  S compensation = 0;
+  for (size_t ii = 0; ii < size; ++ii)
+    internal::compensated_add(sum, compensation, S(xx[ii] * yy[ii]));
+  return sum + compensation;
+} // ... compensated_dot(...)
+
+template< class S >
+S l1_norm(const S* xx, const size_t size)
+{
+  S result = 0;
+  for (size_t ii = 0; ii < size; ++ii)
+    result += std::abs(xx[ii]);
+  return result;
+}
+
+template< class S >
+S compensated_l1_norm(const S* xx, const size_t size)
+{
+  S sum = 0;
+  S compensation = 0;
+  for (size_t ii = 0; ii < size; ++ii)
+    internal::compensated_add(sum, compensation, S(std::abs(xx[ii])));
+  return sum + compensation;
+} // ... compensated_l1_norm(...)
+
+template< class S >
+std::pair< size_t, S > amax(const S* xx, const size_t size)
+{
+  auto result = std::make_pair(size_t(0), S(0));
+  for (size_t ii = 0; ii < size; ++ii) {
+    const auto value = std::abs(xx[ii]);
+    if (value > result.second) {
+      result.first = ii;
+      result.second = value;
+    }
+  }
+  return result;
+} // ... amax(...)
+
+template< class S >
+bool almost_equal(const S* xx, const S* yy, const size_t size, const S epsilon)
+{
+  for (size_t ii = 0; ii < size; ++ii) {
+    using std::abs;
+    using std::max;
+    if (!(abs(xx[ii] - yy[ii]) <= epsilon*max(abs(xx[ii]), abs(yy[ii]))))
+      return false;
+  }
+  return true;
+} // ... almost_equal(...)
+
+template< class S >
+void add(const S* xx, const S* yy, S* result, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    result[ii] = xx[ii] + yy[ii];
+}
+
+template< class S >
+void sub(const S* xx, const S* yy, S* result, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    result[ii] = xx[ii] - yy[ii];
+}
+
+
+/**
+ *  The multi-vector kernels below work on blocks of this many entries: the blocks of all vectors involved stay in the
+ *  L1 (or at least the L2) cache while they are combined, so each vector is read from memory only once.
+ */
+static const size_t block_size = 256;
+
+//! yy[ii] = alpha*xx[ii] + beta*yy[ii]
+template< class S >
+void axpby(const S& alpha, const S* xx, const S& beta, S* yy, const size_t size)
+{
+  for (size_t ii = 0; ii < size; ++ii)
+    yy[ii] = alpha*xx[ii] + beta*yy[ii];
+}
+
+//! yy[ii] += alpha*xx[ii], \return the l2-norm of the updated yy
+template< class S >
+S axpy_and_norm(const S& alpha, const S* xx, S* yy, const size_t size)
+{
+  S result = 0;
+  for (size_t ii = 0; ii < size; ++ii) {
+    yy[ii] += alpha*xx[ii];
+    result += yy[ii]*yy[ii];
+  }
+  return std::sqrt(result);
+} // ... axpy_and_norm(...)
+
+//! result[ii] = sum_jj coefficients[jj]*vectors[jj][ii], result may coincide with any of the vectors
+template< class S >
+void linear_combination(const S* coefficients, const S* const* vectors, const size_t num_vectors,
+                        S* result, const size_t size)
+{
+  S block[block_size];
+  for (size_t first = 0; first < size; first += block_size) {
+    const size_t length = std::min(block_size, size - first);
+    std::fill(block, block + length, S(0));
+    for (size_t jj = 0; jj < num_vectors; ++jj) {
+      const S* vector = vectors[jj] + first;
+      const S coefficient = coefficients[jj];
+      for (size_t ii = 0; ii < length; ++ii)
+        block[ii] += coefficient*vector[ii];
+    }
+    std::copy(block, block + length, result + first);
+  }
+} // ... linear_combination(...)
+
+//! result[jj] = dot(xx, yys[jj])
+template< class S >
+void dot_many(const S* xx, const S* const* yys, const size_t num_vectors, S* result, const size_t size)
+{
+  std::fill(result, result + num_vectors, S(0));
+  for (size_t first = 0; first < size; first += block_size) {
+    const size_t length = std::min(block_size, size - first);
+    for (size_t jj = 0; jj < num_vectors; ++jj)
+      result[jj] += dot(xx + first, yys[jj] + first, length);
+  }
+} // ... dot_many(...)
+
+//! result[ii*num_vectors + jj] = dot(vectors[ii], vectors[jj])
+template< class S >
+void gram_matrix(const S* const* vectors, const size_t num_vectors, S* result, const size_t size)
+{
+  std::fill(result, result + num_vectors*num_vectors, S(0));
+  for (size_t first = 0; first < size; first += block_size) {
+    const size_t length = std::min(block_size, size - first);
+    for (size_t ii = 0; ii < num_vectors; ++ii)
+      for (size_t jj = ii; jj < num_vectors; ++jj)
+        result[ii*num_vectors + jj] += dot(vectors[ii] + first, vectors[jj] + first, length);
+  }
+  for (size_t ii = 0; ii < num_vectors; ++ii)
+    for (size_t jj = 0; jj < ii; ++jj)
+      result[ii*num_vectors + jj] = result[jj*num_vectors + ii];
+} // ... gram_matrix(...)
+
+/**
+ *  \brief The permutation which sorts the given indices ascendingly, i.e. indices[order[kk]] <= indices[order[kk + 1]].
+ *  \note  Used by the sparse matrices to locate all columns of a local matrix in one pass over each (sorted) row. Up to
+ *         capacity indices are sorted by insertion sort in a buffer on the stack, so the usual local matrices do not
+ *         allocate. Only more indices are sorted in a std::vector.
+ */
+template< size_t capacity = 64 >
+class SortedOrder
+{
+public:
+  template< class IndicesType >
+  explicit SortedOrder(const IndicesType& indices)
+    : size_(indices.size())
+    , order_(local_)
+  {
+    if (size_ > capacity) {
+      heap_.resize(size_);
+      order_ = heap_.data();
+    }
+    for (size_t kk = 0; kk < size_; ++kk)
+      order_[kk] = kk;
+    if (size_ > capacity) {
+      std::sort(order_, order_ + size_, [&](const size_t lhs, const size_t rhs) {
+        return indices[lhs] < indices[rhs];
+      });
+    } else {
+      for (size_t kk = 1; kk < size_; ++kk) {
+        const size_t current = order_[kk];
+        size_t position = kk;
+        for (; position > 0 && indices[current] < indices[order_[position - 1]]; --position)
+          order_[position] = order_[position - 1];
+        order_[position] = current;
+      }
+    }
+  } // SortedOrder(...)
+
+  // order_ may point to local_
+  SortedOrder(const SortedOrder& /*other*/) = delete;
+
+  SortedOrder& operator=(const SortedOrder& /*other*/) = delete;
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  const size_t* begin() const
+  {
+    return order_;
+  }
+
+  const size_t* end() const
+  {
+    return order_ + size_;
+  }
+
+private:
+  const size_t size_;
+  size_t local_[capacity];
+  std::vector< size_t > heap_;
+  size_t* order_;
+}; // class SortedOrder
+
+
+} // namespace Kernels
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_LA_CONTAINER_KERNELS_HH
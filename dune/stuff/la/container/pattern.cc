@@ -7,6 +7,9 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace Dune {
 namespace Stuff {
 namespace LA {
@@ -57,6 +60,123 @@ bool SparsityPatternDefault::operator!=(const SparsityPatternDefault& other) con
 }
 
 
+// ===================================
+// ==== SparsityPatternCompressed ====
+// ===================================
+bool SparsityPatternCompressed::InnerType::contains(const size_t jj) const
+{
+  return std::binary_search(begin_, end_, jj);
+}
+
+SparsityPatternCompressed::SparsityPatternCompressed(const size_t _size)
+  : offsets_(_size + 1, 0)
+{}
+
+SparsityPatternCompressed::SparsityPatternCompressed(const SparsityPatternDefault& other)
+  : offsets_(other.size() + 1, 0)
+{
+  for (size_t ii = 0; ii < other.size(); ++ii)
+    offsets_[ii + 1] = offsets_[ii] + other.inner(ii).size();
+  columns_.reserve(offsets_.back());
+  for (const auto& row : other)
+    columns_.insert(columns_.end(), row.begin(), row.end());
+}
+
+SparsityPatternCompressed::SparsityPatternCompressed(std::vector< size_t >&& offsets, std::vector< size_t >&& columns)
+  : offsets_(std::move(offsets))
+  , columns_(std::move(columns))
+{
+  assert(!offsets_.empty() && "Wrong offsets given!");
+  assert(offsets_.front() == 0 && "Wrong offsets given!");
+  assert(offsets_.back() == columns_.size() && "Wrong offsets given!");
+}
+
+size_t SparsityPatternCompressed::size() const
+{
+  return offsets_.size() - 1;
+}
+
+size_t SparsityPatternCompressed::num_nonzeros() const
+{
+  return columns_.size();
+}
+
+typename SparsityPatternCompressed::InnerType SparsityPatternCompressed::inner(const size_t ii) const
+{
+  assert(ii < size() && "Wrong index requested!");
+  return InnerType(columns_.begin() + offsets_[ii], columns_.begin() + offsets_[ii + 1]);
+}
+
+const std::vector< size_t >& SparsityPatternCompressed::offsets() const
+{
+  return offsets_;
+}
+
+const std::vector< size_t >& SparsityPatternCompressed::columns() const
+{
+  return columns_;
+}
+
+bool SparsityPatternCompressed::operator==(const SparsityPatternCompressed& other) const
+{
+  return offsets_ == other.offsets_ && columns_ == other.columns_;
+}
+
+bool SparsityPatternCompressed::operator!=(const SparsityPatternCompressed& other) const
+{
+  return !(*this == other);
+}
+
+
+// ================================
+// ==== SparsityPatternBuilder ====
+// ================================
+SparsityPatternBuilder::SparsityPatternBuilder(const size_t _size)
+  : rows_(_size)
+{}
+
+size_t SparsityPatternBuilder::size() const
+{
+  return rows_.size();
+}
+
+void SparsityPatternBuilder::insert(const size_t ii, const size_t jj)
+{
+  assert(ii < size() && "Wrong index requested!");
+  auto& row = rows_[ii];
+  // try to get rid of duplicates before the vector reallocates
+  if (row.size() == row.capacity() && row.size() >= 8) {
+    compress(row);
+    // grow, if only a few duplicates were removed, otherwise we would compress again after a few inserts
+    if (2*row.size() > row.capacity())
+      row.reserve(2*row.capacity());
+  }
+  row.push_back(jj);
+} // ... insert(...)
+
+SparsityPatternCompressed SparsityPatternBuilder::finalize()
+{
+  std::vector< size_t > offsets(size() + 1, 0);
+  for (size_t ii = 0; ii < size(); ++ii) {
+    compress(rows_[ii]);
+    offsets[ii + 1] = offsets[ii] + rows_[ii].size();
+  }
+  std::vector< size_t > columns;
+  columns.reserve(offsets.back());
+  for (auto& row : rows_) {
+    columns.insert(columns.end(), row.begin(), row.end());
+    std::vector< size_t >().swap(row);
+  }
+  return SparsityPatternCompressed(std::move(offsets), std::move(columns));
+} // ... finalize(...)
+
+void SparsityPatternBuilder::compress(std::vector< size_t >& row)
+{
+  std::sort(row.begin(), row.end());
+  row.erase(std::unique(row.begin(), row.end()), row.end());
+}
+
+
 } // namespace LA
 } // namespace Stuff
 } // namespace Dune
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <vector>
 #include <set>
+#include <iterator>
 
 namespace Dune {
 namespace Stuff {
@@ -45,6 +46,129 @@ private:
 }; // class SparsityPatternDefault
 
 
+/**
+ *  \brief A sparsity pattern in compressed row storage.
+ *
+ *  The pattern of row ii is given by the sorted and unique column indices in
+ *  columns()[offsets()[ii]] to columns()[offsets()[ii + 1] - 1]. In contrast to SparsityPatternDefault no heap node is
+ *  allocated per nonzero and the whole pattern lives in two contiguous arrays. Use SparsityPatternBuilder to create
+ *  one.
+ */
+class SparsityPatternCompressed
+{
+public:
+  typedef std::vector< size_t >::const_iterator ConstInnerIteratorType;
+
+  /**
+   *  \brief Lightweight view on the column indices of one row, to be used like SparsityPatternDefault::InnerType.
+   */
+  class InnerType
+  {
+  public:
+    InnerType(const ConstInnerIteratorType bb, const ConstInnerIteratorType ee)
+      : begin_(bb)
+      , end_(ee)
+    {}
+
+    ConstInnerIteratorType begin() const
+    {
+      return begin_;
+    }
+
+    ConstInnerIteratorType end() const
+    {
+      return end_;
+    }
+
+    size_t size() const
+    {
+      return std::distance(begin_, end_);
+    }
+
+    bool contains(const size_t jj) const;
+
+  private:
+    ConstInnerIteratorType begin_;
+    ConstInnerIteratorType end_;
+  }; // class InnerType
+
+  /// Creates a pattern with _size empty rows.
+  explicit SparsityPatternCompressed(const size_t _size = 0);
+
+  /// Converts the given pattern.
+  explicit SparsityPatternCompressed(const SparsityPatternDefault& other);
+
+  /**
+   *  \attention offsets and columns are assumed to be valid, i.e. offsets has to be nondecreasing, start with 0 and
+   *             end with columns.size(), the column indices of each row have to be sorted and unique.
+   */
+  SparsityPatternCompressed(std::vector< size_t >&& offsets, std::vector< size_t >&& columns);
+
+  size_t size() const;
+
+  /// The total number of nonzero entries.
+  size_t num_nonzeros() const;
+
+  InnerType inner(const size_t ii) const;
+
+  const std::vector< size_t >& offsets() const;
+
+  const std::vector< size_t >& columns() const;
+
+  bool operator==(const SparsityPatternCompressed& other) const;
+
+  bool operator!=(const SparsityPatternCompressed& other) const;
+
+private:
+  std::vector< size_t > offsets_;
+  std::vector< size_t > columns_;
+}; // class SparsityPatternCompressed
+
+
+/**
+ *  \brief Collects (possibly unsorted and duplicate) entries and creates a SparsityPatternCompressed.
+ *
+ *  Typical usage during assembly setup:
+\code
+SparsityPatternBuilder builder(num_rows);
+for (each entity)
+  for (each local row ii)
+    builder.insert(global_row(ii), global_cols.begin(), global_cols.end());
+const SparsityPatternCompressed pattern = builder.finalize();
+\endcode
+ *  Each row is kept in a plain vector which is sorted and made unique whenever it runs out of capacity, so the memory
+ *  consumption of the builder stays proportional to the number of distinct nonzeros. If that frees less than half of
+ *  the row, its capacity is doubled, so rows with mostly distinct entries are not sorted again on every insert.
+ */
+class SparsityPatternBuilder
+{
+public:
+  SparsityPatternBuilder(const size_t _size);
+
+  size_t size() const;
+
+  void insert(const size_t ii, const size_t jj);
+
+  template< class ColumnIteratorType >
+  void insert(const size_t ii, ColumnIteratorType col_begin, const ColumnIteratorType col_end)
+  {
+    for (; col_begin != col_end; ++col_begin)
+      insert(ii, *col_begin);
+  }
+
+  /**
+   *  \brief Sorts and removes duplicates from all rows and creates the compressed pattern.
+   *  \note  Leaves the builder with empty rows, so it may be reused afterwards.
+   */
+  SparsityPatternCompressed finalize();
+
+private:
+  static void compress(std::vector< size_t >& row);
+
+  std::vector< std::vector< size_t > > rows_;
+}; // class SparsityPatternBuilder
+
+
 //// forward of the Interface
 //template< class T >
 //class MatrixInterface;
@@ -0,0 +1,206 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff/
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_LA_CONTAINER_SPARSE_PRODUCTS_HH
+#define DUNE_STUFF_LA_CONTAINER_SPARSE_PRODUCTS_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <dune/stuff/common/threadmanager.hh>
+
+#include "kernels.hh"
+
+namespace Dune {
+namespace Stuff {
+namespace LA {
+
+/**
+ *  \brief Threaded products of row major sparse matrices with vectors, used by the sparse matrices to implement mv()
+ *         and mtv().
+ *
+ *  The rows are split into at most ThreadManager::max_threads() contiguous ranges, such that each range contains about
+ *  the same number of nonzeros (the work of a row is proportional to its nonzeros, not to its existence). Each range is
+ *  then multiplied by one thread of the ThreadManager. Ranges contain at least min_nonzeros_per_range nonzeros, so small
+ *  matrices are multiplied on the calling thread, where waking up the pool would cost more than the product itself.
+ *
+ *  For the transposed product, the contributions of each range are accumulated into a buffer per thread, which are
+ *  summed up (in parallel) afterwards.
+ */
+namespace SparseProducts {
+
+
+static const size_t min_nonzeros_per_range = 16384;
+
+
+//! boundaries of contiguous row ranges containing about the same number of nonzeros
+class RowPartition
+{
+public:
+  /**
+   *  \param offsets as in the compressed row storage format, i.e. row ii contains the nonzeros
+   *         [offsets[ii], offsets[ii + 1]), of size rows + 1
+   */
+  template< class OffsetType >
+  RowPartition(const size_t rows, const OffsetType* offsets,
+               const size_t max_ranges = ThreadManager::max_threads())
+    : RowPartition(rows, rows > 0 ? size_t(offsets[rows] - offsets[0]) : 0, max_ranges)
+  {
+    for (size_t rr = 1; rr < num_ranges(); ++rr) {
+      const OffsetType target = offsets[0] + OffsetType(target_nonzeros(rr));
+      boundaries_[rr] = std::lower_bound(offsets, offsets + rows + 1, target) - offsets;
+    }
+  } // RowPartition(...)
+
+  /**
+   *  \brief Yields the same partition as the offsets would, without computing them.
+   *  \param row_size row_size(ii) has to return the number of nonzeros in row ii, it is called twice per row
+   */
+  template< class RowSizeFunctionType >
+  static RowPartition from_row_sizes(const size_t rows, const RowSizeFunctionType& row_size,
+                                     const size_t max_ranges = ThreadManager::max_threads())
+  {
+    size_t nonzeros = 0;
+    for (size_t ii = 0; ii < rows; ++ii)
+      nonzeros += row_size(ii);
+    RowPartition partition(rows, nonzeros, max_ranges);
+    // the first row whose offset reaches the target, as the lower_bound above
+    size_t offset = 0;
+    size_t rr = 1;
+    for (size_t ii = 0; rr < partition.num_ranges(); ++ii) {
+      for (; rr < partition.num_ranges() && partition.target_nonzeros(rr) <= offset; ++rr)
+        partition.boundaries_[rr] = ii;
+      if (ii < rows)
+        offset += row_size(ii);
+    }
+    return partition;
+  } // ... from_row_sizes(...)
+
+  size_t rows() const
+  {
+    return boundaries_.back();
+  }
+
+  size_t nonzeros() const
+  {
+    return nonzeros_;
+  }
+
+  size_t num_ranges() const
+  {
+    return boundaries_.size() - 1;
+  }
+
+  //! \return the max_ranges given on construction, a partition for a different thread count should be recomputed
+  size_t max_ranges() const
+  {
+    return max_ranges_;
+  }
+
+  size_t first(const size_t range) const
+  {
+    assert(range < num_ranges());
+    return boundaries_[range];
+  }
+
+  size_t last(const size_t range) const
+  {
+    assert(range < num_ranges());
+    return boundaries_[range + 1];
+  }
+
+private:
+  //! sets the number of ranges, the boundaries in between are left to the caller
+  RowPartition(const size_t rows, const size_t nonzeros, const size_t max_ranges)
+    : nonzeros_(nonzeros)
+    , max_ranges_(max_ranges)
+    , boundaries_(std::max(size_t(1), std::min(max_ranges, nonzeros/min_nonzeros_per_range)) + 1, rows)
+  {
+    boundaries_[0] = 0;
+  }
+
+  //! the number of nonzeros before the first row of range rr
+  size_t target_nonzeros(const size_t rr) const
+  {
+    return (rr*nonzeros_)/num_ranges();
+  }
+
+  size_t nonzeros_;
+  size_t max_ranges_;
+  std::vector< size_t > boundaries_;
+}; // class RowPartition
+
+
+/**
+ *  \brief Calls rows(first, last) for each range [first, last) of the partition, in parallel.
+ *
+ *  Ranges are assigned to the threads in order, so each thread works on a contiguous block of rows. rows may only write
+ *  to data belonging to its own rows.
+ */
+template< class RowRangeFunctionType >
+void for_each_range(const RowPartition& partition, const RowRangeFunctionType& rows)
+{
+  if (partition.num_ranges() == 1) {
+    rows(partition.first(0), partition.last(0));
+    return;
+  }
+  ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+    const size_t first_range = (chunk*partition.num_ranges())/num_chunks;
+    const size_t last_range = ((chunk + 1)*partition.num_ranges())/num_chunks;
+    if (first_range < last_range)
+      rows(partition.first(first_range), partition.last(last_range - 1));
+  });
+} // ... for_each_range(...)
+
+
+/**
+ *  \brief Computes result = sum of the contributions of all rows, where rows(first, last, target) has to add the
+ *         contributions of the rows [first, last) to target (of length size, zero on entry).
+ *
+ *  This is what the transposed product of a row major matrix looks like: the rows scatter into all of result, so each
+ *  thread gets its own target and the targets are summed up afterwards.
+ */
+template< class S, class RowRangeFunctionType >
+void accumulate_ranges(const RowPartition& partition, S* result, const size_t size, const RowRangeFunctionType& rows)
+{
+  if (partition.num_ranges() == 1) {
+    std::fill(result, result + size, S(0));
+    rows(partition.first(0), partition.last(0), result);
+    return;
+  }
+  // the first thread accumulates into result directly, the others allocate their buffer themselves (so it is placed
+  // near them on NUMA machines)
+  std::vector< std::vector< S > > buffers(ThreadManager::max_threads());
+  ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+    const size_t first_range = (chunk*partition.num_ranges())/num_chunks;
+    const size_t last_range = ((chunk + 1)*partition.num_ranges())/num_chunks;
+    S* target = result;
+    if (chunk > 0) {
+      if (first_range == last_range)
+        return;
+      assert(chunk < buffers.size());
+      buffers[chunk].assign(size, S(0));
+      target = buffers[chunk].data();
+    } else
+      std::fill(result, result + size, S(0));
+    if (first_range < last_range)
+      rows(partition.first(first_range), partition.last(last_range - 1), target);
+  });
+  ThreadManager::parallel_for(0, size, [&](const size_t first, const size_t last) {
+    for (const auto& buffer : buffers)
+      if (!buffer.empty())
+        Kernels::add(result + first, buffer.data() + first, result + first, last - first);
+  });
+} // ... accumulate_ranges(...)
+
+
+} // namespace SparseProducts
+} // namespace LA
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_LA_CONTAINER_SPARSE_PRODUCTS_HH
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 #include <dune/stuff/common/type_utils.hh>
 #include <dune/stuff/common/exceptions.hh>
@@ -45,6 +46,70 @@ public:
 };
 
 
+/**
+ *  \brief Holds the preconditioner or factorization a solver computed for one matrix, keyed on the options it was
+ *         computed with, so that it can be reused by subsequent calls to apply().
+ *
+ *  The cached object is thrown away whenever the options which influence the setup (the type and everything below
+ *  'preconditioner' or 'smoother') or the matrix backend change. The backend is identified by the handle returned by
+ *  backend_handle() of the matrix, not by its address, which might be reused by a backend allocated after the cached one
+ *  has been freed (e.g., after a copy of the matrix detached from it). Changes to the matrix values can not be detected,
+ *  call invalidate() after modifying the matrix.
+ */
+class SolverCache
+{
+public:
+  /**
+   *  \brief Returns the cached object, creates a new one by calling creator() if none fits.
+   *  \note  The creator has to return a std::shared_ptr< CachedType > and CachedType has to be the same type every time
+   *         the same options are given.
+   */
+  template< class CachedType, class BackendType, class CreatorType >
+  CachedType& get(const std::weak_ptr< const BackendType >& backend,
+                  const Common::ConfigTree& opts,
+                  const CreatorType& creator)
+  {
+    if (!contains(backend, opts)) {
+      cached_ = creator();
+      backend_ = backend;
+      key_ = key(opts);
+    }
+    return *std::static_pointer_cast< CachedType >(cached_);
+  } // ... get(...)
+
+  template< class BackendType >
+  bool contains(const std::weak_ptr< const BackendType >& backend, const Common::ConfigTree& opts) const
+  {
+    // we hold on to the control block of the cached backend, so a different backend can never compare equal to it
+    return cached_
+        && !backend_.expired()
+        && !backend_.owner_before(backend) && !backend.owner_before(backend_)
+        && key_ == key(opts);
+  } // ... contains(...)
+
+  void invalidate()
+  {
+    cached_.reset();
+    backend_.reset();
+    key_.clear();
+  }
+
+private:
+  static std::string key(const Common::ConfigTree& opts)
+  {
+    std::string ret = opts.get< std::string >("type");
+    for (const std::string sub_id : {"preconditioner", "smoother"})
+      if (opts.has_sub(sub_id))
+        ret += "\n[" + sub_id + "]\n" + opts.sub(sub_id).report_string();
+    return ret;
+  } // ... key(...)
+
+  std::weak_ptr< const void > backend_;
+  std::string key_;
+  std::shared_ptr< void > cached_;
+}; // class SolverCache
+
+
 template< class MatrixImp >
 class Solver
 {
@@ -106,6 +171,18 @@ public:
                           "Please include the correct header for your matrix implementation '"
                           << Common::Typename< MatrixType >::value() << "'!");
   }
+
+  /**
+   *  Drops any preconditioner or factorization computed in a previous call to apply(), call this after the values of
+   *  the matrix have changed.
+   */
+  void invalidate() const
+  {
+    DUNE_THROW_COLORFULLY(NotImplemented,
+                          "This is the unspecialized version of LA::Solver< ... >. "
+                          "Please include the correct header for your matrix implementation '"
+                          << Common::Typename< MatrixType >::value() << "'!");
+  }
 }; // class Solver
 
 
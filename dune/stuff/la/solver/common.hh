@@ -94,6 +94,38 @@ public:
     }
   } // ... apply(...)
 
+  void apply(const std::vector< CommonDenseVector< S > >& rhs, std::vector< CommonDenseVector< S > >& solution) const
+  {
+    apply(rhs, solution, options()[0]);
+  }
+
+  void apply(const std::vector< CommonDenseVector< S > >& rhs,
+             std::vector< CommonDenseVector< S > >& solution,
+             const std::string& type) const
+  {
+    apply(rhs, solution, options(type));
+  }
+
+  /**
+   *  \brief Solves the system for several right hand sides.
+   *  \note  The right hand sides are solved for one after another, nothing is shared between them.
+   */
+  void apply(const std::vector< CommonDenseVector< S > >& rhs,
+             std::vector< CommonDenseVector< S > >& solution,
+             const Common::ConfigTree& opts) const
+  {
+    if (solution.size() != rhs.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The number of solutions (" << solution.size()
+                            << ") does not match the number of right hand sides (" << rhs.size() << ")!");
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      apply(rhs[ii], solution[ii], opts);
+  } // ... apply(...)
+
+  /// Nothing is cached by this solver, only present for compatibility with the other solvers.
+  void invalidate() const
+  {}
+
 private:
   const MatrixType& matrix_;
 }; // class Solver< CommonDenseMatrix< ... > >
@@ -11,6 +11,8 @@
 #include <algorithm>
 #include <sstream>
 #include <cmath>
+#include <memory>
+#include <type_traits>
 
 #if HAVE_EIGEN
 # include <dune/stuff/common/disable_warnings.hh>
@@ -50,6 +52,10 @@ namespace LA {
 
 #if HAVE_EIGEN
 
+/**
+ *  \note The decomposition of the matrix is computed in the first call to apply() and reused as long as the type stays
+ *        the same. Call invalidate() after modifying the matrix.
+ */
 template< class S >
 class Solver< EigenDenseMatrix< S > >
   : protected SolverUtils
@@ -110,8 +116,116 @@ public:
     const auto type = opts.get< std::string >("type");
     SolverUtils::check_given(type, options());
     const Common::ConfigTree default_opts = options(type);
-    // check for symmetry (if solver needs it)
-    if (type == "ldlt" || type == "llt") {
+    check_symmetry(type, opts, default_opts);
+    // solve
+    solve(rhs.backend(), solution.backend(), type, opts);
+    // check
+    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
+                                                          default_opts.get< S >("post_check_solves_system"));
+    if (post_check_solves_system_theshhold > 0) {
+      auto tmp = rhs.copy();
+      tmp.backend() = matrix_.backend() * solution.backend() - rhs.backend();
+      const S sup_norm = tmp.sup_norm();
+      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
+        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
+                              "The computed solution does not solve the system (although the eigen backend reported "
+                              << "'Success') and you requested checking (see options below)!\n"
+                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
+                              << "\n\n"
+                              << "  (A * x - b).sup_norm() = " << tmp.sup_norm() << "\n\n"
+                              << "Those were the given options:\n\n"
+                              << opts);
+    }
+  } // ... apply(...)
+
+  /**
+   *  \brief Solves the system for several right hand sides at once, using the same decomposition for all of them.
+   */
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution) const
+  {
+    apply(rhs, solution, options()[0]);
+  }
+
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution, const std::string& type) const
+  {
+    apply(rhs, solution, options(type));
+  }
+
+  /**
+   *  \note copies all right hand sides and solutions into a dense block
+   */
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution, const Common::ConfigTree& opts) const
+  {
+    static_assert(std::is_base_of< EigenBaseVector< typename T1::Traits, S >, T1 >::value,
+                  "T1 has to be derived from EigenBaseVector!");
+    static_assert(std::is_base_of< EigenBaseVector< typename T2::Traits, S >, T2 >::value,
+                  "T2 has to be derived from EigenBaseVector!");
+    if (!opts.has_key("type"))
+      DUNE_THROW_COLORFULLY(Exceptions::configuration_error,
+                            "Given options (see below) need to have at least the key 'type' set!\n\n" << opts);
+    const auto type = opts.get< std::string >("type");
+    SolverUtils::check_given(type, options());
+    const Common::ConfigTree default_opts = options(type);
+    if (solution.size() != rhs.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The number of solutions (" << solution.size()
+                            << ") does not match the number of right hand sides (" << rhs.size() << ")!");
+    if (rhs.empty())
+      return;
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      if (rhs[ii].size() != matrix_.rows() || solution[ii].size() != matrix_.cols())
+        DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                              "The size of rhs[" << ii << "] (" << rhs[ii].size() << ") or solution[" << ii << "] ("
+                              << solution[ii].size() << ") does not match the shape of the matrix ("
+                              << matrix_.rows() << "x" << matrix_.cols() << ")!");
+    check_symmetry(type, opts, default_opts);
+    // solve
+    MultiVectorType rhs_block(matrix_.rows(), rhs.size());
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      rhs_block.col(ii) = rhs[ii].backend();
+    MultiVectorType solution_block(matrix_.cols(), rhs.size());
+    solve(rhs_block, solution_block, type, opts);
+    for (size_t ii = 0; ii < solution.size(); ++ii)
+      solution[ii].backend() = solution_block.col(ii);
+    // check
+    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
+                                                          default_opts.get< S >("post_check_solves_system"));
+    if (post_check_solves_system_theshhold > 0) {
+      const MultiVectorType residual = matrix_.backend() * solution_block - rhs_block;
+      const S sup_norm = residual.cwiseAbs().maxCoeff();
+      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
+        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
+                              "The computed solutions do not solve the system (although the eigen backend reported "
+                              << "'Success') and you requested checking (see options below)!\n"
+                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
+                              << "\n\n"
+                              << "  max_i (A * x_i - b_i).sup_norm() = " << sup_norm << "\n\n"
+                              << "Those were the given options:\n\n"
+                              << opts);
+    }
+  } // ... apply(...)
+
+  /**
+   *  Drops the decomposition computed in a previous call to apply(), call this after the values of the matrix have
+   *  changed.
+   */
+  void invalidate() const
+  {
+    cache_.invalidate();
+  }
+
+private:
+  typedef ::Eigen::Matrix< S, ::Eigen::Dynamic, ::Eigen::Dynamic > MultiVectorType;
+
+  /// Checks for symmetry (if the solver needs it and the matrix was not checked before).
+  void check_symmetry(const std::string& type,
+                      const Common::ConfigTree& opts,
+                      const Common::ConfigTree& default_opts) const
+  {
+    if ((type == "ldlt" || type == "llt") && !cache_.contains(matrix_.backend_handle(), opts)) {
       const S pre_check_symmetry_threshhold = opts.get("pre_check_symmetry",
                                                        default_opts.get< S >("pre_check_symmetry"));
       if (pre_check_symmetry_threshhold > 0) {
@@ -127,49 +241,50 @@ public:
                                 << opts);
       }
     }
-    // solve
+  } // ... check_symmetry(...)
+
+  template< class RhsBackendType, class SolutionBackendType >
+  void solve(const RhsBackendType& rhs_backend,
+             SolutionBackendType& solution_backend,
+             const std::string& type,
+             const Common::ConfigTree& opts) const
+  {
+    typedef typename MatrixType::BackendType BackendType;
     if (type == "qr.colpivhouseholder") {
-      solution.backend() = matrix_.backend().colPivHouseholderQr().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::ColPivHouseholderQR< BackendType > >(opts).solve(rhs_backend);
     } else if (type == "qr.fullpivhouseholder")
-      solution.backend() = matrix_.backend().fullPivHouseholderQr().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::FullPivHouseholderQR< BackendType > >(opts).solve(rhs_backend);
     else if (type == "qr.householder")
-      solution.backend() = matrix_.backend().householderQr().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::HouseholderQR< BackendType > >(opts).solve(rhs_backend);
     else if (type == "lu.fullpiv")
-      solution.backend() = matrix_.backend().fullPivLu().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::FullPivLU< BackendType > >(opts).solve(rhs_backend);
     else if (type == "llt")
-      solution.backend() = matrix_.backend().llt().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::LLT< BackendType > >(opts).solve(rhs_backend);
     else if (type == "ldlt")
-      solution.backend() = matrix_.backend().ldlt().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::LDLT< BackendType > >(opts).solve(rhs_backend);
     else if (type == "lu.partialpiv")
-      solution.backend() = matrix_.backend().partialPivLu().solve(rhs.backend());
+      solution_backend = decomposition< ::Eigen::PartialPivLU< BackendType > >(opts).solve(rhs_backend);
     else
       DUNE_THROW_COLORFULLY(Exceptions::internal_error,
                             "Given type '" << type << "' is not supported, although it was reported by options()!");
-    // check
-    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
-                                                          default_opts.get< S >("post_check_solves_system"));
-    if (post_check_solves_system_theshhold > 0) {
-      auto tmp = rhs.copy();
-      tmp.backend() = matrix_.backend() * solution.backend() - rhs.backend();
-      const S sup_norm = tmp.sup_norm();
-      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
-        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
-                              "The computed solution does not solve the system (although the eigen backend reported "
-                              << "'Success') and you requested checking (see options below)!\n"
-                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
-                              << "\n\n"
-                              << "  (A * x - b).sup_norm() = " << tmp.sup_norm() << "\n\n"
-                              << "Those were the given options:\n\n"
-                              << opts);
-    }
-  } // ... apply(...)
+  } // ... solve(...)
+
+  template< class DecompositionType >
+  const DecompositionType& decomposition(const Common::ConfigTree& opts) const
+  {
+    return cache_.get< DecompositionType >(matrix_.backend_handle(), opts, [&]() {
+      return std::make_shared< DecompositionType >(matrix_.backend());
+    });
+  } // ... decomposition(...)
 
-private:
   const MatrixType& matrix_;
+  mutable SolverCache cache_;
 }; // class Solver
 
 
 /**
+ *  \note The factorization or preconditioner is computed in the first call to apply() and reused as long as the
+ *        options concerning the preconditioner stay the same. Call invalidate() after modifying the matrix.
  *  \note lu.sparse will copy the matrix to column major
  *  \note qr.sparse will copy the matrix to column major
  *  \note ldlt.simplicial will copy the matrix to column major
@@ -263,8 +378,120 @@ public:
     const auto type = opts.get< std::string >("type");
     SolverUtils::check_given(type, options());
     const Common::ConfigTree default_opts = options(type);
-    // check for symmetry (if solver needs it)
-    if (type.substr(0, 3) == "cg." || type == "ldlt.simplicial" || type == "llt.simplicial") {
+    check_symmetry(type, opts, default_opts);
+    const ::Eigen::ComputationInfo info = solve(rhs.backend(), solution.backend(), type, opts, default_opts);
+    check_info(info, opts);
+    // check
+    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
+                                                          default_opts.get< S >("post_check_solves_system"));
+    if (post_check_solves_system_theshhold > 0) {
+      auto tmp = rhs.copy();
+      matrix_.mv(solution, tmp);
+      tmp.backend() -= rhs.backend();
+      const S sup_norm = tmp.sup_norm();
+      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
+        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
+                              "The computed solution does not solve the system (although the eigen backend reported "
+                              << "'Success') and you requested checking (see options below)!\n"
+                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
+                              << "\n\n"
+                              << "  (A * x - b).sup_norm() = " << tmp.sup_norm() << "\n\n"
+                              << "Those were the given options:\n\n"
+                              << opts);
+    }
+  } // ... apply(...)
+
+  /**
+   *  \brief Solves the system for several right hand sides at once, using the same factorization or preconditioner
+   *         for all of them.
+   */
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution) const
+  {
+    apply(rhs, solution, options()[0]);
+  }
+
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution, const std::string& type) const
+  {
+    apply(rhs, solution, options(type));
+  }
+
+  /**
+   *  \note copies all right hand sides and solutions into a dense block
+   */
+  template< class T1, class T2 >
+  void apply(const std::vector< T1 >& rhs, std::vector< T2 >& solution, const Common::ConfigTree& opts) const
+  {
+    static_assert(std::is_base_of< EigenBaseVector< typename T1::Traits, S >, T1 >::value,
+                  "T1 has to be derived from EigenBaseVector!");
+    static_assert(std::is_base_of< EigenBaseVector< typename T2::Traits, S >, T2 >::value,
+                  "T2 has to be derived from EigenBaseVector!");
+    if (!opts.has_key("type"))
+      DUNE_THROW_COLORFULLY(Exceptions::configuration_error,
+                            "Given options (see below) need to have at least the key 'type' set!\n\n" << opts);
+    const auto type = opts.get< std::string >("type");
+    SolverUtils::check_given(type, options());
+    const Common::ConfigTree default_opts = options(type);
+    if (solution.size() != rhs.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The number of solutions (" << solution.size()
+                            << ") does not match the number of right hand sides (" << rhs.size() << ")!");
+    if (rhs.empty())
+      return;
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      if (rhs[ii].size() != matrix_.rows() || solution[ii].size() != matrix_.cols())
+        DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                              "The size of rhs[" << ii << "] (" << rhs[ii].size() << ") or solution[" << ii << "] ("
+                              << solution[ii].size() << ") does not match the shape of the matrix ("
+                              << matrix_.rows() << "x" << matrix_.cols() << ")!");
+    check_symmetry(type, opts, default_opts);
+    // solve
+    MultiVectorType rhs_block(matrix_.rows(), rhs.size());
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      rhs_block.col(ii) = rhs[ii].backend();
+    MultiVectorType solution_block(matrix_.cols(), rhs.size());
+    const ::Eigen::ComputationInfo info = solve(rhs_block, solution_block, type, opts, default_opts);
+    check_info(info, opts);
+    for (size_t ii = 0; ii < solution.size(); ++ii)
+      solution[ii].backend() = solution_block.col(ii);
+    // check
+    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
+                                                          default_opts.get< S >("post_check_solves_system"));
+    if (post_check_solves_system_theshhold > 0) {
+      const MultiVectorType residual = matrix_.backend() * solution_block - rhs_block;
+      const S sup_norm = residual.cwiseAbs().maxCoeff();
+      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
+        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
+                              "The computed solutions do not solve the system (although the eigen backend reported "
+                              << "'Success') and you requested checking (see options below)!\n"
+                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
+                              << "\n\n"
+                              << "  max_i (A * x_i - b_i).sup_norm() = " << sup_norm << "\n\n"
+                              << "Those were the given options:\n\n"
+                              << opts);
+    }
+  } // ... apply(...)
+
+  /**
+   *  Drops the factorization or preconditioner computed in a previous call to apply(), call this after the values of
+   *  the matrix have changed.
+   */
+  void invalidate() const
+  {
+    cache_.invalidate();
+  }
+
+private:
+  typedef ::Eigen::Matrix< S, ::Eigen::Dynamic, ::Eigen::Dynamic > MultiVectorType;
+
+  /// Checks for symmetry (if the solver needs it and the matrix was not checked before).
+  void check_symmetry(const std::string& type,
+                      const Common::ConfigTree& opts,
+                      const Common::ConfigTree& default_opts) const
+  {
+    if ((type.substr(0, 3) == "cg." || type == "ldlt.simplicial" || type == "llt.simplicial")
+        && !cache_.contains(matrix_.backend_handle(), opts)) {
       const S pre_check_symmetry_threshhold = opts.get("pre_check_symmetry",
                                                        default_opts.get< S >("pre_check_symmetry"));
       if (pre_check_symmetry_threshhold > 0) {
@@ -281,111 +508,89 @@ public:
                                 << opts);
       }
     }
+  } // ... check_symmetry(...)
+
+  template< class RhsBackendType, class SolutionBackendType >
+  ::Eigen::ComputationInfo solve(const RhsBackendType& rhs_backend,
+                                 SolutionBackendType& solution_backend,
+                                 const std::string& type,
+                                 const Common::ConfigTree& opts,
+                                 const Common::ConfigTree& default_opts) const
+  {
     ::Eigen::ComputationInfo info;
     if (type == "cg.diagonal.lower") {
       typedef ::Eigen::ConjugateGradient< typename MatrixType::BackendType,
                                           ::Eigen::Lower,
                                           ::Eigen::DiagonalPreconditioner< S > > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "cg.diagonal.upper") {
       typedef ::Eigen::ConjugateGradient< typename MatrixType::BackendType,
                                           ::Eigen::Upper,
                                           ::Eigen::DiagonalPreconditioner< double > > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "cg.identity.lower") {
       typedef ::Eigen::ConjugateGradient< typename MatrixType::BackendType,
                                           ::Eigen::Lower,
                                           ::Eigen::IdentityPreconditioner > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "cg.identity.upper") {
       typedef ::Eigen::ConjugateGradient< typename MatrixType::BackendType,
                                           ::Eigen::Lower,
                                           ::Eigen::IdentityPreconditioner > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "bicgstab.ilut") {
       typedef ::Eigen::BiCGSTAB< typename MatrixType::BackendType, ::Eigen::IncompleteLUT< S > > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solver.preconditioner().setDroptol(opts.get("preconditioner.drop_tol",
+      auto& solver = iterative_solver< SolverType >(opts, default_opts, [&](SolverType& slvr) {
+        slvr.preconditioner().setDroptol(opts.get("preconditioner.drop_tol",
                                                   default_opts.get< S >("preconditioner.drop_tol")));
-      solver.preconditioner().setFillfactor(opts.get("preconditioner.fill_factor",
+        slvr.preconditioner().setFillfactor(opts.get("preconditioner.fill_factor",
                                                      default_opts.get< size_t >("preconditioner.fill_factor")));
-      solution.backend() = solver.solve(rhs.backend());
+      });
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "bicgstab.diagonal") {
       typedef ::Eigen::BiCGSTAB< typename MatrixType::BackendType, ::Eigen::DiagonalPreconditioner< S > > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "bicgstab.identity") {
       typedef ::Eigen::BiCGSTAB< typename MatrixType::BackendType, ::Eigen::IdentityPreconditioner > SolverType;
-      SolverType solver(matrix_.backend());
-      solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
-      solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = iterative_solver< SolverType >(opts, default_opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "lu.sparse") {
-      ColMajorBackendType colmajor_copy(matrix_.backend());
-      colmajor_copy.makeCompressed();
       typedef ::Eigen::SparseLU< ColMajorBackendType > SolverType;
-      SolverType solver;
-      solver.analyzePattern(colmajor_copy);
-      solver.factorize(colmajor_copy);
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, ColMajorBackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "qr.sparse") {
-      ColMajorBackendType colmajor_copy(matrix_.backend());
-      colmajor_copy.makeCompressed();
       typedef ::Eigen::SparseQR< ColMajorBackendType, ::Eigen::COLAMDOrdering< int > > SolverType;
-      SolverType solver;
-      solver.analyzePattern(colmajor_copy);
-      solver.factorize(colmajor_copy);
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, ColMajorBackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "ldlt.simplicial") {
-      ColMajorBackendType colmajor_copy(matrix_.backend());
-      colmajor_copy.makeCompressed();
       typedef ::Eigen::SimplicialLDLT< ColMajorBackendType > SolverType;
-      SolverType solver;
-      solver.analyzePattern(colmajor_copy);
-      solver.factorize(colmajor_copy);
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, ColMajorBackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
     } else if (type == "llt.simplicial") {
-      ColMajorBackendType colmajor_copy(matrix_.backend());
-      colmajor_copy.makeCompressed();
       typedef ::Eigen::SimplicialLLT< ColMajorBackendType > SolverType;
-      SolverType solver;
-      solver.analyzePattern(colmajor_copy);
-      solver.factorize(colmajor_copy);
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, ColMajorBackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
 #if HAVE_UMFPACK
     } else if (type == "lu.umfpack") {
       typedef ::Eigen::UmfPackLU< typename MatrixType::BackendType > SolverType;
-      SolverType solver;
-      solver.analyzePattern(matrix_.backend());
-      solver.factorize(matrix_.backend());
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, typename MatrixType::BackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
 #endif // HAVE_UMFPACK
 //    } else if (type == "spqr") {
@@ -395,7 +600,7 @@ public:
 //      SolverType solver;
 //      solver.analyzePattern(colmajor_copy);
 //      solver.factorize(colmajor_copy);
-//      solution.backend() = solver.solve(rhs.backend());
+//      solution_backend = solver.solve(rhs_backend);
 //      if (solver.info() != ::Eigen::Success)
 //        return solver.info();
 //    } else if (type == "cholmodsupernodalllt") {
@@ -403,22 +608,24 @@ public:
 //      SolverType solver;
 //      solver.analyzePattern(matrix_.backend());
 //      solver.factorize(matrix_.backend());
-//      solution.backend() = solver.solve(rhs.backend());
+//      solution_backend = solver.solve(rhs_backend);
 //      if (solver.info() != ::Eigen::Success)
 //        return solver.info();
 #if HAVE_SUPERLU
     } else if (type == "superlu") {
       typedef ::Eigen::SuperLU< typename MatrixType::BackendType > SolverType;
-      SolverType solver;
-      solver.analyzePattern(matrix_.backend());
-      solver.factorize(matrix_.backend());
-      solution.backend() = solver.solve(rhs.backend());
+      auto& solver = direct_solver< SolverType, typename MatrixType::BackendType >(opts);
+      solution_backend = solver.solve(rhs_backend);
       info = solver.info();
 #endif // HAVE_SUPERLU
     } else
       DUNE_THROW_COLORFULLY(Exceptions::internal_error,
                             "Given type '" << type << "' is not supported, although it was reported by options()!");
-    // handle eigens info
+    return info;
+  } // ... solve(...)
+
+  static void check_info(const ::Eigen::ComputationInfo& info, const Common::ConfigTree& opts)
+  {
     if (info != ::Eigen::Success) {
       if (info == ::Eigen::NumericalIssue)
         DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_matrix_did_not_fulfill_requirements,
@@ -443,27 +650,65 @@ public:
                               "The eigen backend reported an unknown status!\n"
                               << "Please report this to the dune-stuff developers!");
     }
-    // check
-    const S post_check_solves_system_theshhold = opts.get("post_check_solves_system",
-                                                          default_opts.get< S >("post_check_solves_system"));
-    if (post_check_solves_system_theshhold > 0) {
-      auto tmp = rhs.copy();
-      tmp.backend() = matrix_.backend() * solution.backend() - rhs.backend();
-      const S sup_norm = tmp.sup_norm();
-      if (sup_norm > post_check_solves_system_theshhold || std::isnan(sup_norm) || std::isinf(sup_norm))
-        DUNE_THROW_COLORFULLY(Exceptions::linear_solver_failed_bc_the_solution_does_not_solve_the_system,
-                              "The computed solution does not solve the system (although the eigen backend reported "
-                              << "'Success') and you requested checking (see options below)!\n"
-                              << "If you want to disable this check, set 'post_check_solves_system = 0' in the options."
-                              << "\n\n"
-                              << "  (A * x - b).sup_norm() = " << tmp.sup_norm() << "\n\n"
-                              << "Those were the given options:\n\n"
-                              << opts);
-    }
-  } // ... apply(...)
+  } // ... check_info(...)
+
+  template< class SolverType >
+  SolverType& iterative_solver(const Common::ConfigTree& opts, const Common::ConfigTree& default_opts) const
+  {
+    return iterative_solver< SolverType >(opts, default_opts, [](SolverType& /*solver*/) {});
+  }
+
+  /**
+   *  \param setup Is called before the preconditioner is computed, if no matching solver is cached.
+   */
+  template< class SolverType, class SetupType >
+  SolverType& iterative_solver(const Common::ConfigTree& opts,
+                               const Common::ConfigTree& default_opts,
+                               const SetupType& setup) const
+  {
+    auto& solver = cache_.get< SolverType >(matrix_.backend_handle(), opts, [&]() {
+      auto slvr = std::make_shared< SolverType >();
+      setup(*slvr);
+      slvr->compute(matrix_.backend());
+      return slvr;
+    });
+    solver.setMaxIterations(opts.get("max_iter", default_opts.get< std::size_t >("max_iter")));
+    solver.setTolerance(opts.get("precision", default_opts.get< S >("precision")));
+    return solver;
+  } // ... iterative_solver(...)
+
+  /**
+   *  \tparam FactorizedType The matrix type the factorization is computed for, a copy of the matrix is only created if
+   *          this is not the backend type.
+   */
+  template< class SolverType, class FactorizedType >
+  SolverType& direct_solver(const Common::ConfigTree& opts) const
+  {
+    return cache_.get< SolverType >(matrix_.backend_handle(), opts, [&]() {
+      auto slvr = std::make_shared< SolverType >();
+      factorize(*slvr, matrix_.backend(), std::is_same< FactorizedType, typename MatrixType::BackendType >());
+      return slvr;
+    });
+  } // ... direct_solver(...)
+
+  template< class SolverType >
+  static void factorize(SolverType& solver, const typename MatrixType::BackendType& matrix, std::true_type)
+  {
+    solver.analyzePattern(matrix);
+    solver.factorize(matrix);
+  }
+
+  template< class SolverType >
+  static void factorize(SolverType& solver, const typename MatrixType::BackendType& matrix, std::false_type)
+  {
+    ColMajorBackendType colmajor_copy(matrix);
+    colmajor_copy.makeCompressed();
+    solver.analyzePattern(colmajor_copy);
+    solver.factorize(colmajor_copy);
+  }
 
-private:
   const MatrixType& matrix_;
+  mutable SolverCache cache_;
 }; // class Solver
 
 
@@ -8,6 +8,9 @@
 
 #include <type_traits>
 #include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
 
 #if HAVE_DUNE_ISTL
 # include <dune/istl/operators.hh>
@@ -29,6 +32,10 @@ namespace LA {
 #if HAVE_DUNE_ISTL
 
 
+/**
+ *  \note The preconditioner (ILU or the AMG hierarchy) is computed in the first call to apply() and reused as long as
+ *        the options concerning the preconditioner stay the same. Call invalidate() after modifying the matrix.
+ */
 template< class S >
 class Solver< IstlRowMajorSparseMatrix< S > >
   : protected SolverUtils
@@ -36,6 +43,81 @@ class Solver< IstlRowMajorSparseMatrix< S > >
 public:
   typedef IstlRowMajorSparseMatrix< S > MatrixType;
 
+private:
+  typedef typename MatrixType::BackendType          MatrixBackendType;
+  typedef typename IstlDenseVector< S >::BackendType VectorBackendType;
+
+  /**
+   *  Like Dune::MatrixAdapter, but applies the matrix with the threaded products of IstlRowMajorSparseMatrix, which
+   *  dominate the Krylov iterations.
+   */
+  class MatrixOperatorType
+    : public AssembledLinearOperator< MatrixBackendType, VectorBackendType, VectorBackendType >
+  {
+  public:
+    typedef MatrixBackendType matrix_type;
+    typedef VectorBackendType domain_type;
+    typedef VectorBackendType range_type;
+    typedef S                 field_type;
+
+    enum { category = SolverCategory::sequential };
+
+    MatrixOperatorType(const MatrixType& matrix)
+      : matrix_(matrix)
+      , partition_(matrix.row_partition())
+    {}
+
+    virtual void apply(const domain_type& xx, range_type& yy) const
+    {
+      matrix_.mv(xx, yy, partition_);
+    }
+
+    virtual void applyscaleadd(field_type alpha, const domain_type& xx, range_type& yy) const
+    {
+      matrix_.usmv(alpha, xx, yy, partition_);
+    }
+
+    virtual const matrix_type& getmat() const
+    {
+      return matrix_.backend();
+    }
+
+  private:
+    const MatrixType& matrix_;
+    const SparseProducts::RowPartition partition_;
+  }; // class MatrixOperatorType
+
+  class IlutCache
+  {
+    typedef SeqILUn< MatrixBackendType, VectorBackendType, VectorBackendType > PreconditionerType;
+  public:
+    IlutCache(const MatrixType& matrix, const size_t iterations, const S relaxation_factor)
+      : matrix_operator(matrix)
+      , preconditioner(matrix.backend(), iterations, relaxation_factor)
+    {}
+
+    MatrixOperatorType matrix_operator;
+    PreconditionerType preconditioner;
+  }; // class IlutCache
+
+  class AmgCache
+  {
+    typedef SeqILU0< MatrixBackendType, VectorBackendType, VectorBackendType > SmootherType;
+  public:
+    typedef typename Dune::Amg::SmootherTraits< SmootherType >::Arguments SmootherArgs;
+    typedef Dune::Amg::CoarsenCriterion
+        < Dune::Amg::SymmetricCriterion< MatrixBackendType, Dune::Amg::FirstDiagonal > > AmgCriterion;
+
+    AmgCache(const MatrixType& matrix, const AmgCriterion& amg_criterion, const SmootherArgs& smoother_args)
+      : matrix_operator(matrix)
+      , preconditioner(matrix_operator, amg_criterion, smoother_args)
+    {}
+
+    MatrixOperatorType matrix_operator;
+    Dune::Amg::AMG< MatrixOperatorType, VectorBackendType, SmootherType > preconditioner;
+  }; // class AmgCache
+
+public:
   Solver(const MatrixType& matrix)
     : matrix_(matrix)
   {}
@@ -95,21 +177,16 @@ public:
     IstlDenseVector< S > writable_rhs = rhs.copy();
     // solve
     if (type == "bicgstab.ilut") {
-      typedef MatrixAdapter< typename MatrixType::BackendType,
-                             typename IstlDenseVector< S >::BackendType,
-                             typename IstlDenseVector< S >::BackendType > MatrixOperatorType;
-      MatrixOperatorType matrix_operator(matrix_.backend());
-      typedef SeqILUn< typename MatrixType::BackendType,
-                       typename IstlDenseVector< S >::BackendType,
-                       typename IstlDenseVector< S >::BackendType > PreconditionerType;
-      PreconditionerType preconditioner(matrix_.backend(),
-                                        opts.get("preconditioner.iterations",
-                                                 default_opts.get< size_t >("preconditioner.iterations")),
-                                        opts.get("preconditioner.relaxation_factor",
-                                                 default_opts.get< S >("preconditioner.relaxation_factor")));
-      typedef BiCGSTABSolver< typename IstlDenseVector< S >::BackendType > SolverType;
-      SolverType solver(matrix_operator,
-                        preconditioner,
+      auto& cache = cache_.get< IlutCache >(matrix_.backend_handle(), opts, [&]() {
+        return std::make_shared< IlutCache >(matrix_,
+                                             opts.get("preconditioner.iterations",
+                                                      default_opts.get< size_t >("preconditioner.iterations")),
+                                             opts.get("preconditioner.relaxation_factor",
+                                                      default_opts.get< S >("preconditioner.relaxation_factor")));
+      });
+      typedef BiCGSTABSolver< VectorBackendType > SolverType;
+      SolverType solver(cache.matrix_operator,
+                        cache.preconditioner,
                         opts.get("precision", default_opts.get< S >("precision")),
                         opts.get("max_iter", default_opts.get< size_t >("max_iter")),
                         opts.get("verbose", default_opts.get< int >("verbose")));
@@ -121,39 +198,28 @@ public:
                               << "Those were the given options:\n\n"
                               << opts);
     } else if (type == "bicgstab.amg.ilu0") {
-      typedef MatrixAdapter< typename MatrixType::BackendType,
-                             typename IstlDenseVector< S >::BackendType,
-                             typename IstlDenseVector< S >::BackendType > MatrixOperatorType;
-      MatrixOperatorType matrix_operator(matrix_.backend());
-      typedef SeqILU0< typename MatrixType::BackendType,
-                       typename IstlDenseVector< S >::BackendType,
-                       typename IstlDenseVector< S >::BackendType > PreconditionerType;
-      typedef Dune::Amg::AMG< MatrixOperatorType,
-                              typename IstlDenseVector< S >::BackendType,
-                              PreconditionerType > SmootherType;
-      Dune::SeqScalarProduct< typename IstlDenseVector< S >::BackendType > scalar_product;
-      typedef typename Dune::Amg::SmootherTraits< PreconditionerType >::Arguments SmootherArgs;
-      SmootherArgs smootherArgs;
-      smootherArgs.iterations = opts.get("smoother.iterations", default_opts.get< size_t >("smoother.iterations"));
-      smootherArgs.relaxationFactor = opts.get("smoother.relaxation_factor",
-                                               default_opts.get< S >("smoother.relaxation_factor"));
-      Dune::Amg::Parameters params(opts.get("smoother.max_level", default_opts.get< size_t >("smoother.max_level")),
-                                   opts.get("smoother.coarse_target",
-                                            default_opts.get< size_t >("smoother.coarse_target")),
-                                   opts.get("smoother.min_coarse_rate",
-                                            default_opts.get< S >("smoother.min_coarse_rate")),
-                                   opts.get("smoother.prolong_damp", default_opts.get< S >("smoother.prolong_damp")));
-      params.setDefaultValuesAnisotropic(opts.get("smoother.anisotropy_dim",
-                                                  default_opts.get< size_t >("smoother.anisotropy_dim"))); // <- dim
-      typedef Dune::Amg::CoarsenCriterion
-          < Dune::Amg::SymmetricCriterion< typename MatrixType::BackendType, Dune::Amg::FirstDiagonal > > AmgCriterion;
-      AmgCriterion amg_criterion(params);
-      amg_criterion.setDebugLevel(opts.get("smoother.verbose", default_opts.get< size_t >("smoother.verbose")));
-      SmootherType smoother(matrix_operator, amg_criterion, smootherArgs);
-      typedef BiCGSTABSolver< typename IstlDenseVector< S >::BackendType > SolverType;
-      SolverType solver(matrix_operator,
+      auto& cache = cache_.get< AmgCache >(matrix_.backend_handle(), opts, [&]() {
+        typename AmgCache::SmootherArgs smootherArgs;
+        smootherArgs.iterations = opts.get("smoother.iterations", default_opts.get< size_t >("smoother.iterations"));
+        smootherArgs.relaxationFactor = opts.get("smoother.relaxation_factor",
+                                                 default_opts.get< S >("smoother.relaxation_factor"));
+        Dune::Amg::Parameters params(opts.get("smoother.max_level", default_opts.get< size_t >("smoother.max_level")),
+                                     opts.get("smoother.coarse_target",
+                                              default_opts.get< size_t >("smoother.coarse_target")),
+                                     opts.get("smoother.min_coarse_rate",
+                                              default_opts.get< S >("smoother.min_coarse_rate")),
+                                     opts.get("smoother.prolong_damp", default_opts.get< S >("smoother.prolong_damp")));
+        params.setDefaultValuesAnisotropic(opts.get("smoother.anisotropy_dim",
+                                                    default_opts.get< size_t >("smoother.anisotropy_dim"))); // <- dim
+        typename AmgCache::AmgCriterion amg_criterion(params);
+        amg_criterion.setDebugLevel(opts.get("smoother.verbose", default_opts.get< size_t >("smoother.verbose")));
+        return std::make_shared< AmgCache >(matrix_, amg_criterion, smootherArgs);
+      });
+      Dune::SeqScalarProduct< VectorBackendType > scalar_product;
+      typedef BiCGSTABSolver< VectorBackendType > SolverType;
+      SolverType solver(cache.matrix_operator,
                         scalar_product,
-                        smoother,
+                        cache.preconditioner,
                         opts.get("precision", default_opts.get< S >("precision")),
                         opts.get("max_iter", default_opts.get< size_t >("max_iter")),
                         opts.get("verbose", default_opts.get< size_t >("verbose")));
@@ -186,8 +252,47 @@ public:
     }
   } // ... apply(...)
 
+  void apply(const std::vector< IstlDenseVector< S > >& rhs, std::vector< IstlDenseVector< S > >& solution) const
+  {
+    apply(rhs, solution, options()[0]);
+  }
+
+  void apply(const std::vector< IstlDenseVector< S > >& rhs,
+             std::vector< IstlDenseVector< S > >& solution,
+             const std::string& type) const
+  {
+    apply(rhs, solution, options(type));
+  }
+
+  /**
+   *  \brief Solves the system for several right hand sides, using the same preconditioner for all of them.
+   *  \note  dune-istl does not provide block Krylov methods, so the right hand sides are solved for one after another.
+   *         Only the setup of the preconditioner is shared.
+   */
+  void apply(const std::vector< IstlDenseVector< S > >& rhs,
+             std::vector< IstlDenseVector< S > >& solution,
+             const Common::ConfigTree& opts) const
+  {
+    if (solution.size() != rhs.size())
+      DUNE_THROW_COLORFULLY(Exceptions::shapes_do_not_match,
+                            "The number of solutions (" << solution.size()
+                            << ") does not match the number of right hand sides (" << rhs.size() << ")!");
+    for (size_t ii = 0; ii < rhs.size(); ++ii)
+      apply(rhs[ii], solution[ii], opts);
+  } // ... apply(...)
+
+  /**
+   *  Drops the preconditioner computed in a previous call to apply(), call this after the values of the matrix have
+   *  changed.
+   */
+  void invalidate() const
+  {
+    cache_.invalidate();
+  }
+
 private:
   const MatrixType& matrix_;
+  mutable SolverCache cache_;
 }; // class Solver
 
 
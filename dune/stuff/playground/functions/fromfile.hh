@@ -8,6 +8,7 @@
 #ifndef DUNE_STUFF_FUNCTION_FROMFILE_HH
 #define DUNE_STUFF_FUNCTION_FROMFILE_HH
 
+#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <memory>
@@ -19,7 +20,9 @@
 #include <dune/stuff/common/string.hh>
 #include <dune/stuff/common/logging.hh>
 
-#include "interfaces.hh"
+#include <dune/stuff/functions/interfaces.hh>
+
+#include "fromfile/voxelindexer.hh"
 
 
 namespace Dune {
@@ -52,13 +55,17 @@ public:
                    const std::vector< size_t >& _numElements,
                    const std::string _name = static_id(),
                    const int _order = 0,
-                   std::ostream& out = Dune::Stuff::Common::Logger().devnull())
+                   std::ostream& out = Dune::Stuff::Common::Logger().devnull(),
+                   const bool use_cache = false,
+                   const VoxelInterpolation interpolation = VoxelInterpolation::piecewise_constant)
     : filename_(_filename)
     , lowerLeft_(_lowerLeft)
     , upperRight_(_upperRight)
     , numElements_(_numElements)
     , name_(_name)
     , order_(_order)
+    , interpolation_(interpolation)
+    , indexer_(lowerLeft_, upperRight_, numElements_)
   {
     // sanity checks
     std::stringstream msg;
@@ -78,44 +85,12 @@ public:
     }
 
     // read all the data (functionvalues per voxel) from the file
-    std::ifstream datafile(filename_);
-    if (datafile.is_open()) {
-      // geht das ganze so nur, wenn das ascii_==true ist? ascii_ benutze ich bisher noch nicht!
-      std::string line;
-      int numberOfVoxels = 0;
-      const int dim = rangeDimCols*rangeDimRows;
-      RangeType values;
-
-      out << "Reading " << filename_ << " ...   " << std::flush;
-      while(std::getline(datafile,line))
-      {
-        numberOfVoxels++;
-        const std::vector<double> items = Dune::Stuff::Common::tokenize<double>(line, " ");
-        if (items.size() != dimDomain + dim)
-          DUNE_THROW(Dune::IOError,
-                     "Error: " << items.size() << " = items.size() != dimDomain + rangeDimCols*rangeDimRows = " << dimDomain + dim << "!");
-        for (unsigned int ii = 0; ii < dimDomain; ++ii){
-          // the numbering of the voxels starts with 1
-          if (!( (1 <= items[ii]) && (items[ii] <= numElements_[ii]) ))
-            DUNE_THROW(Dune::IOError,
-                       "Error: " << ii << ". index of the voxel (" << items[ii]
-                       << ") does not lie between 1 and numElements[" << ii << "] ("
-                       << numElements_[ii] << ") !");
-        }
-        for (unsigned int ii = 0; ii < rangeDimRows; ++ii){
-          for (unsigned int jj = 0; jj < rangeDimCols; ++jj){
-            DUNE_THROW(InvalidStateException, "assignment below doesn't compile");
-//            values[ii][jj] = items[dimDomain + jj + rangeDimCols*ii];
-          }
-        }
-        data_.push_back(values);
-      }
-      out << "done: function values for " << numberOfVoxels << " voxels read." << std::endl;
-    } else { // if (datafile)
+    if (!std::ifstream(filename_).is_open()) {
       ++throw_up;
       msg << "\n" << Dune::Stuff::Common::colorStringRed("ERROR:")
           << " could not open '" << filename_ << "'!";
-    } // if (datafile)
+    } else if (!throw_up)
+      data_ = std::make_shared< const VoxelData >(filename_, numElements_, rangeDimCols*rangeDimRows, use_cache, out);
     // throw up, if needed
     if (throw_up)
       DUNE_THROW(Dune::RangeError, msg.str());
@@ -146,33 +121,13 @@ public:
     return order_;
   }
 
-  virtual void evaluate(const DomainType& x, RangeType& ret) const
-  {
-    // decide on the voxel x belongs to
-    Dune::FieldVector< size_t, dimDomain > voxel;
-    for (size_t ii=0; ii < dimDomain; ++ii){
-      voxel[ii] = std::floor(numElements_[ii]*( (x[ii] - lowerLeft_[ii])/(upperRight_[ii] - lowerLeft_[ii]) ));
-      if (!( (0 <= voxel[ii]) && (voxel[ii] < numElements_[ii]) ))
-        DUNE_THROW(Dune::RangeError,
-                   "Error: " << ii << ". index of the voxel (" << voxel[ii]
-                   << ") does not lie between 0 and numElements[" << ii << "]-1 ("
-                   << numElements_[ii]-1 << ") !");
-    }
-    int index;
-    if (dimDomain == 1){
-      index = voxel[0];
-    }
-    else if ( dimDomain==2 ){
-      index = voxel[1] + voxel[0]*numElements_[1];
-    }
-    else if ( dimDomain==3 ){
-      index = voxel[2] + voxel[1]*numElements_[2] + voxel[0]*numElements_[1]*numElements_[2];
-    }
-    else {
-      DUNE_THROW(Dune::RangeError, "evaluate() does not support dimDomains other than 1,2 or 3!");
-    }
+  using BaseType::evaluate;
 
-    ret = data_[index];
+  virtual void evaluate(const DomainType& /*x*/, RangeType& /*ret*/) const
+  {
+    // the values of each voxel are stored row by row, i.e. ret[ii][jj] = values[jj + rangeDimCols*ii], but RangeType
+    // is a vector, so there is nothing to look up
+    DUNE_THROW(InvalidStateException, "matrix valued functions are not supported by FunctionInterface!");
   } // virtual void evaluate(const DomainType& x, RangeType& ret) const
 
 private:
@@ -182,7 +137,9 @@ private:
   const std::vector< size_t > numElements_;
   const std::string name_;
   const int order_;
-  std::vector< RangeType > data_;
+  const VoxelInterpolation interpolation_;
+  const VoxelIndexer< DomainFieldType, dimDomain > indexer_;
+  std::shared_ptr< const VoxelData > data_;
 }; // class FunctionFromFile
 
 
@@ -213,13 +170,17 @@ public:
                    const std::vector< size_t >& _numElements,
                    const std::string _name = static_id(),
                    const int _order = 0,
-                   std::ostream& out = Dune::Stuff::Common::Logger().devnull())
+                   std::ostream& out = Dune::Stuff::Common::Logger().devnull(),
+                   const bool use_cache = false,
+                   const VoxelInterpolation interpolation = VoxelInterpolation::piecewise_constant)
     : filename_(_filename)
     , lowerLeft_(_lowerLeft)
     , upperRight_(_upperRight)
     , numElements_(_numElements)
     , name_(_name)
     , order_(_order)
+    , interpolation_(interpolation)
+    , indexer_(lowerLeft_, upperRight_, numElements_)
   {
     // sanity checks
     std::stringstream msg;
@@ -239,38 +200,12 @@ public:
     }
 
     // read all the data (functionvalues per voxel) from the file
-    std::ifstream datafile(filename_);
-    if (datafile.is_open()) {
-      // geht das ganze so nur, wenn das ascii_==true ist? ascii_ benutze ich bisher noch nicht!
-      std::string line;
-      int numberOfVoxels = 0;
-      RangeType value;
-
-      out << "Reading " << filename_ << " ...   " << std::flush;
-      while(std::getline(datafile,line))
-      {
-        numberOfVoxels++;
-        const std::vector<double> items = Dune::Stuff::Common::tokenize<double>(line, " ");
-        if (items.size() != dimDomain + 1)
-          DUNE_THROW(Dune::IOError,
-                     "Error: " << items.size() << " = items.size() != dimDomain + 1 = " << dimDomain + 1 << "!");
-        for (unsigned int ii = 0; ii < dimDomain; ++ii){
-          // the numbering of the voxels starts with 1
-          if (!( (1 <= items[ii]) && (items[ii] <= numElements_[ii]) ))
-            DUNE_THROW(Dune::IOError,
-                       "Error: " << ii << ". index of the voxel (" << items[ii]
-                       << ") does not lie between 1 and numElements[" << ii << "] ("
-                       << numElements_[ii] << ") !");
-        }
-        value = items[dimDomain];
-        data_.push_back(value);
-      }
-      out << "done: function values for " << numberOfVoxels << " voxels read." << std::endl;
-    } else { // if (datafile)
+    if (!std::ifstream(filename_).is_open()) {
       ++throw_up;
       msg << "\n" << Dune::Stuff::Common::colorStringRed("ERROR:")
           << " could not open '" << filename_ << "'!";
-    } // if (datafile)
+    } else if (!throw_up)
+      data_ = std::make_shared< const VoxelData >(filename_, numElements_, 1, use_cache, out);
     // throw up, if needed
     if (throw_up)
       DUNE_THROW(Dune::RangeError, msg.str());
@@ -301,35 +236,26 @@ public:
     return order_;
   }
 
+  using BaseType::evaluate;
+
   virtual void evaluate(const DomainType& x, RangeType& ret) const
   {
-    // decide on the voxel x belongs to
-    Dune::FieldVector< size_t, dimDomain > voxel;
-    for (size_t ii=0; ii < dimDomain; ++ii){
-      voxel[ii] = std::floor(numElements_[ii]*( (x[ii] - lowerLeft_[ii])/(upperRight_[ii] - lowerLeft_[ii]) ));
-      if (!( (0 <= voxel[ii]) && (voxel[ii] < numElements_[ii]) ))
-        DUNE_THROW(Dune::RangeError,
-                   "Error: " << ii << ". index of the voxel (" << voxel[ii]
-                   << ") does not lie between 0 and numElements[" << ii << "]-1 ("
-                   << numElements_[ii]-1 << ") !");
-    }
-    int index;
-    if (dimDomain == 1){
-      index = voxel[0];
-    }
-    else if ( dimDomain==2 ){
-      index = voxel[1] + voxel[0]*numElements_[1];
-    }
-    else if ( dimDomain==3 ){
-      index = voxel[2] + voxel[1]*numElements_[2] + voxel[0]*numElements_[1]*numElements_[2];
-    }
-    else {
-      DUNE_THROW(Dune::RangeError, "evaluate() does not support dimDomains other than 1,2 or 3!");
-    }
-
-    ret = data_[index];
+    double values[1];
+    indexer_.evaluate(x, *data_, interpolation_, values);
+    ret = values[0];
   } // virtual void evaluate(const DomainType& x, RangeType& ret) const
 
+  //! evaluates at all points of xs, without a virtual call per point
+  virtual void evaluate(const std::vector< DomainType >& xs, std::vector< RangeType >& ret) const DS_OVERRIDE
+  {
+    ret.resize(xs.size());
+    double values[1];
+    for (size_t pp = 0; pp < xs.size(); ++pp) {
+      indexer_.evaluate(xs[pp], *data_, interpolation_, values);
+      ret[pp] = values[0];
+    }
+  } // ... evaluate(...)
+
 private:
   const std::string filename_;
   const DomainType lowerLeft_;
@@ -337,7 +263,9 @@ private:
   const std::vector< size_t > numElements_;
   const std::string name_;
   const int order_;
-  std::vector< RangeType > data_;
+  const VoxelInterpolation interpolation_;
+  const VoxelIndexer< DomainFieldType, dimDomain > indexer_;
+  std::shared_ptr< const VoxelData > data_;
 }; // class FunctionFromFile< ..., 1, 1 >
 
 
@@ -369,13 +297,17 @@ public:
                    const std::vector< size_t >& _numElements,
                    const std::string _name = id(),
                    const int _order = 0,
-                   std::ostream& out = Dune::Stuff::Common::Logger().devnull())
+                   std::ostream& out = Dune::Stuff::Common::Logger().devnull(),
+                   const bool use_cache = false,
+                   const VoxelInterpolation interpolation = VoxelInterpolation::piecewise_constant)
     : filename_(_filename)
     , lowerLeft_(_lowerLeft)
     , upperRight_(_upperRight)
     , numElements_(_numElements)
     , name_(_name)
     , order_(_order)
+    , interpolation_(interpolation)
+    , indexer_(lowerLeft_, upperRight_, numElements_)
   {
     // sanity checks
     std::stringstream msg;
@@ -395,40 +327,12 @@ public:
     }
 
     // read all the data (functionvalues per voxel) from the file
-    std::ifstream datafile(filename_);
-    if (datafile.is_open()) {
-      // geht das ganze so nur, wenn das ascii_==true ist? ascii_ benutze ich bisher noch nicht!
-      std::string line;
-      int numberOfVoxels = 0;
-      RangeType values;
-
-      out << "Reading " << filename_ << " ...   " << std::flush;
-      while(std::getline(datafile,line))
-      {
-        numberOfVoxels++;
-        const std::vector<double> items = Dune::Stuff::Common::tokenize<double>(line, " ");
-        if (items.size() != rangeDimRows + dimDomain)
-          DUNE_THROW(Dune::IOError,
-                     "Error: " << items.size() << " = items.size() != rangeDimRows + dimDomain = " << rangeDimRows + dimDomain << "!");
-        for (unsigned int ii = 0; ii < dimDomain; ++ii){
-          // the numbering of the voxels starts with 1
-          if (!( (1 <= items[ii]) && (items[ii] <= numElements_[ii]) ))
-            DUNE_THROW(Dune::IOError,
-                       "Error: " << ii << ". index of the voxel (" << items[ii]
-                       << ") does not lie between 1 and numElements[" << ii << "] ("
-                       << numElements_[ii] << ") !");
-        }
-        for (unsigned int ii = 0; ii < rangeDimRows; ++ii){
-          values[ii] = items[dimDomain + ii];
-        }
-        data_.push_back(values);
-      }
-      out << "done: function values for " << numberOfVoxels << " voxels read." << std::endl;
-    } else { // if (datafile)
+    if (!std::ifstream(filename_).is_open()) {
       ++throw_up;
       msg << "\n" << Dune::Stuff::Common::colorStringRed("ERROR:")
           << " could not open '" << filename_ << "'!";
-    } // if (datafile)
+    } else if (!throw_up)
+      data_ = std::make_shared< const VoxelData >(filename_, numElements_, rangeDimRows, use_cache, out);
     // throw up, if needed
     if (throw_up)
       DUNE_THROW(Dune::RangeError, msg.str());
@@ -459,35 +363,28 @@ public:
     return order_;
   }
 
+  using BaseType::evaluate;
+
   virtual void evaluate(const DomainType& x, RangeType& ret) const
   {
-    // decide on the voxel x belongs to
-    Dune::FieldVector< size_t, dimDomain > voxel;
-    for (size_t ii=0; ii < dimDomain; ++ii){
-      voxel[ii] = std::floor(numElements_[ii]*( (x[ii] - lowerLeft_[ii])/(upperRight_[ii] - lowerLeft_[ii]) ));
-      if (!( (0 <= voxel[ii]) && (voxel[ii] < numElements_[ii]) ))
-        DUNE_THROW(Dune::RangeError,
-                   "Error: " << ii << ". index of the voxel (" << voxel[ii]
-                   << ") does not lie between 0 and numElements[" << ii << "]-1 ("
-                   << numElements_[ii]-1 << ") !");
-    }
-    int index;
-    if (dimDomain == 1){
-      index = voxel[0];
-    }
-    else if ( dimDomain==2 ){
-      index = voxel[1] + voxel[0]*numElements_[1];
-    }
-    else if ( dimDomain==3 ){
-      index = voxel[2] + voxel[1]*numElements_[2] + voxel[0]*numElements_[1]*numElements_[2];
-    }
-    else {
-      DUNE_THROW(Dune::RangeError, "evaluate() does not support dimDomains other than 1,2 or 3!");
-    }
-
-    ret = data_[index];
+    double values[rangeDimRows];
+    indexer_.evaluate(x, *data_, interpolation_, values);
+    for (unsigned int ii = 0; ii < rangeDimRows; ++ii)
+      ret[ii] = values[ii];
   } // virtual void evaluate(const DomainType& x, RangeType& ret) const
 
+  //! evaluates at all points of xs, without a virtual call per point
+  virtual void evaluate(const std::vector< DomainType >& xs, std::vector< RangeType >& ret) const DS_OVERRIDE
+  {
+    ret.resize(xs.size());
+    double values[rangeDimRows];
+    for (size_t pp = 0; pp < xs.size(); ++pp) {
+      indexer_.evaluate(xs[pp], *data_, interpolation_, values);
+      for (unsigned int ii = 0; ii < rangeDimRows; ++ii)
+        ret[pp][ii] = values[ii];
+    }
+  } // ... evaluate(...)
+
 private:
   const std::string filename_;
   const DomainType lowerLeft_;
@@ -495,7 +392,9 @@ private:
   const std::vector< size_t > numElements_;
   const std::string name_;
   const int order_;
-  std::vector< RangeType > data_;
+  const VoxelInterpolation interpolation_;
+  const VoxelIndexer< DomainFieldType, dimDomain > indexer_;
+  std::shared_ptr< const VoxelData > data_;
 }; // class FunctionFromFile< ..., 1>
 
 
@@ -0,0 +1,388 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_FUNCTION_FROMFILE_VOXELDATA_HH
+#define DUNE_STUFF_FUNCTION_FROMFILE_VOXELDATA_HH
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune {
+namespace Stuff {
+
+
+/**
+ *  \brief The values of a voxel dataset as used by FunctionFromFile.
+ *
+ *  The text files contain one line per voxel, holding the (1-based) index of the voxel in each direction followed by
+ *  the values of the voxel, separated by spaces or tabs. The file is mapped into memory and scanned in place, so no
+ *  line or token is copied. The values are stored voxel by voxel, the voxels ordered with the last direction running
+ *  fastest (which is the usual order of the files, but the lines may come in any order).
+ *
+ *  If a cache is requested, the values are written next to the text file (see cache_filename()) after parsing. All
+ *  subsequent loads with the same text file (same size and modification time) and layout map that binary file read
+ *  only instead of parsing, which is instantaneous and shares the pages between processes. The cache layout (in native
+ *  byte order) is
+ *  \code
+ * char[8]   "DSVOXEL\n"
+ * uint32    format version (1)
+ * uint32    byte order mark (0x01020304)
+ * uint64    size of the text file
+ * int64     modification time of the text file
+ * uint64    number of values per voxel
+ * uint64    dimDomain
+ * uint64[]  numElements, dimDomain entries
+ * double[]  the values, as described above
+ *  \endcode
+ */
+class VoxelData
+{
+  static const std::uint32_t cache_version = 1;
+  static const std::uint32_t byte_order_mark = 0x01020304;
+
+  struct CacheHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::uint64_t source_size;
+    std::int64_t source_time;
+    std::uint64_t num_values;
+    std::uint64_t dim_domain;
+  }; // struct CacheHeader
+
+  // the header is compared bytewise, so it must not contain padding
+  static_assert(sizeof(CacheHeader) == 48, "");
+
+public:
+  /**
+   * \param numElements the number of voxels in each direction
+   * \param num_values  the number of values per voxel
+   * \param use_cache   read and write the binary cache, see cache_filename()
+   */
+  VoxelData(const std::string& filename,
+            const std::vector< size_t >& numElements,
+            const size_t num_values,
+            const bool use_cache = false,
+            std::ostream& out = std::cout)
+    : numElements_(numElements)
+    , num_values_(num_values)
+    , num_voxels_(1)
+    , values_(nullptr)
+  {
+    for (const size_t& elements : numElements_)
+      num_voxels_ *= elements;
+    if (use_cache && map_cache(filename)) {
+      out << "Mapped the cached values of " << filename << " for " << num_voxels_ << " voxels." << std::endl;
+      return;
+    }
+    out << "Reading " << filename << " ...   " << std::flush;
+    parse(filename);
+    out << "done: function values for " << num_voxels_ << " voxels read." << std::endl;
+    if (use_cache)
+      write_cache(filename, out);
+  } // VoxelData(...)
+
+  VoxelData(const VoxelData& /*other*/) = delete;
+
+  VoxelData& operator=(const VoxelData& /*other*/) = delete;
+
+  static std::string cache_filename(const std::string& filename)
+  {
+    return filename + ".dsvoxel";
+  }
+
+  const std::vector< size_t >& numElements() const
+  {
+    return numElements_;
+  }
+
+  size_t num_voxels() const
+  {
+    return num_voxels_;
+  }
+
+  size_t num_values() const
+  {
+    return num_values_;
+  }
+
+  //! \return true, if the values are mapped from the cache
+  bool mapped() const
+  {
+    return region_ != nullptr;
+  }
+
+  //! \return the num_values() values of the ii-th voxel
+  const double* values(const size_t ii) const
+  {
+    assert(ii < num_voxels_);
+    return values_ + ii*num_values_;
+  }
+
+private:
+  static bool is_space(const char cc)
+  {
+    return cc == ' ' || cc == '\t' || cc == '\r';
+  }
+
+  static bool is_delimiter(const char* it, const char* end)
+  {
+    return it == end || is_space(*it) || *it == '\n';
+  }
+
+  /**
+   *  Scans a number in [it, end). If the decimal mantissa (all digits, without the dot) is at most 2^53 and the decimal
+   *  exponent at most 22 in magnitude, both are exactly representable as doubles, so a single multiplication or
+   *  division yields the correctly rounded value. Everything else (larger mantissas, large exponents, inf, nan, hex) is
+   *  given to strtod.
+   *  \return the end of the number, nullptr if there is none
+   */
+  static const char* scan(const char* it, const char* end, double& value)
+  {
+    static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* const begin = it;
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+'))
+      negative = (*it++ == '-');
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any_digit = false;
+    bool truncated = false;
+    bool after_dot = false;
+    for (; it != end; ++it) {
+      if (*it == '.' && !after_dot) {
+        after_dot = true;
+        continue;
+      }
+      if (*it < '0' || *it > '9')
+        break;
+      any_digit = true;
+      if (digits < 19) {
+        mantissa = 10*mantissa + std::uint64_t(*it - '0');
+        if (mantissa != 0)
+          ++digits;
+        if (after_dot)
+          --exponent;
+      } else {
+        truncated = true;
+        if (!after_dot)
+          ++exponent;
+      }
+    }
+    if (any_digit && it != end && (*it == 'e' || *it == 'E')) {
+      const char* exp_it = it + 1;
+      bool negative_exponent = false;
+      if (exp_it != end && (*exp_it == '-' || *exp_it == '+'))
+        negative_exponent = (*exp_it++ == '-');
+      int exp_value = 0;
+      bool any_exp_digit = false;
+      for (; exp_it != end && *exp_it >= '0' && *exp_it <= '9'; ++exp_it) {
+        any_exp_digit = true;
+        if (exp_value < 100000)
+          exp_value = 10*exp_value + (*exp_it - '0');
+      }
+      if (any_exp_digit) {
+        exponent += negative_exponent ? -exp_value : exp_value;
+        it = exp_it;
+      }
+    }
+    if (any_digit && !truncated && is_delimiter(it, end) && mantissa <= (std::uint64_t(1) << 53)
+        && exponent >= -22 && exponent <= 22) {
+      value = double(mantissa);
+      value = (exponent < 0) ? value/powers_of_ten[-exponent] : value*powers_of_ten[exponent];
+      if (negative)
+        value = -value;
+      return it;
+    }
+    // the mapped file is not null terminated, so copy the token for strtod
+    const char* token_end = begin;
+    while (!is_delimiter(token_end, end))
+      ++token_end;
+    if (token_end == begin)
+      return nullptr;
+    const std::string token(begin, token_end);
+    char* parsed_end = nullptr;
+    value = std::strtod(token.c_str(), &parsed_end);
+    if (parsed_end != token.c_str() + token.size())
+      return nullptr;
+    return token_end;
+  } // ... scan(...)
+
+  void parse(const std::string& filename)
+  {
+    namespace bip = boost::interprocess;
+    if (!boost::filesystem::exists(filename))
+      DUNE_THROW(Dune::IOError, "could not open '" << filename << "'!");
+    owned_values_.assign(num_voxels_*num_values_, 0.0);
+    values_ = owned_values_.data();
+    if (num_voxels_ == 0)
+      return;
+    const size_t size = boost::filesystem::file_size(filename);
+    std::unique_ptr< bip::file_mapping > file;
+    std::unique_ptr< bip::mapped_region > region;
+    const char* it = nullptr;
+    if (size > 0) {
+      file.reset(new bip::file_mapping(filename.c_str(), bip::read_only));
+      region.reset(new bip::mapped_region(*file, bip::read_only));
+      it = static_cast< const char* >(region->get_address());
+    }
+    const char* const end = it + size;
+    const size_t dim_domain = numElements_.size();
+    const size_t items_per_line = dim_domain + num_values_;
+    std::vector< bool > read(num_voxels_, false);
+    size_t line = 0;
+    size_t num_read = 0;
+    while (it != end) {
+      ++line;
+      size_t voxel = 0;
+      size_t items = 0;
+      double value;
+      while (true) {
+        while (it != end && is_space(*it))
+          ++it;
+        if (it == end || *it == '\n')
+          break;
+        const char* next = scan(it, end, value);
+        if (next == nullptr) {
+          next = it;
+          while (!is_delimiter(next, end))
+            ++next;
+          DUNE_THROW(Dune::IOError,
+                     "Error in line " << line << " of '" << filename << "': could not parse '"
+                     << std::string(it, next) << "' as a number!");
+        }
+        it = next;
+        if (items < dim_domain) {
+          // the numbering of the voxels starts with 1
+          if (!((1 <= value) && (value <= numElements_[items]) && (value == std::floor(value))))
+            DUNE_THROW(Dune::IOError,
+                       "Error in line " << line << ": " << items << ". index of the voxel (" << value
+                       << ") does not lie between 1 and numElements[" << items << "] ("
+                       << numElements_[items] << ") !");
+          voxel = voxel*numElements_[items] + size_t(value) - 1;
+        } else if (items < items_per_line)
+          owned_values_[voxel*num_values_ + items - dim_domain] = value;
+        ++items;
+      }
+      if (it != end)
+        ++it; // the '\n'
+      if (items == 0)
+        continue;
+      if (items != items_per_line)
+        DUNE_THROW(Dune::IOError,
+                   "Error in line " << line << ": " << items << " = items.size() != dimDomain + number of values = "
+                   << items_per_line << "!");
+      if (read[voxel])
+        DUNE_THROW(Dune::IOError, "Error in line " << line << ": the voxel was already given before!");
+      read[voxel] = true;
+      ++num_read;
+    }
+    if (num_read != num_voxels_)
+      DUNE_THROW(Dune::IOError,
+                 "'" << filename << "' contains " << num_read << " voxels, expected " << num_voxels_ << "!");
+  } // ... parse(...)
+
+  CacheHeader cache_header(const std::string& filename) const
+  {
+    CacheHeader header;
+    std::memcpy(header.magic, "DSVOXEL\n", 8);
+    header.version = cache_version;
+    header.byte_order_mark = byte_order_mark;
+    header.source_size = boost::filesystem::file_size(filename);
+    header.source_time = boost::filesystem::last_write_time(filename);
+    header.num_values = num_values_;
+    header.dim_domain = numElements_.size();
+    return header;
+  } // ... cache_header(...)
+
+  //! \return false, if there is no cache or it does not belong to filename
+  bool map_cache(const std::string& filename)
+  {
+    namespace bip = boost::interprocess;
+    const std::string cache = cache_filename(filename);
+    if (!boost::filesystem::exists(filename) || !boost::filesystem::exists(cache))
+      return false;
+    const CacheHeader expected = cache_header(filename);
+    const size_t header_size = sizeof(CacheHeader) + numElements_.size()*sizeof(std::uint64_t);
+    if (boost::filesystem::file_size(cache) != header_size + num_voxels_*num_values_*sizeof(double))
+      return false;
+    std::unique_ptr< bip::file_mapping > file(new bip::file_mapping(cache.c_str(), bip::read_only));
+    std::unique_ptr< bip::mapped_region > region(new bip::mapped_region(*file, bip::read_only));
+    const char* data = static_cast< const char* >(region->get_address());
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(CacheHeader));
+    if (std::memcmp(&header, &expected, sizeof(CacheHeader)) != 0)
+      return false;
+    std::vector< std::uint64_t > elements(numElements_.size());
+    std::memcpy(elements.data(), data + sizeof(CacheHeader), elements.size()*sizeof(std::uint64_t));
+    for (size_t dd = 0; dd < elements.size(); ++dd)
+      if (elements[dd] != numElements_[dd])
+        return false;
+    file_ = std::move(file);
+    region_ = std::move(region);
+    values_ = reinterpret_cast< const double* >(data + header_size);
+    return true;
+  } // ... map_cache(...)
+
+  //! writes to a temporary file which is then renamed, so concurrent runs never see a partial cache
+  void write_cache(const std::string& filename, std::ostream& out) const
+  {
+    const std::string cache = cache_filename(filename);
+    const std::string tmp = cache + boost::filesystem::unique_path(".%%%%-%%%%-%%%%").string();
+    try {
+      const CacheHeader header = cache_header(filename);
+      const std::vector< std::uint64_t > elements(numElements_.begin(), numElements_.end());
+      std::ofstream file(tmp, std::ios::binary);
+      file.write(reinterpret_cast< const char* >(&header), sizeof(CacheHeader));
+      file.write(reinterpret_cast< const char* >(elements.data()), elements.size()*sizeof(std::uint64_t));
+      file.write(reinterpret_cast< const char* >(values_), num_voxels_*num_values_*sizeof(double));
+      file.close();
+      if (!file)
+        DUNE_THROW(Dune::IOError, "could not write '" << tmp << "'!");
+      boost::filesystem::rename(tmp, cache);
+      out << "Cached the values in " << cache << "." << std::endl;
+    } catch (std::exception& ee) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp, ec);
+      out << "Could not write the cache " << cache << ": " << ee.what() << std::endl;
+    } catch (Dune::Exception& ee) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp, ec);
+      out << "Could not write the cache " << cache << ": " << ee.what() << std::endl;
+    }
+  } // ... write_cache(...)
+
+  const std::vector< size_t > numElements_;
+  const size_t num_values_;
+  size_t num_voxels_;
+  std::vector< double > owned_values_;
+  std::unique_ptr< boost::interprocess::file_mapping > file_;
+  std::unique_ptr< boost::interprocess::mapped_region > region_;
+  const double* values_;
+}; // class VoxelData
+
+
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_FUNCTION_FROMFILE_VOXELDATA_HH
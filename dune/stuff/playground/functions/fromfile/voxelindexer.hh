@@ -0,0 +1,144 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#ifndef DUNE_STUFF_FUNCTION_FROMFILE_VOXELINDEXER_HH
+#define DUNE_STUFF_FUNCTION_FROMFILE_VOXELINDEXER_HH
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include "voxeldata.hh"
+
+namespace Dune {
+namespace Stuff {
+
+
+enum class VoxelInterpolation
+{
+  //! the value of the voxel containing the point
+  piecewise_constant,
+  //! multilinear (i.e. trilinear in 3d) interpolation between the voxel centers, constant within half a voxel of the
+  //! boundary
+  multilinear
+};
+
+
+/**
+ *  \brief Maps points of the box [lowerLeft, upperRight] to the voxels of a VoxelData.
+ *
+ *  The inverse voxel widths and the strides (the last direction running fastest, as in VoxelData) are computed once,
+ *  so locating a point costs one multiplication and one truncation per direction. Points on upperRight belong to the
+ *  last voxel, points outside of the box are rejected.
+ */
+template< class DomainFieldImp, int domainDim >
+class VoxelIndexer
+{
+public:
+  typedef DomainFieldImp                                  DomainFieldType;
+  static const int                                        dimDomain = domainDim;
+  typedef Dune::FieldVector< DomainFieldType, dimDomain > DomainType;
+
+  static const size_t num_corners = size_t(1) << dimDomain;
+
+  VoxelIndexer(const DomainType& lowerLeft, const DomainType& upperRight, const std::vector< size_t >& numElements)
+    : lowerLeft_(lowerLeft)
+  {
+    if (numElements.size() != dimDomain)
+      DUNE_THROW(Dune::RangeError,
+                 "numElements has to have " << dimDomain << " entries (has " << numElements.size() << ")!");
+    size_t stride = 1;
+    for (int dd = dimDomain - 1; dd >= 0; --dd) {
+      numElements_[dd] = numElements[dd];
+      inverse_widths_[dd] = numElements[dd]/(upperRight[dd] - lowerLeft[dd]);
+      strides_[dd] = stride;
+      stride *= numElements[dd];
+    }
+  } // VoxelIndexer(...)
+
+  //! \return the index of the voxel containing x, as used by VoxelData::values()
+  size_t index(const DomainType& x) const
+  {
+    size_t ret = 0;
+    for (int dd = 0; dd < dimDomain; ++dd)
+      ret += std::min(size_t(coordinate(x, dd)), numElements_[dd] - 1)*strides_[dd];
+    return ret;
+  }
+
+  //! writes the data.num_values() values at x to ret
+  void evaluate(const DomainType& x,
+                const VoxelData& data,
+                const VoxelInterpolation interpolation,
+                double* ret) const
+  {
+    const size_t num_values = data.num_values();
+    if (interpolation == VoxelInterpolation::piecewise_constant) {
+      const double* values = data.values(index(x));
+      std::copy(values, values + num_values, ret);
+      return;
+    }
+    // the voxel centers are at coordinate() = 0.5, 1.5, ...
+    size_t base = 0;
+    size_t offsets[dimDomain];
+    double weights[dimDomain];
+    for (int dd = 0; dd < dimDomain; ++dd) {
+      const double local = coordinate(x, dd) - 0.5;
+      const double lower = std::floor(local);
+      if (lower < 0 || lower + 1 >= numElements_[dd]) {
+        base += ((lower < 0) ? 0 : numElements_[dd] - 1)*strides_[dd];
+        offsets[dd] = 0;
+        weights[dd] = 0;
+      } else {
+        base += size_t(lower)*strides_[dd];
+        offsets[dd] = strides_[dd];
+        weights[dd] = local - lower;
+      }
+    }
+    std::fill(ret, ret + num_values, 0.0);
+    for (size_t corner = 0; corner < num_corners; ++corner) {
+      size_t voxel = base;
+      double weight = 1;
+      for (int dd = 0; dd < dimDomain; ++dd) {
+        if (corner & (size_t(1) << dd)) {
+          voxel += offsets[dd];
+          weight *= weights[dd];
+        } else
+          weight *= 1 - weights[dd];
+      }
+      if (weight == 0)
+        continue;
+      const double* values = data.values(voxel);
+      for (size_t vv = 0; vv < num_values; ++vv)
+        ret[vv] += weight*values[vv];
+    }
+  } // ... evaluate(...)
+
+private:
+  //! \return the position of x in direction dd in multiples of the voxel width, relative to lowerLeft
+  double coordinate(const DomainType& x, const int dd) const
+  {
+    const double ret = (x[dd] - lowerLeft_[dd])*inverse_widths_[dd];
+    if (!((0 <= ret) && (ret <= numElements_[dd])))
+      DUNE_THROW(Dune::RangeError,
+                 "Error: " << dd << ". coordinate of the point (" << x[dd]
+                 << ") does not lie in the domain (voxel " << std::floor(ret)
+                 << " is not between 0 and numElements[" << dd << "]-1 (" << numElements_[dd] - 1 << ")) !");
+    return ret;
+  } // ... coordinate(...)
+
+  const DomainType lowerLeft_;
+  double inverse_widths_[dimDomain];
+  size_t numElements_[dimDomain];
+  size_t strides_[dimDomain];
+}; // class VoxelIndexer
+
+
+} // namespace Stuff
+} // namespace Dune
+
+#endif // DUNE_STUFF_FUNCTION_FROMFILE_VOXELINDEXER_HH
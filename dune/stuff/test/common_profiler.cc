@@ -8,6 +8,12 @@
 #include <dune/stuff/common/profiler.hh>
 #include <dune/stuff/common/math.hh>
 #include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/threadmanager.hh>
+
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
 
 using namespace Dune::Stuff::Common;
 const int wait_ms = 142;
@@ -62,6 +68,51 @@ TEST(ProfilerTest, NestedTiming) {
   EXPECT_GT(outer, inner);
 }
 
+static size_t occurrences(const std::string& str, const std::string& pattern) {
+  size_t ret = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+    ++ret;
+  return ret;
+}
+
+TEST(ProfilerTest, Tracing) {
+  auto& prof = DSC_PROFILER;
+  const auto section = prof.sectionId("Tracing.Outer");
+  EXPECT_EQ(section, prof.sectionId("Tracing.Outer"));
+  EXPECT_EQ("Tracing.Outer", prof.sectionName(section));
+  EXPECT_THROW(prof.sectionName(section + 1000), Dune::RangeError);
+  prof.resetTrace();
+  // not recorded, tracing is disabled by default
+  prof.startEvent(section);
+  prof.stopEvent(section);
+  prof.setTracing(true);
+  {
+    DSC_PROFILER_TRACE_SCOPE("Tracing.Outer");
+    Dune::Stuff::ThreadManager::run_in_parallel([](const unsigned int, const unsigned int) {
+      DSC_PROFILER_TRACE_SCOPE("Tracing.Inner");
+      busywait(1);
+    });
+  }
+  prof.setTracing(false);
+  std::stringstream trace;
+  prof.outputTrace(trace);
+  const auto num_threads = Dune::Stuff::ThreadManager::max_threads();
+  EXPECT_EQ(1 + num_threads, occurrences(trace.str(), "\"ph\":\"B\""));
+  EXPECT_EQ(1 + num_threads, occurrences(trace.str(), "\"ph\":\"E\""));
+  EXPECT_EQ(2 * num_threads, occurrences(trace.str(), "\"Tracing.Inner\""));
+  // write the files to a temporary directory, which is removed afterwards
+  const auto directory = boost::filesystem::temp_directory_path()
+                         / boost::filesystem::unique_path("dune-stuff-profiler-%%%%-%%%%-%%%%");
+  prof.setOutputdir(directory.string());
+  prof.outputTrace("trace");
+  prof.outputTraceBinary("trace");
+  prof.setOutputdir("./profiling");
+  const auto rank = Dune::MPIHelper::getCollectiveCommunication().rank();
+  EXPECT_TRUE(boost::filesystem::exists(directory / (boost::format("trace_p%08d.json") % rank).str()));
+  EXPECT_TRUE(boost::filesystem::exists(directory / (boost::format("trace_p%08d.dstrace") % rank).str()));
+  boost::filesystem::remove_all(directory);
+}
+
 int main(int argc, char** argv)
 {
   test_init(argc, argv);
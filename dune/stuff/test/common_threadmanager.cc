@@ -0,0 +1,64 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "test_common.hh"
+
+#include <algorithm>
+#include <vector>
+
+#include <dune/stuff/common/threadmanager.hh>
+
+using namespace Dune::Stuff;
+
+TEST(ThreadManager, parallel_for) {
+  ThreadManager::set_max_threads(4);
+  std::vector< int > visits(1000, 0);
+  std::vector< int > invalid_threads(ThreadManager::max_threads(), 0);
+  ThreadManager::parallel_for(0, visits.size(), [&](const size_t first, const size_t last) {
+    if (ThreadManager::thread() >= ThreadManager::max_threads())
+      ++invalid_threads[0];
+    for (size_t ii = first; ii < last; ++ii)
+      ++visits[ii];
+  });
+  EXPECT_EQ(0, invalid_threads[0]);
+  EXPECT_EQ(visits.size(), size_t(std::count(visits.begin(), visits.end(), 1)));
+}
+
+TEST(ThreadManager, runs_nested_regions_on_the_calling_thread) {
+  ThreadManager::set_max_threads(4);
+  std::vector< int > outer_mismatches(ThreadManager::max_threads(), 0);
+  std::vector< int > inner_mismatches(ThreadManager::max_threads(), 0);
+  ThreadManager::run_in_parallel([&](const unsigned int chunk, const unsigned int num_chunks) {
+    const unsigned int outer_thread = ThreadManager::thread();
+    if (outer_thread != chunk || num_chunks != ThreadManager::max_threads())
+      ++outer_mismatches[chunk];
+    ThreadManager::run_in_parallel([&](const unsigned int inner_chunk, const unsigned int inner_num_chunks) {
+      if (inner_chunk != 0 || inner_num_chunks != 1 || ThreadManager::thread() != outer_thread)
+        ++inner_mismatches[chunk];
+    });
+  });
+  EXPECT_EQ(outer_mismatches.size(), size_t(std::count(outer_mismatches.begin(), outer_mismatches.end(), 0)));
+  EXPECT_EQ(inner_mismatches.size(), size_t(std::count(inner_mismatches.begin(), inner_mismatches.end(), 0)));
+}
+
+TEST(PerThreadValue, reductions) {
+  ThreadManager::set_max_threads(4);
+  PerThreadValue< long > value(0l);
+  EXPECT_EQ(ThreadManager::max_threads(), value.size());
+  ThreadManager::parallel_for(0, 10000, [&](const size_t first, const size_t last) {
+    for (size_t ii = first; ii < last; ++ii)
+      *value += 1;
+  });
+  EXPECT_EQ(10000, value.sum());
+  EXPECT_LE(10000/long(value.size()), value.reduce([](const long lhs, const long rhs) { return std::max(lhs, rhs); }));
+  value.for_each([](long& local_value) { local_value = 1; });
+  EXPECT_EQ(long(value.size()), value.sum());
+}
+
+int main(int argc, char** argv)
+{
+  test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -7,6 +7,7 @@
 
 #if HAVE_DUNE_GRID
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <utility>
@@ -22,6 +23,7 @@
 #include <dune/stuff/fem/customprojection.hh>
 #include <dune/stuff/common/profiler.hh>
 #include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/threadmanager.hh>
 #include <dune/stuff/functions/femadapter.hh>
 #include <dune/stuff/common/parameter/configcontainer.hh>
 #include <dune/stuff/fem/namespace.hh>
@@ -60,6 +62,20 @@ typedef SGrid<dim,dim> SourceGrid;
 #endif
 typedef YaspGrid<dim> TargetGrid;
 
+namespace Dune {
+namespace Stuff {
+namespace Grid {
+
+// opt in, so the evaluation points are located on several threads if YaspGrid is the source grid
+template<>
+struct AllowsConcurrentAccess< Dune::YaspGrid< dim > >
+  : public std::true_type
+{};
+
+} // namespace Grid
+} // namespace Stuff
+} // namespace Dune
+
 template <class Grid>
 struct Traits {
   typedef Dune::Fem::AdaptiveLeafGridPart<Grid> GridPart;
@@ -133,6 +149,10 @@ void ptest(const std::shared_ptr<SourceGrid>& source_cube, const std::shared_ptr
   DSC_PROFILER.startTiming("EntityInlevelSearch ST");
   Stuff::HeterogenousProjection<DSG::EntityInlevelSearch>::project(source_df, target_df);
   DSC_PROFILER.stopTiming("EntityInlevelSearch ST");
+
+  DSC_PROFILER.startTiming("EntityBoundingBoxSearch ST");
+  Stuff::HeterogenousProjection<DSG::EntityBoundingBoxSearch>::project(source_df, target_df);
+  DSC_PROFILER.stopTiming("EntityBoundingBoxSearch ST");
   vtk_out(source_df);
   vtk_out(target_df);
 
@@ -176,6 +196,49 @@ TEST(Projection, Cubes){
   DSC_PROFILER.outputTimingsAll();
 }
 
+template< template< class > class SearchStrategy >
+void check_serial_and_parallel_agree() {
+  typedef Traits< TargetGrid > SourceTraits;
+  typedef Traits< SourceGrid > TargetTraits;
+  auto source_cube = Stuff::GridProviderCube< TargetGrid >(0, 1, 8).grid();
+  auto target_cube = Stuff::GridProviderCube< SourceGrid >(0, 1, 8).grid();
+  source_cube->globalRefine(1);
+  target_cube->globalRefine(2);
+  typename SourceTraits::GridPart source_part(*source_cube);
+  typename TargetTraits::GridPart target_part(*target_cube);
+  typename SourceTraits::DiscreteSpace source_space(source_part);
+  typename TargetTraits::DiscreteSpace target_space(target_part);
+  typename SourceTraits::DiscreteFunction source_df("source", source_space);
+  typename TargetTraits::DiscreteFunction serial_df("serial", target_space);
+  typename TargetTraits::DiscreteFunction parallel_df("parallel", target_space);
+
+  typedef Stuff::Function::Expression< typename TargetGrid::template Codim< 0 >::Entity, double, dim, double, 1 >
+      ScalarFunctionType;
+  ScalarFunctionType scalar_f("x", "sin(3*x[0]) + x[0]*x[1]");
+  auto wrapped = Stuff::femFunctionAdapter(scalar_f);
+  LagrangeInterpolation< typename SourceTraits::DiscreteFunction >::apply(wrapped, source_df);
+
+  const unsigned int max_threads = DS::ThreadManager::max_threads();
+  DS::ThreadManager::set_max_threads(1);
+  Stuff::HeterogenousProjection< SearchStrategy >::project(source_df, serial_df);
+  DS::ThreadManager::set_max_threads(4);
+  Stuff::HeterogenousProjection< SearchStrategy >::project(source_df, parallel_df);
+  DS::ThreadManager::set_max_threads(max_threads);
+
+  ASSERT_EQ(serial_df.size(), parallel_df.size());
+  auto serial_it = serial_df.dbegin();
+  for (auto parallel_it = parallel_df.dbegin(); parallel_it != parallel_df.dend(); ++parallel_it, ++serial_it) {
+    EXPECT_FALSE(std::isinf(*serial_it));
+    EXPECT_EQ(*serial_it, *parallel_it);
+  }
+}
+
+TEST(Projection, SerialAndParallelAgree) {
+  check_serial_and_parallel_agree< DSG::EntityBoundingBoxSearch >();
+  // keeps the last hit, so every thread needs its own copy
+  check_serial_and_parallel_agree< DSG::EntityInlevelSearch >();
+}
+
 #endif //#if HAVE_DUNE_FEM
 
 #endif // #if HAVE_DUNE_GRID
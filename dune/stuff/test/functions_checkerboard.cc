@@ -6,6 +6,8 @@
 #include "test_common.hh"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 
@@ -183,6 +185,120 @@ TYPED_TEST(CheckerboardFunctionAluGridEntityTest, provides_required_methods) {
 }
 
 # endif // HAVE_ALUGRID_SERIAL || HAVE_ALUGRID_PARALLEL
+
+# include <dune/stuff/grid/provider/cube.hh>
+
+struct CheckerboardFunctionOnYaspGrid
+  : public ::testing::Test
+{
+  typedef Dune::YaspGrid< 2 > GridType;
+  typedef GridType::Codim< 0 >::Entity EntityType;
+  typedef Dune::Stuff::Functions::Checkerboard< EntityType, double, 2, double, 1, 1 > FunctionType;
+  typedef FunctionType::LocalfunctionType LocalfunctionType;
+
+  CheckerboardFunctionOnYaspGrid()
+    : grid_provider(0.0, 1.0, 4u)
+    , grid_view(grid_provider.grid()->leafGridView())
+    , function(FunctionType::create(FunctionType::default_config()))
+    , center(0.5)
+  {}
+
+  //! the default config splits the unit square into 2x2 subdomains with the values 1, 2, 3 and 4
+  static double expected_value(const EntityType& entity)
+  {
+    const auto entity_center = entity.geometry().center();
+    return 1.0 + (entity_center[0] > 0.5 ? 1.0 : 0.0) + (entity_center[1] > 0.5 ? 2.0 : 0.0);
+  }
+
+  Dune::Stuff::Grid::Providers::Cube< GridType > grid_provider;
+  const GridType::LeafGridView grid_view;
+  std::unique_ptr< const FunctionType > function;
+  const FunctionType::DomainType center;
+}; // struct CheckerboardFunctionOnYaspGrid
+
+TEST_F(CheckerboardFunctionOnYaspGrid, rebinds_local_functions) {
+  const auto difference = *function - *function;
+  std::unique_ptr< LocalfunctionType > local_function;
+  std::unique_ptr< LocalfunctionType > local_difference;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    if (!local_function) {
+      local_function = function->local_function(entity);
+      local_difference = difference.local_function(entity);
+    } else {
+      local_function->bind(entity);
+      local_difference->bind(entity);
+    }
+    EXPECT_EQ(&entity, &local_function->entity());
+    EXPECT_EQ(expected_value(entity), local_function->evaluate(center)[0]);
+    EXPECT_EQ(0.0, local_difference->evaluate(center)[0]);
+  }
+}
+
+TEST_F(CheckerboardFunctionOnYaspGrid, local_functions_outlive_the_function) {
+  auto it = grid_view.begin< 0 >();
+  const auto local_function = function->local_function(*it);
+  function.reset();
+  for (; it != grid_view.end< 0 >(); ++it) {
+    local_function->bind(*it);
+    EXPECT_EQ(expected_value(*it), local_function->evaluate(center)[0]);
+  }
+}
+
+TEST_F(CheckerboardFunctionOnYaspGrid, precomputes_values) {
+  FunctionType precomputed(*function);
+  EXPECT_FALSE(precomputed.precomputed());
+  precomputed.precompute(grid_view);
+  EXPECT_TRUE(precomputed.precomputed());
+  EXPECT_FALSE(function->precomputed());
+  const FunctionType copied(precomputed);
+  EXPECT_TRUE(copied.precomputed());
+  std::unique_ptr< LocalfunctionType > local_function;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    if (!local_function)
+      local_function = precomputed.local_function(entity);
+    else
+      local_function->bind(entity);
+    EXPECT_EQ(expected_value(entity), local_function->evaluate(center)[0]);
+    EXPECT_EQ(expected_value(entity), copied.local_function(entity)->evaluate(center)[0]);
+  }
+}
+
+TEST_F(CheckerboardFunctionOnYaspGrid, is_constant_on_each_entity_for_batches) {
+  auto reversed_config = FunctionType::default_config();
+  reversed_config["values"] = "[4.0 3.0 2.0 1.0]";
+  const std::unique_ptr< const FunctionType > reversed(FunctionType::create(reversed_config));
+  const auto difference = *function - *reversed;
+  // the corners and an inner point of the reference element
+  std::vector< FunctionType::DomainType > points(5, FunctionType::DomainType(0.0));
+  points[1][0] = 1.0;
+  points[2][1] = 1.0;
+  points[3] = 1.0;
+  points[4][0] = 0.25; points[4][1] = 0.75;
+  std::vector< FunctionType::RangeType > values;
+  std::vector< FunctionType::JacobianRangeType > jacobians;
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const auto& entity = *it;
+    const double value = expected_value(entity);
+    const std::unique_ptr< const LocalfunctionType > local_function = function->local_function(entity);
+    const std::unique_ptr< const LocalfunctionType > local_difference = difference.local_function(entity);
+    // the value of the reversed checkerboard is 5 - value
+    for (const auto& local_func_and_value : {std::make_pair(local_function.get(), value),
+                                             std::make_pair(local_difference.get(), 2.0*value - 5.0)}) {
+      local_func_and_value.first->evaluate(points, values);
+      local_func_and_value.first->jacobian(points, jacobians);
+      ASSERT_EQ(points.size(), values.size());
+      ASSERT_EQ(points.size(), jacobians.size());
+      for (size_t pp = 0; pp < points.size(); ++pp) {
+        EXPECT_EQ(local_func_and_value.second, values[pp][0]);
+        EXPECT_EQ(0.0, jacobians[pp][0][0]);
+        EXPECT_EQ(0.0, jacobians[pp][0][1]);
+      }
+    }
+  }
+}
+
 #endif // HAVE_DUNE_GRID
 
 
@@ -6,6 +6,7 @@
 #include "test_common.hh"
 
 #include <memory>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 
@@ -125,6 +126,53 @@ TYPED_TEST(ConstantFunctionYaspGridEntityTest, provides_required_methods) {
   this->check();
 }
 
+# include <dune/stuff/grid/provider/cube.hh>
+
+TEST(ConstantFunction, evaluates_batches_to_the_constant) {
+  typedef Dune::Stuff::Functions::Constant< DuneYaspGrid2dEntityType, double, 2, double, 2, 1 > FunctionType;
+  typedef FunctionType::BaseType GlobalFunctionType;
+  typedef FunctionType::LocalfunctionType LocalfunctionType;
+  FunctionType::RangeType constant;
+  constant[0] = 1.0;
+  constant[1] = -2.0;
+  const FunctionType function(constant);
+  const GlobalFunctionType& global_function = function;
+  Dune::Stuff::Grid::Providers::Cube< Dune::YaspGrid< 2 > > grid_provider(0.0, 1.0, 2u);
+  const auto grid_view = grid_provider.grid()->leafGridView();
+  // the function does not care about the domain, so points outside of the unit square are fine as well
+  std::vector< FunctionType::DomainType > points(4, FunctionType::DomainType(0.0));
+  points[1] = 1.0;
+  points[2][0] = -3.0; points[2][1] = 0.5;
+  points[3][0] = 0.25; points[3][1] = 7.0;
+  // stale results from a bigger batch must not survive
+  std::vector< FunctionType::RangeType > values(7, FunctionType::RangeType(42.0));
+  std::vector< FunctionType::JacobianRangeType > jacobians(7, FunctionType::JacobianRangeType(42.0));
+  global_function.evaluate(points, values);
+  global_function.jacobian(points, jacobians);
+  ASSERT_EQ(points.size(), values.size());
+  ASSERT_EQ(points.size(), jacobians.size());
+  for (size_t pp = 0; pp < points.size(); ++pp) {
+    EXPECT_EQ(constant, values[pp]);
+    EXPECT_EQ(FunctionType::JacobianRangeType(0.0), jacobians[pp]);
+  }
+  const std::vector< FunctionType::DomainType > no_points;
+  global_function.evaluate(no_points, values);
+  global_function.jacobian(no_points, jacobians);
+  EXPECT_TRUE(values.empty());
+  EXPECT_TRUE(jacobians.empty());
+  for (auto it = grid_view.begin< 0 >(); it != grid_view.end< 0 >(); ++it) {
+    const std::unique_ptr< const LocalfunctionType > local_function = function.local_function(*it);
+    local_function->evaluate(points, values);
+    local_function->jacobian(points, jacobians);
+    ASSERT_EQ(points.size(), values.size());
+    ASSERT_EQ(points.size(), jacobians.size());
+    for (size_t pp = 0; pp < points.size(); ++pp) {
+      EXPECT_EQ(constant, values[pp]);
+      EXPECT_EQ(LocalfunctionType::JacobianRangeType(0.0), jacobians[pp]);
+    }
+  }
+}
+
 # if HAVE_ALUGRID_SERIAL || HAVE_ALUGRID_PARALLEL
 #   undef HAVE_GRIDTYPE
 #   undef WORLDDIM
@@ -5,12 +5,18 @@
 
 #include "test_common.hh"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 
 #include <dune/stuff/functions/interfaces.hh>
 #include <dune/stuff/functions/expression.hh>
+#include <dune/stuff/functions/expression/bytecode.hh>
 
 
 // we need this nasty code generation because the testing::Types< ... > only accepts 50 arguments
@@ -187,6 +193,131 @@ TYPED_TEST(ExpressionFunctionAluGridEntityTest, provides_required_methods) {
 #endif // HAVE_DUNE_GRID
 
 
+TEST(MathExpressionBytecode, reproduces_mathexpr) {
+  double x[3] = {0., 0., 0.};
+  RVar x0("x[0]", &x[0]);
+  RVar x1("x[1]", &x[1]);
+  RVar x2("x[2]", &x[2]);
+  RVar* variables[3] = {&x0, &x1, &x2};
+  const std::vector< std::string > expressions = {"sin(x[0])*cos(x[1]) + x[2]^2",
+                                                  "sin(x[0])*cos(x[1]) - 2*3 + pi",
+                                                  "atan(x[1], x[0]) + sqrt(abs(x[2]))",
+                                                  "ln(x[0]) + exp(x[1]/x[2])",
+                                                  "x[0]^0.5 + 2^3 + -x[1]",
+                                                  "asin(x[0]/10) + acos(x[1]/10) + tan(x[2])",
+                                                  "1e3*x[0] + 2.5E-2",
+                                                  "x[0]/0",
+                                                  "3*4 - 2"};
+  std::vector< std::unique_ptr< ROperation > > operations;
+  std::vector< const ROperation* > operation_ptrs;
+  for (const auto& expression : expressions) {
+    operations.emplace_back(new ROperation(expression.c_str(), 3, variables));
+    operation_ptrs.push_back(operations.back().get());
+  }
+  const Dune::Stuff::Functions::MathExpressionBytecode bytecode(operation_ptrs, {&x[0], &x[1], &x[2]});
+  EXPECT_TRUE(bytecode.compiled());
+  // the common sin(x[0])*cos(x[1]) is computed once, 3*4 - 2 is folded away
+  EXPECT_EQ(1, std::count_if(bytecode.instructions().begin(), bytecode.instructions().end(),
+                             [](const Dune::Stuff::Functions::MathExpressionBytecode::Instruction& instruction) {
+                               return instruction.op == Dune::Stuff::Functions::MathExpressionBytecode::OpCode::Sin;
+                             }));
+  std::vector< double > registers(bytecode.num_registers());
+  std::vector< double > results(expressions.size());
+  const std::vector< double > points = {-2., -0.5, 0., 0.25, 1., 3.};
+  for (double p0 : points)
+    for (double p1 : points)
+      for (double p2 : points) {
+        x[0] = p0;
+        x[1] = p1;
+        x[2] = p2;
+        bytecode.evaluate(x, results.data(), registers.data());
+        for (size_t ii = 0; ii < expressions.size(); ++ii) {
+          // mathexpr.cc computes in long double, we in double
+          const double expected = operations[ii]->Val();
+          if (expected == ErrVal)
+            EXPECT_EQ(ErrVal, results[ii]) << expressions[ii];
+          else
+            EXPECT_NEAR(expected, results[ii], 1e-14*std::max(1.0, std::abs(expected))) << expressions[ii];
+        }
+      }
+  // user defined functions and juxtapositions are left to ROperation::Val()
+  const ROperation juxtaposition("x[0], x[1]", 3, variables);
+  EXPECT_FALSE(Dune::Stuff::Functions::MathExpressionBytecode({&juxtaposition}, {&x[0], &x[1], &x[2]}).compiled());
+} // TEST(MathExpressionBytecode, reproduces_mathexpr)
+
+TEST(MathExpressionBase, evaluates_concurrently) {
+  typedef Dune::Stuff::Functions::MathExpressionBase< double, 2, double, 2 > FunctionType;
+  const FunctionType function("x", std::vector< std::string >({"x[0]*x[1]", "sin(x[0]) + x[1]"}));
+  std::vector< size_t > failures(4, 0);
+  std::vector< std::thread > threads;
+  for (size_t tt = 0; tt < failures.size(); ++tt)
+    threads.emplace_back([&, tt]() {
+      Dune::FieldVector< double, 2 > xx;
+      Dune::FieldVector< double, 2 > ret;
+      for (size_t ii = 0; ii < 10000; ++ii) {
+        xx[0] = tt + 1e-4*ii;
+        xx[1] = tt;
+        function.evaluate(xx, ret);
+        if (ret[0] != xx[0]*xx[1] || ret[1] != std::sin(xx[0]) + xx[1])
+          ++failures[tt];
+      }
+    });
+  for (auto& thread : threads)
+    thread.join();
+  for (size_t tt = 0; tt < failures.size(); ++tt)
+    EXPECT_EQ(size_t(0), failures[tt]);
+} // TEST(MathExpressionBase, evaluates_concurrently)
+
+TEST(MathExpressionBase, provides_symbolic_jacobian) {
+  typedef Dune::Stuff::Functions::MathExpressionBase< double, 2, double, 4 > FunctionType;
+  const FunctionType function("x", std::vector< std::string >({"x[0]*x[1]",
+                                                               "sin(x[0]) + x[1]^2",
+                                                               "exp(x[0]*x[1])",
+                                                               "atan(x[1], x[0])"}));
+  Dune::FieldVector< double, 2 > xx;
+  xx[0] = 0.3;
+  xx[1] = -1.7;
+  Dune::FieldMatrix< double, 4, 2 > jacobian;
+  function.jacobian(xx, jacobian);
+  const double exp_x0_x1 = std::exp(xx[0]*xx[1]);
+  const double norm_squared = xx[0]*xx[0] + xx[1]*xx[1];
+  const double expected[4][2] = {{xx[1], xx[0]},
+                                 {std::cos(xx[0]), 2*xx[1]},
+                                 {xx[1]*exp_x0_x1, xx[0]*exp_x0_x1},
+                                 {-xx[1]/norm_squared, xx[0]/norm_squared}};
+  for (size_t ii = 0; ii < 4; ++ii)
+    for (size_t jj = 0; jj < 2; ++jj)
+      EXPECT_DOUBLE_EQ(expected[ii][jj], jacobian[ii][jj]) << ii << ", " << jj;
+} // TEST(MathExpressionBase, provides_symbolic_jacobian)
+
+TEST(MathExpressionBase, evaluates_batched) {
+  typedef Dune::Stuff::Functions::MathExpressionBase< double, 2, double, 2 > FunctionType;
+  const FunctionType function("x", std::vector< std::string >({"x[0]*x[1]", "sin(x[0]) + x[1]^2"}));
+  std::vector< Dune::FieldVector< double, 2 > > points(5);
+  for (size_t pp = 0; pp < points.size(); ++pp) {
+    points[pp][0] = 0.1*pp;
+    points[pp][1] = 1.0 - 0.3*pp;
+  }
+  std::vector< Dune::FieldVector< double, 2 > > values;
+  std::vector< Dune::FieldMatrix< double, 2, 2 > > jacobians;
+  function.evaluate(points, values);
+  function.jacobian(points, jacobians);
+  ASSERT_EQ(points.size(), values.size());
+  ASSERT_EQ(points.size(), jacobians.size());
+  Dune::FieldVector< double, 2 > value;
+  Dune::FieldMatrix< double, 2, 2 > jacobian;
+  for (size_t pp = 0; pp < points.size(); ++pp) {
+    function.evaluate(points[pp], value);
+    function.jacobian(points[pp], jacobian);
+    for (size_t ii = 0; ii < 2; ++ii) {
+      EXPECT_EQ(value[ii], values[pp][ii]);
+      for (size_t jj = 0; jj < 2; ++jj)
+        EXPECT_EQ(jacobian[ii][jj], jacobians[pp][ii][jj]);
+    }
+  }
+} // TEST(MathExpressionBase, evaluates_batched)
+
+
 int main(int argc, char** argv)
 {
   test_init(argc, argv);
@@ -0,0 +1,215 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "test_common.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/stuff/playground/functions/fromfile.hh>
+
+using namespace Dune::Stuff;
+
+
+struct FunctionFromFileTest
+  : public ::testing::Test
+{
+  static const int dimDomain = 3;
+  typedef Dune::FieldVector< double, dimDomain > DomainType;
+  typedef VoxelIndexer< double, dimDomain > IndexerType;
+
+  FunctionFromFileTest()
+    : directory_(boost::filesystem::temp_directory_path()
+                 / boost::filesystem::unique_path("dune-stuff-fromfile-%%%%-%%%%-%%%%"))
+    , numElements_{4, 5, 3}
+  {
+    lowerLeft_[0] = -1.0; lowerLeft_[1] = 0.0; lowerLeft_[2] = 0.5;
+    upperRight_[0] = 2.0; upperRight_[1] = 1.0; upperRight_[2] = 3.0;
+    boost::filesystem::create_directories(directory_);
+  }
+
+  ~FunctionFromFileTest()
+  {
+    boost::filesystem::remove_all(directory_);
+  }
+
+  std::string path(const std::string& filename) const
+  {
+    return (directory_ / filename).string();
+  }
+
+  static double linear(const DomainType& x)
+  {
+    return 0.5 + 1.5*x[0] - 2.0*x[1] + 0.75*x[2];
+  }
+
+  DomainType center(const size_t xx, const size_t yy, const size_t zz) const
+  {
+    const size_t voxel[dimDomain] = {xx, yy, zz};
+    DomainType ret;
+    for (int dd = 0; dd < dimDomain; ++dd)
+      ret[dd] = lowerLeft_[dd] + (voxel[dd] + 0.5)*(upperRight_[dd] - lowerLeft_[dd])/numElements_[dd];
+    return ret;
+  }
+
+  //! the multilinear interpolation is constant within half a voxel of the boundary
+  DomainType clamped_to_the_centers(const DomainType& point) const
+  {
+    const DomainType first_center = center(0, 0, 0);
+    const DomainType last_center = center(numElements_[0] - 1, numElements_[1] - 1, numElements_[2] - 1);
+    DomainType ret = point;
+    for (int dd = 0; dd < dimDomain; ++dd)
+      ret[dd] = std::max(first_center[dd], std::min(last_center[dd], point[dd]));
+    return ret;
+  }
+
+  /**
+   *  writes a voxel file with num_values values per voxel: the first is linear() at the voxel center, the others are
+   *  the index of the voxel plus the number of the value
+   */
+  std::string write(const std::string& filename, const size_t num_values) const
+  {
+    std::ofstream file(path(filename));
+    file.precision(17);
+    size_t index = 0;
+    for (size_t xx = 0; xx < numElements_[0]; ++xx)
+      for (size_t yy = 0; yy < numElements_[1]; ++yy)
+        for (size_t zz = 0; zz < numElements_[2]; ++zz, ++index) {
+          file << xx + 1 << " " << yy + 1 << " " << zz + 1 << " " << linear(center(xx, yy, zz));
+          for (size_t vv = 1; vv < num_values; ++vv)
+            file << " " << index + vv;
+          file << "\n";
+        }
+    return path(filename);
+  } // ... write(...)
+
+  //! random points in the box
+  std::vector< DomainType > points(const size_t num) const
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > distribution(0.0, 1.0);
+    std::vector< DomainType > ret(num);
+    for (auto& point : ret)
+      for (int dd = 0; dd < dimDomain; ++dd)
+        point[dd] = lowerLeft_[dd] + distribution(generator)*(upperRight_[dd] - lowerLeft_[dd]);
+    return ret;
+  }
+
+  const boost::filesystem::path directory_;
+  const std::vector< size_t > numElements_;
+  DomainType lowerLeft_;
+  DomainType upperRight_;
+  std::ostringstream out_;
+}; // struct FunctionFromFileTest
+
+
+TEST_F(FunctionFromFileTest, indexes_like_the_direct_formula) {
+  const IndexerType indexer(lowerLeft_, upperRight_, numElements_);
+  for (const auto& point : points(100000)) {
+    size_t expected = 0;
+    for (int dd = 0; dd < dimDomain; ++dd)
+      expected = expected*numElements_[dd]
+                 + size_t(std::floor(numElements_[dd]*((point[dd] - lowerLeft_[dd])/(upperRight_[dd] - lowerLeft_[dd]))));
+    ASSERT_EQ(expected, indexer.index(point)) << point;
+  }
+  // points on the boundary belong to the first or last voxel
+  EXPECT_EQ(size_t(0), indexer.index(lowerLeft_));
+  EXPECT_EQ(numElements_[0]*numElements_[1]*numElements_[2] - 1, indexer.index(upperRight_));
+  // points outside
+  DomainType outside = upperRight_;
+  outside[1] += 1e-3;
+  EXPECT_THROW(indexer.index(outside), Dune::RangeError);
+  outside = lowerLeft_;
+  outside[2] -= 1e-3;
+  EXPECT_THROW(indexer.index(outside), Dune::RangeError);
+  EXPECT_THROW(IndexerType(lowerLeft_, upperRight_, std::vector< size_t >{4, 5}), Dune::RangeError);
+}
+
+TEST_F(FunctionFromFileTest, evaluates_piecewise_constant) {
+  const IndexerType indexer(lowerLeft_, upperRight_, numElements_);
+  const VoxelData data(write("voxels.txt", 2), numElements_, 2, false, out_);
+  double values[2];
+  for (const auto& point : points(1000)) {
+    indexer.evaluate(point, data, VoxelInterpolation::piecewise_constant, values);
+    EXPECT_EQ(data.values(indexer.index(point))[0], values[0]);
+    EXPECT_EQ(double(indexer.index(point) + 1), values[1]);
+  }
+}
+
+TEST_F(FunctionFromFileTest, interpolates_multilinearly) {
+  const IndexerType indexer(lowerLeft_, upperRight_, numElements_);
+  const VoxelData data(write("voxels.txt", 1), numElements_, 1, false, out_);
+  double value;
+  double clamped_value;
+  size_t num_inner = 0;
+  for (const auto& point : points(10000)) {
+    indexer.evaluate(point, data, VoxelInterpolation::multilinear, &value);
+    // the interpolation is constant within half a voxel of the boundary ...
+    const DomainType clamped = clamped_to_the_centers(point);
+    const bool inner = (clamped == point);
+    indexer.evaluate(clamped, data, VoxelInterpolation::multilinear, &clamped_value);
+    EXPECT_NEAR(clamped_value, value, 1e-13);
+    // ... and reproduces linear functions in between
+    EXPECT_NEAR(linear(clamped), value, 1e-13);
+    if (inner)
+      ++num_inner;
+  }
+  EXPECT_GT(num_inner, size_t(0));
+  // the voxel centers are interpolated exactly
+  const IndexerType::DomainType some_center = center(1, 3, 2);
+  indexer.evaluate(some_center, data, VoxelInterpolation::multilinear, &value);
+  EXPECT_NEAR(linear(some_center), value, 1e-14);
+}
+
+TEST_F(FunctionFromFileTest, evaluates_batches_of_voxel_values) {
+  typedef FunctionFromFile< double, dimDomain, double, 1, 1 > ScalarFunctionType;
+  typedef FunctionFromFile< double, dimDomain, double, 2, 1 > VectorFunctionType;
+  const IndexerType indexer(lowerLeft_, upperRight_, numElements_);
+  const std::string scalar_file = write("scalar.txt", 1);
+  const std::string vector_file = write("vector.txt", 2);
+  const VoxelData data(scalar_file, numElements_, 1, false, out_);
+  // points on the boundary of the box belong to the batch as well
+  auto xs = points(1000);
+  xs.push_back(lowerLeft_);
+  xs.push_back(upperRight_);
+  std::vector< ScalarFunctionType::RangeType > scalar_values(3);
+  std::vector< VectorFunctionType::RangeType > vector_values;
+  const ScalarFunctionType piecewise_constant(scalar_file, lowerLeft_, upperRight_, numElements_, "scalar", 0, out_,
+                                              false, VoxelInterpolation::piecewise_constant);
+  const VectorFunctionType piecewise_constant_vector(vector_file, lowerLeft_, upperRight_, numElements_, "vector", 0,
+                                                     out_, false, VoxelInterpolation::piecewise_constant);
+  piecewise_constant.evaluate(xs, scalar_values);
+  piecewise_constant_vector.evaluate(xs, vector_values);
+  ASSERT_EQ(xs.size(), scalar_values.size());
+  ASSERT_EQ(xs.size(), vector_values.size());
+  for (size_t pp = 0; pp < xs.size(); ++pp) {
+    const size_t index = indexer.index(xs[pp]);
+    EXPECT_EQ(data.values(index)[0], scalar_values[pp][0]);
+    EXPECT_EQ(data.values(index)[0], vector_values[pp][0]);
+    EXPECT_EQ(double(index + 1), vector_values[pp][1]);
+  }
+  const ScalarFunctionType multilinear(scalar_file, lowerLeft_, upperRight_, numElements_, "scalar", 0, out_, false,
+                                       VoxelInterpolation::multilinear);
+  multilinear.evaluate(xs, scalar_values);
+  ASSERT_EQ(xs.size(), scalar_values.size());
+  for (size_t pp = 0; pp < xs.size(); ++pp)
+    EXPECT_NEAR(linear(clamped_to_the_centers(xs[pp])), scalar_values[pp][0], 1e-13);
+}
+
+int main(int argc, char** argv)
+{
+  test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,213 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "test_common.hh"
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/functions/spe10/permeability.hh>
+
+using namespace Dune::Stuff::Functions::Spe10;
+
+
+struct Spe10PermeabilityTest
+  : public ::testing::Test
+{
+  typedef PermeabilityData::CellsType CellsType;
+
+  Spe10PermeabilityTest()
+    : directory_(boost::filesystem::temp_directory_path()
+                 / boost::filesystem::unique_path("dune-stuff-spe10-%%%%-%%%%-%%%%"))
+    , cells_{{3, 2, 4}}
+    , num_components_(2)
+  {
+    boost::filesystem::create_directories(directory_);
+  }
+
+  ~Spe10PermeabilityTest()
+  {
+    boost::filesystem::remove_all(directory_);
+  }
+
+  std::string path(const std::string& filename) const
+  {
+    return (directory_ / filename).string();
+  }
+
+  //! the value of cell ii of component cc, with digits which are not representable exactly
+  static double expected_value(const size_t cc, const size_t ii)
+  {
+    return (cc + 1)*0.1 + ii*1.0e-3 + 1.0/3.0;
+  }
+
+  //! writes num_values values in the text format of the SPE, six per line
+  std::string write_text(const std::string& filename, const size_t num_values) const
+  {
+    const size_t num_cells = cells_[0]*cells_[1]*cells_[2];
+    std::ofstream file(path(filename));
+    file.precision(17);
+    for (size_t vv = 0; vv < num_values; ++vv)
+      file << "  " << expected_value(vv/num_cells, vv%num_cells) << ((vv + 1)%6 == 0 ? "\n" : "");
+    return path(filename);
+  }
+
+  std::string write_text(const std::string& filename) const
+  {
+    return write_text(filename, num_components_*cells_[0]*cells_[1]*cells_[2]);
+  }
+
+  void check_values(const PermeabilityData& data) const
+  {
+    ASSERT_EQ(cells_, data.cells());
+    ASSERT_EQ(num_components_, data.num_components());
+    size_t ii = 0;
+    for (size_t zz = 0; zz < cells_[2]; ++zz)
+      for (size_t yy = 0; yy < cells_[1]; ++yy)
+        for (size_t xx = 0; xx < cells_[0]; ++xx, ++ii)
+          for (size_t cc = 0; cc < num_components_; ++cc)
+            EXPECT_EQ(expected_value(cc, ii), data.value(cc, xx, yy, zz));
+  }
+
+  const boost::filesystem::path directory_;
+  const CellsType cells_;
+  const size_t num_components_;
+}; // struct Spe10PermeabilityTest
+
+
+TEST_F(Spe10PermeabilityTest, reads_text) {
+  const PermeabilityData data(write_text("perm.dat"), cells_, num_components_);
+  EXPECT_FALSE(data.mapped());
+  EXPECT_FALSE(PermeabilityData::is_binary(path("perm.dat")));
+  check_values(data);
+}
+
+TEST_F(Spe10PermeabilityTest, ignores_additional_components) {
+  const PermeabilityData data(write_text("perm.dat", 3*cells_[0]*cells_[1]*cells_[2]), cells_, num_components_);
+  check_values(data);
+}
+
+TEST_F(Spe10PermeabilityTest, maps_what_was_written) {
+  const PermeabilityData text_data(write_text("perm.dat"), cells_, num_components_);
+  text_data.write_binary(path("perm.bin"));
+  EXPECT_TRUE(PermeabilityData::is_binary(path("perm.bin")));
+  const PermeabilityData binary_data(path("perm.bin"), cells_, num_components_);
+  EXPECT_TRUE(binary_data.mapped());
+  check_values(binary_data);
+  // bitwise the same as the text reader
+  for (size_t cc = 0; cc < num_components_; ++cc)
+    for (size_t ii = 0; ii < binary_data.num_cells(); ++ii)
+      EXPECT_EQ(text_data.component(cc)[ii], binary_data.component(cc)[ii]);
+  // fewer components may be requested
+  const PermeabilityData first_component(path("perm.bin"), cells_, 1);
+  EXPECT_EQ(size_t(1), first_component.num_components());
+  for (size_t ii = 0; ii < first_component.num_cells(); ++ii)
+    EXPECT_EQ(text_data.component(0)[ii], first_component.component(0)[ii]);
+}
+
+TEST_F(Spe10PermeabilityTest, converts_to_binary) {
+  convert_to_binary(write_text("perm.dat"), path("perm.bin"), cells_, num_components_);
+  const PermeabilityData data(path("perm.bin"), cells_, num_components_);
+  EXPECT_TRUE(data.mapped());
+  check_values(data);
+}
+
+TEST_F(Spe10PermeabilityTest, throws_on_wrong_input) {
+  EXPECT_THROW(PermeabilityData(path("does_not_exist.dat"), cells_, num_components_), Dune::IOError);
+  EXPECT_THROW(PermeabilityData(write_text("perm.dat"), CellsType{{3, 0, 4}}, num_components_),
+               Dune::Stuff::Exceptions::wrong_input_given);
+  EXPECT_THROW(PermeabilityData(write_text("perm.dat"), cells_, 0), Dune::Stuff::Exceptions::wrong_input_given);
+  // too few values in the text file
+  EXPECT_THROW(PermeabilityData(write_text("short.dat", num_components_*cells_[0]*cells_[1]*cells_[2] - 1),
+                                cells_,
+                                num_components_),
+               Dune::IOError);
+}
+
+TEST_F(Spe10PermeabilityTest, throws_on_mismatching_binary) {
+  convert_to_binary(write_text("perm.dat"), path("perm.bin"), cells_, num_components_);
+  // other cells
+  EXPECT_THROW(PermeabilityData(path("perm.bin"), CellsType{{3, 4, 2}}, num_components_), Dune::IOError);
+  // more components than stored
+  EXPECT_THROW(PermeabilityData(path("perm.bin"), cells_, num_components_ + 1), Dune::IOError);
+  std::vector< char > content;
+  {
+    std::ifstream file(path("perm.bin"), std::ios::binary);
+    content.assign(std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >());
+  }
+  const auto write = [&](const std::string& filename, const std::vector< char >& bytes) -> std::string {
+    std::ofstream file(path(filename), std::ios::binary);
+    file.write(bytes.data(), bytes.size());
+    return path(filename);
+  };
+  // truncated values
+  std::vector< char > truncated(content.begin(), content.end() - sizeof(double));
+  EXPECT_THROW(PermeabilityData(write("truncated.bin", truncated), cells_, num_components_), Dune::IOError);
+  // truncated header
+  std::vector< char > header_only(content.begin(), content.begin() + 20);
+  EXPECT_THROW(PermeabilityData(write("header.bin", header_only), cells_, num_components_), Dune::IOError);
+  // another version (which follows the magic)
+  std::vector< char > other_version(content);
+  other_version[8] = char(other_version[8] + 1);
+  EXPECT_THROW(PermeabilityData(write("version.bin", other_version), cells_, num_components_), Dune::IOError);
+  // another byte order
+  std::vector< char > other_byte_order(content);
+  std::swap(other_byte_order[12], other_byte_order[15]);
+  std::swap(other_byte_order[13], other_byte_order[14]);
+  EXPECT_THROW(PermeabilityData(write("byte_order.bin", other_byte_order), cells_, num_components_), Dune::IOError);
+}
+
+
+#if HAVE_DUNE_GRID
+
+#include <dune/grid/yaspgrid.hh>
+
+#include <dune/stuff/functions/spe10.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+
+TEST_F(Spe10PermeabilityTest, model2_local_functions_outlive_the_function) {
+  typedef Dune::YaspGrid< 3 > GridType;
+  typedef Dune::Stuff::Functions::Spe10Model2< GridType::Codim< 0 >::Entity, double, 3, double, 3, 3 > FunctionType;
+  const CellsType cells = PermeabilityData::model2_cells();
+  const size_t num_cells = cells[0]*cells[1]*cells[2];
+  {
+    std::ofstream file(path("spe_perm.dat"));
+    for (size_t vv = 0; vv < 3*num_cells; ++vv)
+      file << (vv/num_cells + 1) << ((vv + 1)%6 == 0 ? "\n" : " ");
+  }
+  convert_to_binary(path("spe_perm.dat"), path("spe_perm.bin"), cells);
+  const auto grid = Dune::Stuff::GridProviderCube< GridType >(0.0, 1.0, 2u).grid();
+  const auto grid_view = grid->leafView();
+  const auto entity_ptr = grid_view.begin< 0 >();
+  std::unique_ptr< FunctionType::LocalfunctionType > local_function;
+  {
+    const FunctionType function(path("spe_perm.bin"), {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+    local_function = function.local_function(*entity_ptr);
+  }
+  local_function->bind(*entity_ptr);
+  FunctionType::RangeType value;
+  local_function->evaluate(FunctionType::DomainType(0.5), value);
+  for (size_t ii = 0; ii < 3; ++ii)
+    for (size_t jj = 0; jj < 3; ++jj)
+      EXPECT_EQ(ii == jj ? double(ii + 1) : 0.0, value[ii][jj]);
+}
+
+#endif // HAVE_DUNE_GRID
+
+
+int main(int argc, char** argv)
+{
+  test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
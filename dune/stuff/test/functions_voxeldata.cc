@@ -0,0 +1,211 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "test_common.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/stuff/playground/functions/fromfile/voxeldata.hh>
+
+using Dune::Stuff::VoxelData;
+
+
+struct VoxelDataTest
+  : public ::testing::Test
+{
+  VoxelDataTest()
+    : directory_(boost::filesystem::temp_directory_path()
+                 / boost::filesystem::unique_path("dune-stuff-voxeldata-%%%%-%%%%-%%%%"))
+    , numElements_{10, 10, 20}
+    , num_values_(3)
+  {
+    boost::filesystem::create_directories(directory_);
+  }
+
+  ~VoxelDataTest()
+  {
+    boost::filesystem::remove_all(directory_);
+  }
+
+  std::string path(const std::string& filename) const
+  {
+    return (directory_ / filename).string();
+  }
+
+  size_t num_voxels() const
+  {
+    return numElements_[0]*numElements_[1]*numElements_[2];
+  }
+
+  //! numbers in all the formats the parser has to handle, in particular those which are not given to strtod
+  static std::vector< std::string > tokens(const size_t num)
+  {
+    static const char* const fixed[] = {"0", "-0", "+3.5", ".5", "5.", "42", "1E5", "1e-5", "-2.5e+3", "0.1",
+                                        "9007199254740992", "9007199254740993", "123456789012345678901234",
+                                        "0.30000000000000004", "1e22", "1e23", "1e-22", "1e-23", "4.9e-324",
+                                        "1.7976931348623157e308", "inf", "-inf", "00012.5000"};
+    std::mt19937 generator(42);
+    std::uniform_real_distribution< double > mantissa(-10.0, 10.0);
+    std::uniform_int_distribution< int > exponent(-30, 30);
+    std::uniform_int_distribution< int > precision(1, 20);
+    std::vector< std::string > ret(std::begin(fixed), std::end(fixed));
+    char buffer[64];
+    while (ret.size() < num) {
+      const double value = mantissa(generator)*std::pow(10.0, exponent(generator));
+      switch (ret.size() % 3) {
+        case 0: std::snprintf(buffer, sizeof(buffer), "%.*g", precision(generator), value); break;
+        case 1: std::snprintf(buffer, sizeof(buffer), "%.*e", precision(generator), value); break;
+        default: std::snprintf(buffer, sizeof(buffer), "%.*f", precision(generator) % 10, value); break;
+      }
+      ret.push_back(buffer);
+    }
+    ret.resize(num);
+    return ret;
+  } // ... tokens(...)
+
+  //! writes one line per voxel (in shuffled order, separated by tabs and spaces), returns the filename
+  std::string write(const std::string& filename, const std::vector< std::string >& values) const
+  {
+    std::vector< size_t > order(num_voxels());
+    for (size_t ii = 0; ii < order.size(); ++ii)
+      order[ii] = ii;
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    std::ofstream file(path(filename));
+    for (const size_t& voxel : order) {
+      const size_t zz = voxel%numElements_[2];
+      const size_t yy = (voxel/numElements_[2])%numElements_[1];
+      const size_t xx = voxel/(numElements_[2]*numElements_[1]);
+      file << xx + 1 << " " << yy + 1 << "\t" << zz + 1;
+      for (size_t vv = 0; vv < num_values_; ++vv)
+        file << (vv % 2 ? "\t" : "  ") << values[voxel*num_values_ + vv];
+      file << "\n";
+    }
+    return path(filename);
+  } // ... write(...)
+
+  //! the values have to agree bitwise with strtod
+  void check_values(const VoxelData& data, const std::vector< std::string >& values) const
+  {
+    ASSERT_EQ(num_voxels(), data.num_voxels());
+    ASSERT_EQ(num_values_, data.num_values());
+    for (size_t ii = 0; ii < num_voxels(); ++ii)
+      for (size_t vv = 0; vv < num_values_; ++vv) {
+        const double expected = std::strtod(values[ii*num_values_ + vv].c_str(), nullptr);
+        const double actual = data.values(ii)[vv];
+        EXPECT_EQ(0, std::memcmp(&expected, &actual, sizeof(double)))
+            << "'" << values[ii*num_values_ + vv] << "' was parsed as " << actual << ", strtod gives " << expected;
+      }
+  } // ... check_values(...)
+
+  const boost::filesystem::path directory_;
+  const std::vector< size_t > numElements_;
+  const size_t num_values_;
+  std::ostringstream out_;
+}; // struct VoxelDataTest
+
+
+TEST_F(VoxelDataTest, parses_like_strtod) {
+  const auto values = tokens(num_voxels()*num_values_);
+  const VoxelData data(write("voxels.txt", values), numElements_, num_values_, false, out_);
+  EXPECT_FALSE(data.mapped());
+  EXPECT_FALSE(boost::filesystem::exists(VoxelData::cache_filename(path("voxels.txt"))));
+  check_values(data, values);
+}
+
+TEST_F(VoxelDataTest, maps_the_cache) {
+  const auto values = tokens(num_voxels()*num_values_);
+  const std::string filename = write("voxels.txt", values);
+  {
+    const VoxelData data(filename, numElements_, num_values_, true, out_);
+    EXPECT_FALSE(data.mapped());
+    check_values(data, values);
+  }
+  ASSERT_TRUE(boost::filesystem::exists(VoxelData::cache_filename(filename)));
+  const VoxelData data(filename, numElements_, num_values_, true, out_);
+  EXPECT_TRUE(data.mapped());
+  check_values(data, values);
+  // the cache is only used if requested
+  const VoxelData parsed(filename, numElements_, num_values_, false, out_);
+  EXPECT_FALSE(parsed.mapped());
+}
+
+TEST_F(VoxelDataTest, invalidates_the_cache) {
+  auto values = tokens(num_voxels()*num_values_);
+  const std::string filename = write("voxels.txt", values);
+  VoxelData(filename, numElements_, num_values_, true, out_);
+  // another size
+  values[0] = "17.25";
+  write("voxels.txt", values);
+  {
+    const VoxelData data(filename, numElements_, num_values_, true, out_);
+    EXPECT_FALSE(data.mapped());
+    check_values(data, values);
+  }
+  EXPECT_TRUE(VoxelData(filename, numElements_, num_values_, true, out_).mapped());
+  // the same size, but another modification time
+  values[0] = "17.50";
+  write("voxels.txt", values);
+  boost::filesystem::last_write_time(filename, boost::filesystem::last_write_time(filename) + 10);
+  {
+    const VoxelData data(filename, numElements_, num_values_, true, out_);
+    EXPECT_FALSE(data.mapped());
+    check_values(data, values);
+  }
+  EXPECT_TRUE(VoxelData(filename, numElements_, num_values_, true, out_).mapped());
+  // a truncated cache
+  const std::string cache = VoxelData::cache_filename(filename);
+  boost::filesystem::resize_file(cache, boost::filesystem::file_size(cache) - sizeof(double));
+  {
+    const VoxelData data(filename, numElements_, num_values_, true, out_);
+    EXPECT_FALSE(data.mapped());
+    check_values(data, values);
+  }
+  EXPECT_TRUE(VoxelData(filename, numElements_, num_values_, true, out_).mapped());
+}
+
+TEST_F(VoxelDataTest, throws_on_wrong_input) {
+  const auto write_lines = [&](const std::string& content) -> std::string {
+    std::ofstream file(path("lines.txt"));
+    file << content;
+    return path("lines.txt");
+  };
+  const std::vector< size_t > elements{2, 1};
+  EXPECT_NO_THROW(VoxelData(write_lines("1 1 0.5\n\n2 1 1.5\n"), elements, 1, false, out_));
+  // missing file
+  EXPECT_THROW(VoxelData(path("does_not_exist.txt"), elements, 1, false, out_), Dune::IOError);
+  // duplicate voxel
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n1 1 1.5\n2 1 1.5\n"), elements, 1, false, out_), Dune::IOError);
+  // missing voxel
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n"), elements, 1, false, out_), Dune::IOError);
+  // index out of range
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n3 1 1.5\n"), elements, 1, false, out_), Dune::IOError);
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n0 1 1.5\n"), elements, 1, false, out_), Dune::IOError);
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n1.5 1 1.5\n"), elements, 1, false, out_), Dune::IOError);
+  // wrong number of items
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n2 1\n"), elements, 1, false, out_), Dune::IOError);
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n2 1 1.5 2.5\n"), elements, 1, false, out_), Dune::IOError);
+  // not a number
+  EXPECT_THROW(VoxelData(write_lines("1 1 0.5\n2 1 1.5x\n"), elements, 1, false, out_), Dune::IOError);
+}
+
+
+int main(int argc, char** argv)
+{
+  test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -19,8 +19,52 @@ using namespace Dune::Stuff::Common;
 using namespace Dune::Stuff::Grid;
 using namespace std;
 
+namespace Dune {
+namespace Stuff {
+namespace Grid {
+
+// opt in, so check_walk() covers the threaded walks
+template< int dim, int dimworld, class ctype >
+struct AllowsConcurrentAccess< Dune::SGrid< dim, dimworld, ctype > >
+  : public std::true_type
+{};
+
+} // namespace Grid
+} // namespace Stuff
+} // namespace Dune
+
 typedef testing::Types< Int<1>, Int<2>, Int<3> > GridDims;
 
+struct EntityCounter
+{
+  EntityCounter() : count(0) {}
+
+  template< class Entity >
+  void operator()(const Entity&, const int) { ++count; }
+
+  void reduce(const EntityCounter& other) { count += other.count; }
+
+  int count;
+};
+
+//! increments a counter for each vertex of each entity, without any synchronization
+template< class IndexSetType >
+struct VertexScatter
+{
+  VertexScatter(const IndexSetType& index_set, std::vector< int >& counts)
+    : index_set_(index_set), counts_(counts) {}
+
+  template< class Entity >
+  void operator()(const Entity& entity, const int) {
+    static const int dimension = Entity::dimension;
+    for (int ii = 0; ii < entity.template count< dimension >(); ++ii)
+      ++counts_[index_set_.subIndex(entity, ii, dimension)];
+  }
+
+  const IndexSetType& index_set_;
+  std::vector< int >& counts_;
+};
+
 template < class T >
 struct GridInfoTest : public ::testing::Test
 {
@@ -55,6 +99,40 @@ struct GridInfoTest : public ::testing::Test
     EXPECT_EQ(griddim*2, maxNumberOfNeighbors(gv));
   }
 
+  void check_walk() {
+    typedef typename GridType::LeafGridView GridViewType;
+    const auto grid = GridProviderCube< GridType >(0.f, 1.f, 4u).grid();
+    const GridViewType gv = grid->leafView();
+    const GridWalk< GridViewType > walk(gv);
+    const unsigned int max_threads = ThreadManager::max_threads();
+    ThreadManager::set_max_threads(4);
+    EntityCounter counter;
+    walk.walkParallel(counter);
+    EXPECT_EQ(gv.size(0), counter.count);
+    typedef typename GridViewType::IndexSet IndexSetType;
+    std::vector< int > expected(gv.size(griddim), 0);
+    std::vector< int > colored(gv.size(griddim), 0);
+    VertexScatter< IndexSetType > serial_scatter(gv.indexSet(), expected);
+    walk(serial_scatter);
+    VertexScatter< IndexSetType > colored_scatter(gv.indexSet(), colored);
+    walk.walkColored(colored_scatter);
+    EXPECT_EQ(expected, colored);
+    EXPECT_EQ(size_t(1) << griddim, walk.numColors());
+    // the cached seeds and colors have to be recomputed for the refined grid
+    grid->globalRefine(1);
+    EntityCounter refined_counter;
+    walk.walkParallel(refined_counter);
+    EXPECT_EQ(gv.size(0), refined_counter.count);
+    EntityCounter colored_counter;
+    walk.walkColored(colored_counter);
+    EXPECT_EQ(gv.size(0), colored_counter.count);
+    walk.clearCache();
+    EntityCounter cleared_counter;
+    walk.walkParallel(cleared_counter);
+    EXPECT_EQ(gv.size(0), cleared_counter.count);
+    ThreadManager::set_max_threads(max_threads);
+  }
+
   void print(std::ostream& out) {
     const auto& gv = gridPtr->leafView();
     printInfo(gv, out);
@@ -64,6 +142,7 @@ struct GridInfoTest : public ::testing::Test
 TYPED_TEST_CASE(GridInfoTest, GridDims);
 TYPED_TEST(GridInfoTest, Misc) {
   this->check();
+  this->check_walk();
   this->print(dev_null);
 }
 
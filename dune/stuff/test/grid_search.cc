@@ -0,0 +1,209 @@
+// This file is part of the dune-stuff project:
+//   https://users.dune-project.org/projects/dune-stuff
+// Copyright holders: Rene Milk, Felix Schindler
+// License: BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+
+#include "test_common.hh"
+
+#if HAVE_DUNE_GRID
+
+#include <cmath>
+#include <vector>
+
+#include <dune/grid/onedgrid.hh>
+
+#include <dune/stuff/grid/search.hh>
+#include <dune/stuff/grid/provider/cube.hh>
+#include <dune/stuff/common/ranges.hh>
+#include <dune/stuff/common/threadmanager.hh>
+
+using namespace Dune::Stuff;
+using namespace Dune::Stuff::Common;
+using namespace Dune::Stuff::Grid;
+
+typedef testing::Types< Int<1>, Int<2>, Int<3> > GridDims;
+
+template < class T >
+struct GridSearchTest : public ::testing::Test
+{
+  static const int griddim  = T::value;
+  typedef Dune::SGrid< griddim, griddim > GridType;
+  typedef typename GridType::LeafGridView GridViewType;
+  typedef typename GridViewType::template Codim< 0 >::Geometry::GlobalCoordinate PointType;
+
+  std::shared_ptr< GridType > gridPtr;
+
+  GridSearchTest()
+    : gridPtr(GridProviderCube< GridType >(0.f, 1.f, 4u).grid())
+  {}
+
+  template< class SearchType >
+  void check_centers(const SearchType& search) {
+    const GridViewType gv = gridPtr->leafView();
+    std::vector< PointType > centers;
+    for (const auto& entity : viewRange(gv))
+      centers.push_back(entity.geometry().center());
+    const auto entity_ptrs = search(centers);
+    ASSERT_EQ(centers.size(), entity_ptrs.size());
+    size_t ii = 0;
+    for (const auto& entity : viewRange(gv)) {
+      ASSERT_TRUE(bool(entity_ptrs[ii]));
+      EXPECT_EQ(gv.indexSet().index(entity), gv.indexSet().index(**entity_ptrs[ii]));
+      ++ii;
+    }
+  }
+
+  void check() {
+    const GridViewType gv = gridPtr->leafView();
+    EntityInlevelSearch< GridViewType > inlevel_search(gv);
+    check_centers(inlevel_search);
+    const EntityBoundingBoxSearch< GridViewType > box_search(gv);
+    EXPECT_TRUE(box_search.structured());
+    check_centers(box_search);
+    const EntityHierarchicSearch< GridViewType > hierarchic_search(gv);
+    check_centers(hierarchic_search);
+    // points on element boundaries and outside of the grid
+    PointType corner(0.5);
+    PointType outside(1.5);
+    const auto entity_ptrs = box_search(std::vector< PointType >{corner, outside});
+    ASSERT_EQ(2u, entity_ptrs.size());
+    EXPECT_TRUE(bool(entity_ptrs[0]));
+    EXPECT_FALSE(bool(entity_ptrs[1]));
+    // one result for several searches
+    typename EntityBoundingBoxSearch< GridViewType >::ResultType result;
+    box_search(std::vector< PointType >{outside, corner, outside}, result);
+    ASSERT_EQ(3u, result.size());
+    EXPECT_FALSE(result.found(0));
+    EXPECT_TRUE(result.found(1));
+    EXPECT_FALSE(result.found(2));
+    inlevel_search(std::vector< PointType >{corner}, result);
+    ASSERT_EQ(1u, result.size());
+    ASSERT_TRUE(result.found(0));
+    const auto& geometry = result.entityPointer(0)->geometry();
+    const auto local = geometry.local(corner);
+    for (int dd = 0; dd < griddim; ++dd) {
+      EXPECT_GE(local[dd], -1e-10);
+      EXPECT_LE(local[dd], 1 + 1e-10);
+    }
+    // the results of a hierarchic search stay valid during further searches
+    typename EntityHierarchicSearch< GridViewType >::ResultType first_result, second_result;
+    hierarchic_search(std::vector< PointType >{PointType(0.1), outside}, first_result);
+    hierarchic_search(std::vector< PointType >{PointType(0.9)}, second_result);
+    ASSERT_EQ(2u, first_result.size());
+    ASSERT_TRUE(first_result.found(0));
+    EXPECT_FALSE(first_result.found(1));
+    ASSERT_TRUE(second_result.found(0));
+    EXPECT_NE(gv.indexSet().index(*first_result.entityPointer(0)),
+              gv.indexSet().index(*second_result.entityPointer(0)));
+  }
+
+  void check_parallel() {
+    const GridViewType gv = gridPtr->leafView();
+    const EntityBoundingBoxSearch< GridViewType > search(gv);
+    EXPECT_TRUE(search.structured());
+    const unsigned int max_threads = ThreadManager::max_threads();
+    ThreadManager::set_max_threads(4);
+    const size_t num_points = 4*EntityBoundingBoxSearch< GridViewType >::min_parallel_batch_size;
+    std::vector< PointType > points(num_points);
+    for (size_t ii = 0; ii < num_points; ++ii)
+      for (int dd = 0; dd < griddim; ++dd)
+        points[ii][dd] = double((ii*(2*dd + 3)) % num_points)/double(num_points);
+    const auto entity_ptrs = search(points);
+    ASSERT_EQ(num_points, entity_ptrs.size());
+    for (size_t ii = 0; ii < num_points; ++ii) {
+      ASSERT_TRUE(bool(entity_ptrs[ii]));
+      const auto& geometry = (*entity_ptrs[ii])->geometry();
+      const auto local = geometry.local(points[ii]);
+      for (int dd = 0; dd < griddim; ++dd) {
+        EXPECT_GE(local[dd], -1e-10);
+        EXPECT_LE(local[dd], 1 + 1e-10);
+      }
+    }
+    ThreadManager::set_max_threads(max_threads);
+  }
+};
+
+TYPED_TEST_CASE(GridSearchTest, GridDims);
+TYPED_TEST(GridSearchTest, Centers) {
+  this->check();
+}
+TYPED_TEST(GridSearchTest, Parallel) {
+  this->check_parallel();
+}
+
+//! the index of the first entity of grid_view containing point (found by checking all of them) or -1
+template< class GridViewType, class PointType >
+int brute_force_index(const GridViewType& grid_view, const PointType& point)
+{
+  static const int dimension = GridViewType::dimension;
+  typedef Dune::GenericReferenceElements< typename GridViewType::ctype, dimension > RefElementsType;
+  for (const auto& entity : viewRange(grid_view)) {
+    const auto& geometry = entity.geometry();
+    if (RefElementsType::general(geometry.type()).checkInside(geometry.local(point)))
+      return grid_view.indexSet().index(entity);
+  }
+  return -1;
+}
+
+//! the points should not lie on element boundaries, where the search may choose another entity than brute force
+template< class GridViewType, class PointType >
+void check_against_brute_force(const GridViewType& grid_view, const std::vector< PointType >& points)
+{
+  const EntityBoundingBoxSearch< GridViewType > search(grid_view);
+  EXPECT_FALSE(search.structured());
+  const unsigned int max_threads = ThreadManager::max_threads();
+  ThreadManager::set_max_threads(4);
+  const auto entity_ptrs = search(points);
+  ThreadManager::set_max_threads(max_threads);
+  ASSERT_EQ(points.size(), entity_ptrs.size());
+  size_t num_found = 0;
+  for (size_t ii = 0; ii < points.size(); ++ii) {
+    const int expected = brute_force_index(grid_view, points[ii]);
+    if (expected < 0)
+      EXPECT_FALSE(bool(entity_ptrs[ii]));
+    else {
+      ASSERT_TRUE(bool(entity_ptrs[ii]));
+      EXPECT_EQ(expected, int(grid_view.indexSet().index(**entity_ptrs[ii])));
+      ++num_found;
+    }
+  }
+  // some of the points lie outside of the grid
+  EXPECT_LT(num_found, points.size());
+  EXPECT_GT(num_found, 0u);
+}
+
+TEST(GridSearch, NonUniform) {
+  typedef Dune::OneDGrid GridType;
+  typedef GridType::LeafGridView GridViewType;
+  typedef GridViewType::Codim< 0 >::Geometry::GlobalCoordinate PointType;
+  const GridType grid(std::vector< double >{0.0, 0.1, 0.15, 0.4, 0.45, 0.7, 1.0});
+  const size_t num_points = 1009;
+  std::vector< PointType > points(num_points);
+  for (size_t ii = 0; ii < num_points; ++ii)
+    points[ii][0] = 1.2*(ii + 0.5)/num_points - 0.1;
+  check_against_brute_force(grid.leafView(), points);
+}
+
+#if HAVE_ALUGRID
+TEST(GridSearch, Simplices) {
+  typedef Dune::ALUConformGrid< 2, 2 > GridType;
+  typedef GridType::LeafGridView GridViewType;
+  typedef GridViewType::Codim< 0 >::Geometry::GlobalCoordinate PointType;
+  const auto grid = GridProviderCube< GridType >(0.0, 1.0, 4u).grid();
+  const size_t num_points = 1009;
+  std::vector< PointType > points(num_points);
+  for (size_t ii = 0; ii < num_points; ++ii) {
+    points[ii][0] = 1.2*(ii + 0.5)/num_points - 0.1;
+    points[ii][1] = 1.2*std::fmod(ii*0.7548776662, 1.0) - 0.1;
+  }
+  check_against_brute_force(grid->leafView(), points);
+}
+#endif // HAVE_ALUGRID
+
+#endif // #if HAVE_DUNE_GRID
+
+int main(int argc, char** argv)
+{
+  test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -7,16 +7,21 @@
 
 #include <dune/stuff/test/test_common.hh>
 
+#include <cmath>
 #include <type_traits>
 #include <memory>
+#include <vector>
 
 #include <dune/common/float_cmp.hh>
 
 #include <dune/stuff/common/exceptions.hh>
+#include <dune/stuff/common/threadmanager.hh>
 #include <dune/stuff/la/container/interfaces.hh>
 #include <dune/stuff/la/container/common.hh>
 #include <dune/stuff/la/container/eigen.hh>
 #include <dune/stuff/la/container/istl.hh>
+#include <dune/stuff/la/container/kernels.hh>
+#include <dune/stuff/la/container/sparse_products.hh>
 #include <dune/stuff/la/container.hh>
 
 
@@ -658,6 +663,131 @@ struct VectorTest
         DUNE_THROW_COLORFULLY(Dune::Exception, "check copy-on-write");
     }
   } //void produces_correct_results() const
+
+  void produces_correct_fused_results() const
+  {
+    typedef typename VectorImp::ScalarType ScalarType;
+    typedef typename VectorImp::VectorReferencesType VectorReferencesType;
+    // larger than Kernels::block_size, to cover the blocking
+    const size_t size = 1000;
+    VectorImp xx(size), yy(size), zz(size);
+    for (size_t ii = 0; ii < size; ++ii) {
+      xx.set_entry(ii, ScalarType(ii % 7) - ScalarType(3));
+      yy.set_entry(ii, ScalarType(0.5) * ScalarType(ii % 5));
+      zz.set_entry(ii, ScalarType(1));
+    }
+
+    // axpby
+    VectorImp result = yy;
+    result.axpby(ScalarType(2), xx, ScalarType(-0.5));
+    VectorImp correct_result = xx;
+    correct_result.scal(ScalarType(2));
+    correct_result.axpy(ScalarType(-0.5), yy);
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, "axpby");
+    if (!Dune::FloatCmp::eq(yy[1], ScalarType(0.5)))
+      DUNE_THROW_COLORFULLY(Dune::Exception, "check copy-on-write");
+
+    // axpy_and_norm
+    result = yy;
+    const ScalarType norm = result.axpy_and_norm(ScalarType(-1.5), xx);
+    correct_result = yy;
+    correct_result.axpy(ScalarType(-1.5), xx);
+    if (result != correct_result || !Dune::FloatCmp::eq(norm, correct_result.l2_norm()))
+      DUNE_THROW_COLORFULLY(Dune::Exception, "axpy_and_norm: " << norm << " vs. " << correct_result.l2_norm());
+
+    // linear_combination, also with the result being one of the vectors
+    const std::vector< ScalarType > coefficients = {ScalarType(1), ScalarType(-2), ScalarType(0.25)};
+    result = VectorImp(size);
+    result.linear_combination(coefficients, VectorReferencesType({std::cref(xx), std::cref(yy), std::cref(zz)}));
+    correct_result = xx;
+    correct_result.axpy(ScalarType(-2), yy);
+    correct_result.axpy(ScalarType(0.25), zz);
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, "linear_combination");
+    result = zz;
+    result.linear_combination(coefficients, VectorReferencesType({std::cref(xx), std::cref(yy), std::cref(result)}));
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, "linear_combination in place");
+
+    // dot_many and gram_matrix
+    const VectorReferencesType vectors = {std::cref(xx), std::cref(yy), std::cref(zz)};
+    const auto products = xx.dot_many(vectors);
+    const auto gram = VectorImp::gram_matrix(vectors);
+    if (products.size() != 3 || gram.size() != 3)
+      DUNE_THROW_COLORFULLY(Dune::Exception, "dot_many or gram_matrix: wrong number of results");
+    for (size_t ii = 0; ii < 3; ++ii) {
+      if (!Dune::FloatCmp::eq(products[ii], xx.dot(vectors[ii].get())))
+        DUNE_THROW_COLORFULLY(Dune::Exception, "dot_many: " << products[ii] << " vs. " << xx.dot(vectors[ii].get()));
+      for (size_t jj = 0; jj < 3; ++jj)
+        if (!Dune::FloatCmp::eq(gram[ii][jj], vectors[ii].get().dot(vectors[jj].get())))
+          DUNE_THROW_COLORFULLY(Dune::Exception, "gram_matrix[" << ii << "][" << jj << "]");
+    }
+  } //void produces_correct_fused_results() const
+
+  void evaluates_expressions() const
+  {
+    typedef typename VectorImp::ScalarType ScalarType;
+    VectorImp aa(dim), bb(dim), cc(dim);
+    for (size_t ii = 0; ii < dim; ++ii) {
+      aa.set_entry(ii, ScalarType(ii));
+      bb.set_entry(ii, ScalarType(0.5) * ScalarType(ii));
+      cc.set_entry(ii, ScalarType(-1));
+    }
+    VectorImp correct_result = aa;
+    correct_result.axpy(ScalarType(1), bb);
+    correct_result.axpy(ScalarType(-2), cc);
+
+    VectorImp result = aa + bb - ScalarType(2)*cc;
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, result << " vs. " << correct_result);
+    result = VectorImp(dim);
+    result = aa + bb - cc*ScalarType(2);
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, result << " vs. " << correct_result);
+
+    // the target may appear in the expression, copy-on-write has to be respected
+    VectorImp shared = aa;
+    shared = shared + bb - ScalarType(2)*cc;
+    if (shared != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, shared << " vs. " << correct_result);
+    for (size_t ii = 0; ii < dim; ++ii)
+      if (!Dune::FloatCmp::eq(aa[ii], ScalarType(ii)))
+        DUNE_THROW_COLORFULLY(Dune::Exception, "check copy-on-write");
+
+    // nested scaling
+    result = ScalarType(0.5)*(aa - bb + ScalarType(3)*(cc + aa));
+    for (size_t ii = 0; ii < dim; ++ii)
+      if (!Dune::FloatCmp::eq(result[ii], ScalarType(0.5)*(aa[ii] - bb[ii] + ScalarType(3)*(cc[ii] + aa[ii]))))
+        DUNE_THROW_COLORFULLY(Dune::Exception, result);
+
+    // vectors only known as VectorInterface get the eager operators, the others still mix with them
+    typedef typename Stuff::LA::VectorInterface< typename VectorImp::Traits > InterfaceType;
+    InterfaceType& aa_as_interface = aa;
+    const InterfaceType& bb_as_interface = bb;
+    VectorImp eager = aa_as_interface*ScalarType(2);
+    if (eager != aa.add(aa))
+      DUNE_THROW_COLORFULLY(Dune::Exception, eager << " vs. " << aa.add(aa));
+    eager = bb_as_interface + aa;
+    if (eager != bb.add(aa))
+      DUNE_THROW_COLORFULLY(Dune::Exception, eager << " vs. " << bb.add(aa));
+    eager = bb_as_interface - aa;
+    if (eager != bb.sub(aa))
+      DUNE_THROW_COLORFULLY(Dune::Exception, eager << " vs. " << bb.sub(aa));
+    result = aa_as_interface + bb - ScalarType(2)*cc;
+    if (result != correct_result)
+      DUNE_THROW_COLORFULLY(Dune::Exception, result << " vs. " << correct_result);
+
+    VectorImp too_large(dim + 1);
+    bool caught = false;
+    try {
+      result = aa + too_large;
+    } catch (Stuff::Exceptions::shapes_do_not_match&) {
+      caught = true;
+    }
+    if (!caught)
+      DUNE_THROW_COLORFULLY(Dune::Exception, "expressions of vectors of different sizes have to throw");
+  } //void evaluates_expressions() const
 }; // struct VectorTest
 
 
@@ -665,10 +795,15 @@ TYPED_TEST_CASE(VectorTest, VectorTypes);
 TYPED_TEST(VectorTest, fulfills_interface) {
   this->fulfills_interface();
 }
-TYPED_TEST_CASE(VectorTest, VectorTypes);
 TYPED_TEST(VectorTest, produces_correct_results) {
   this->produces_correct_results();
 }
+TYPED_TEST(VectorTest, produces_correct_fused_results) {
+  this->produces_correct_fused_results();
+}
+TYPED_TEST(VectorTest, evaluates_expressions) {
+  this->evaluates_expressions();
+}
 
 template< class MatrixVectorCombination >
 struct MatrixTest
@@ -706,6 +841,13 @@ struct MatrixTest
         pattern.inner(ii).insert(jj);
     }
     MatrixImp d_by_size_and_pattern(dim, dim, pattern);
+    const Dune::Stuff::LA::SparsityPatternCompressed compressed_pattern(pattern);
+    MatrixImp d_by_size_and_compressed_pattern(dim, dim, compressed_pattern);
+    for (size_t ii = 0; ii < dim; ++ii) {
+      for (size_t jj = 0; jj < dim; ++jj)
+        if (FloatCmp::ne(d_by_size_and_compressed_pattern.get_entry(ii, jj), D_ScalarType(0)))
+          DUNE_THROW_COLORFULLY(Dune::Exception, d_by_size_and_compressed_pattern.get_entry(ii, jj) << " vs 0");
+    }
     size_t d_rows = d_by_size.rows();
     if (d_rows != dim) DUNE_THROW_COLORFULLY(Dune::Exception, d_rows << " vs. " << dim);
     size_t d_cols = d_by_size.cols();
@@ -983,16 +1125,267 @@ struct MatrixTest
       }
     }
   } //void produces_correct_results() const
+
+  void produces_correct_threaded_results() const
+  {
+    typedef typename MatrixImp::ScalarType ScalarType;
+    const unsigned int max_threads = Dune::Stuff::ThreadManager::max_threads();
+    Dune::Stuff::ThreadManager::set_max_threads(4);
+    // rows of very different lengths, so that the partition by nonzeros differs from the one by rows
+    const size_t size = 1500;
+    PatternType pattern(size);
+    for (size_t ii = 0; ii < size; ++ii)
+      for (size_t kk = 0; kk <= ii % 80; ++kk)
+        pattern.inner(ii).insert((ii + 7*kk) % size);
+    MatrixImp matrix(size, size, pattern);
+    for (size_t ii = 0; ii < size; ++ii)
+      for (const size_t jj : pattern.inner(ii))
+        matrix.set_entry(ii, jj, ScalarType(1) + ScalarType(ii)/ScalarType(size) - ScalarType(jj)/ScalarType(2*size));
+    VectorImp source(size);
+    for (size_t ii = 0; ii < size; ++ii)
+      source.set_entry(ii, ScalarType(1) + std::sin(ScalarType(ii)));
+    std::vector< ScalarType > expected_mv(size, ScalarType(0));
+    std::vector< ScalarType > expected_mtv(size, ScalarType(0));
+    for (size_t ii = 0; ii < size; ++ii)
+      for (const size_t jj : pattern.inner(ii)) {
+        expected_mv[ii] += matrix.get_entry(ii, jj)*source.get_entry(jj);
+        expected_mtv[jj] += matrix.get_entry(ii, jj)*source.get_entry(ii);
+      }
+    VectorImp result(size);
+    matrix.mv(source, result);
+    for (size_t ii = 0; ii < size; ++ii)
+      if (FloatCmp::ne(result.get_entry(ii), expected_mv[ii]))
+        DUNE_THROW_COLORFULLY(Dune::Exception, "mv: " << result.get_entry(ii) << " vs. " << expected_mv[ii]);
+    matrix.mtv(source, result);
+    for (size_t ii = 0; ii < size; ++ii)
+      if (FloatCmp::ne(result.get_entry(ii), expected_mtv[ii]))
+        DUNE_THROW_COLORFULLY(Dune::Exception, "mtv: " << result.get_entry(ii) << " vs. " << expected_mtv[ii]);
+    VectorImp wrong_size(size + 1);
+    EXPECT_THROW(matrix.mv(wrong_size, result), Dune::Stuff::Exceptions::shapes_do_not_match);
+    Dune::Stuff::ThreadManager::set_max_threads(max_threads);
+  } //void produces_correct_threaded_results() const
+
+  void adds_local_blocks() const
+  {
+    typedef typename MatrixImp::ScalarType ScalarType;
+    PatternType pattern(dim);                                  //|x, x, -, x|
+    for (size_t ii = 0; ii < dim; ++ii)                        //|-, x, -, -|
+      pattern.inner(ii).insert(ii);                            //|-, x, x, x|
+    for (const size_t ii : {0, 2})                             //|-, -, -, x|
+      for (const size_t jj : {1, 3})
+        pattern.inner(ii).insert(jj);
+    // unsorted and repeated indices
+    const std::vector< size_t > row_indices = {2, 0, 2};
+    const std::vector< size_t > col_indices = {3, 1};
+    const std::vector< std::vector< ScalarType > > local_matrix = {{1, 2}, {3, 4}, {5, 6}};
+    MatrixImp matrix(dim, dim, pattern);
+    MatrixImp expected_matrix(dim, dim, pattern);
+    const MatrixImp shared_matrix = matrix;
+    matrix.add_to_entries(row_indices, col_indices, local_matrix);
+    for (size_t ii = 0; ii < row_indices.size(); ++ii)
+      for (size_t jj = 0; jj < col_indices.size(); ++jj)
+        expected_matrix.add_to_entry(row_indices[ii], col_indices[jj], local_matrix[ii][jj]);
+    for (size_t ii = 0; ii < dim; ++ii)
+      for (size_t jj = 0; jj < dim; ++jj) {
+        if (FloatCmp::ne(matrix.get_entry(ii, jj), expected_matrix.get_entry(ii, jj)))
+          DUNE_THROW_COLORFULLY(Dune::Exception, matrix.get_entry(ii, jj) << " vs. " << expected_matrix.get_entry(ii, jj));
+        if (FloatCmp::ne(shared_matrix.get_entry(ii, jj), ScalarType(0)))
+          DUNE_THROW_COLORFULLY(Dune::Exception, "check copy-on-write");
+      }
+    const std::vector< size_t > indices = {3, 0, 3};
+    const std::vector< ScalarType > local_vector = {1, 2, 3};
+    VectorImp vector(dim, ScalarType(1));
+    const VectorImp shared_vector = vector;
+    vector.add_to_entries(indices, local_vector);
+    if (FloatCmp::ne(vector[0], ScalarType(3)) || FloatCmp::ne(vector[1], ScalarType(1))
+        || FloatCmp::ne(vector[2], ScalarType(1)) || FloatCmp::ne(vector[3], ScalarType(5)))
+      DUNE_THROW_COLORFULLY(Dune::Exception, vector);
+    if (FloatCmp::ne(shared_vector[3], ScalarType(1)))
+      DUNE_THROW_COLORFULLY(Dune::Exception, "check copy-on-write");
+  } //void adds_local_blocks() const
 }; //struct MatrixTest
 
 TYPED_TEST_CASE(MatrixTest, MatrixVectorCombinations);
 TYPED_TEST(MatrixTest, fulfills_interface) {
   this->fulfills_interface();
 }
-TYPED_TEST_CASE(MatrixTest, MatrixVectorCombinations);
 TYPED_TEST(MatrixTest, produces_correct_results) {
   this->produces_correct_results();
 }
+TYPED_TEST(MatrixTest, produces_correct_threaded_results) {
+  this->produces_correct_threaded_results();
+}
+TYPED_TEST(MatrixTest, adds_local_blocks) {
+  this->adds_local_blocks();
+}
+
+template< class MatrixImp >
+void check_local_blocks_outside_of_the_pattern()
+{
+  typedef typename MatrixImp::ScalarType ScalarType;
+  typedef std::vector< std::vector< ScalarType > > LocalMatrixType;
+  typedef Dune::Stuff::Exceptions::index_out_of_range ExceptionType;
+  Dune::Stuff::LA::SparsityPatternDefault pattern(dim);  //|x, -, -, -|
+  for (size_t ii = 0; ii < dim; ++ii)                     //|-, x, -, -|
+    pattern.inner(ii).insert(ii);                         //|-, -, x, -|
+  MatrixImp matrix(dim, dim, pattern);                    //|-, -, -, x|
+  EXPECT_NO_THROW(matrix.add_to_entries(std::vector< size_t >{2, 2}, std::vector< size_t >{2},
+                                        LocalMatrixType{{1}, {2}}));
+  EXPECT_EQ(ScalarType(3), matrix.get_entry(2, 2));
+  // (1, 2) and (2, 1) are missing
+  EXPECT_THROW(matrix.add_to_entries(std::vector< size_t >{1, 2}, std::vector< size_t >{1, 2},
+                                     LocalMatrixType{{1, 2}, {3, 4}}),
+               ExceptionType);
+  // behind the last entry of the row
+  EXPECT_THROW(matrix.add_to_entries(std::vector< size_t >{0}, std::vector< size_t >{3}, LocalMatrixType{{1}}),
+               ExceptionType);
+  // before the first entry of the row
+  EXPECT_THROW(matrix.add_to_entries(std::vector< size_t >{3}, std::vector< size_t >{0}, LocalMatrixType{{1}}),
+               ExceptionType);
+  EXPECT_EQ(ScalarType(0), matrix.get_entry(0, 0));
+  EXPECT_EQ(ScalarType(0), matrix.get_entry(3, 3));
+} // ... check_local_blocks_outside_of_the_pattern(...)
+
+#if HAVE_EIGEN
+TEST(EigenRowMajorSparseMatrix, throws_on_local_blocks_outside_of_the_pattern) {
+  check_local_blocks_outside_of_the_pattern< Dune::Stuff::LA::EigenRowMajorSparseMatrix< double > >();
+}
+#endif // HAVE_EIGEN
+#if HAVE_DUNE_ISTL
+TEST(IstlRowMajorSparseMatrix, throws_on_local_blocks_outside_of_the_pattern) {
+  check_local_blocks_outside_of_the_pattern< Dune::Stuff::LA::IstlRowMajorSparseMatrix< double > >();
+}
+#endif // HAVE_DUNE_ISTL
+
+TEST(SparseProducts, balances_nonzeros) {
+  using namespace Dune::Stuff::LA::SparseProducts;
+  // 100 long rows followed by many short ones
+  const size_t rows = 1000;
+  std::vector< size_t > offsets(rows + 1, 0);
+  for (size_t ii = 0; ii < rows; ++ii)
+    offsets[ii + 1] = offsets[ii] + (ii < 100 ? 1000 : 10);
+  const RowPartition partition(rows, offsets.data(), 4);
+  EXPECT_EQ(size_t(4), partition.num_ranges());
+  EXPECT_EQ(offsets[rows], partition.nonzeros());
+  EXPECT_EQ(size_t(0), partition.first(0));
+  EXPECT_EQ(rows, partition.last(partition.num_ranges() - 1));
+  for (size_t rr = 0; rr < partition.num_ranges(); ++rr) {
+    if (rr > 0) {
+      EXPECT_EQ(partition.last(rr - 1), partition.first(rr));
+    }
+    const size_t nonzeros = offsets[partition.last(rr)] - offsets[partition.first(rr)];
+    EXPECT_GE(1000 + partition.nonzeros()/4, nonzeros);
+    EXPECT_LE(partition.nonzeros()/4, nonzeros + 1000);
+  }
+  // the same partition from the row sizes
+  const auto row_size = [&](const size_t ii) { return offsets[ii + 1] - offsets[ii]; };
+  for (const size_t max_ranges : {1, 3, 4, 7, 64}) {
+    const RowPartition expected(rows, offsets.data(), max_ranges);
+    const RowPartition from_row_sizes = RowPartition::from_row_sizes(rows, row_size, max_ranges);
+    ASSERT_EQ(expected.num_ranges(), from_row_sizes.num_ranges());
+    EXPECT_EQ(expected.nonzeros(), from_row_sizes.nonzeros());
+    for (size_t rr = 0; rr < expected.num_ranges(); ++rr) {
+      EXPECT_EQ(expected.first(rr), from_row_sizes.first(rr));
+      EXPECT_EQ(expected.last(rr), from_row_sizes.last(rr));
+    }
+  }
+  // too few nonzeros to be worth threading
+  const RowPartition small(10, offsets.data(), 4);
+  EXPECT_EQ(size_t(1), small.num_ranges());
+  EXPECT_EQ(size_t(10), small.last(0));
+  EXPECT_EQ(size_t(1), RowPartition::from_row_sizes(10, row_size, 4).num_ranges());
+}
+
+TEST(SparsityPatternBuilder, produces_correct_results) {
+  using namespace Dune::Stuff::LA;
+  SparsityPatternBuilder builder(dim);
+  // unsorted and duplicate insertions, enough to trigger intermediate compression
+  for (size_t kk = 0; kk < 10; ++kk) {
+    builder.insert(0, 3);
+    builder.insert(0, 1);
+  }
+  const std::vector< size_t > cols = {2, 0, 2, 1};
+  builder.insert(2, cols.begin(), cols.end());
+  builder.insert(3, 3);
+  const SparsityPatternCompressed pattern = builder.finalize();
+  EXPECT_EQ(dim, pattern.size());
+  EXPECT_EQ(size_t(6), pattern.num_nonzeros());
+  EXPECT_EQ(std::vector< size_t >({0, 2, 2, 5, 6}), pattern.offsets());
+  EXPECT_EQ(std::vector< size_t >({1, 3, 0, 1, 2, 3}), pattern.columns());
+  EXPECT_EQ(size_t(0), pattern.inner(1).size());
+  EXPECT_TRUE(pattern.inner(2).contains(1));
+  EXPECT_FALSE(pattern.inner(0).contains(2));
+  SparsityPatternDefault default_pattern(dim);
+  default_pattern.inner(0).insert(1);
+  default_pattern.inner(0).insert(3);
+  for (size_t jj = 0; jj < 3; ++jj)
+    default_pattern.inner(2).insert(jj);
+  default_pattern.inner(3).insert(3);
+  EXPECT_EQ(pattern, SparsityPatternCompressed(default_pattern));
+  // mostly distinct insertions in a long row, which have to grow the row instead of compressing it again and again
+  SparsityPatternBuilder long_row_builder(1);
+  for (size_t kk = 0; kk < 1000; ++kk)
+    long_row_builder.insert(0, (7*kk) % 997);
+  const SparsityPatternCompressed long_row_pattern = long_row_builder.finalize();
+  EXPECT_EQ(size_t(997), long_row_pattern.num_nonzeros());
+  for (size_t jj = 0; jj < 997; ++jj)
+    EXPECT_EQ(jj, long_row_pattern.columns()[jj]);
+}
+
+TEST(Kernels, instruction_sets_agree) {
+  using namespace Dune::Stuff::LA;
+  using Kernels::InstructionSet;
+  // sizes covering the vectorized loops and their remainders
+  for (size_t size : {0, 1, 3, 7, 8, 17, 33, 1000}) {
+    std::vector< double > xx(size), yy(size), expected(size), result(size);
+    for (size_t ii = 0; ii < size; ++ii) {
+      xx[ii] = std::sin(double(ii)) * ((ii % 3) + 1);
+      yy[ii] = std::cos(double(ii));
+    }
+    if (size > 3) {
+      xx[size / 2] = -4.0;
+      xx[size - 1] = 4.0;
+    }
+    for (auto instruction_set : {InstructionSet::scalar, InstructionSet::avx2, InstructionSet::avx512}) {
+      Kernels::use_instruction_set(instruction_set);
+      const auto amax = Kernels::amax(xx.data(), size);
+      EXPECT_EQ(Kernels::amax< double >(xx.data(), size), amax) << Kernels::to_string(Kernels::instruction_set());
+      EXPECT_TRUE(FloatCmp::eq(Kernels::dot< double >(xx.data(), yy.data(), size),
+                               Kernels::dot(xx.data(), yy.data(), size)));
+      EXPECT_TRUE(FloatCmp::eq(Kernels::l1_norm< double >(xx.data(), size), Kernels::l1_norm(xx.data(), size)));
+      EXPECT_TRUE(Kernels::almost_equal(xx.data(), xx.data(), size, 1e-15));
+      if (size > 0)
+        EXPECT_FALSE(Kernels::almost_equal(xx.data(), yy.data(), size, 1e-15));
+      Kernels::add< double >(xx.data(), yy.data(), expected.data(), size);
+      Kernels::add(xx.data(), yy.data(), result.data(), size);
+      EXPECT_EQ(expected, result);
+      Kernels::sub< double >(xx.data(), yy.data(), expected.data(), size);
+      Kernels::sub(xx.data(), yy.data(), result.data(), size);
+      EXPECT_EQ(expected, result);
+    }
+  }
+  Kernels::use_instruction_set(Kernels::supported_instruction_set());
+}
+
+TEST(Kernels, compensated_summation_is_exact) {
+  using namespace Dune::Stuff::LA;
+  using Kernels::InstructionSet;
+  // 1 + 1e-16 + ... + 1 + 1e-16 sums to 1e6 + 1e-10, the naive sum loses the small summands completely
+  const size_t size = 2000000;
+  std::vector< double > xx(size), ones(size, 1.0);
+  for (size_t ii = 0; ii < size; ++ii)
+    xx[ii] = (ii % 2 == 0) ? 1.0 : 1e-16;
+  for (auto instruction_set : {InstructionSet::scalar, InstructionSet::avx2, InstructionSet::avx512}) {
+    Kernels::use_instruction_set(instruction_set);
+    EXPECT_EQ(1e6 + 1e-10, Kernels::compensated_dot(xx.data(), ones.data(), size));
+    EXPECT_EQ(1e6 + 1e-10, Kernels::compensated_l1_norm(xx.data(), size));
+  }
+  Kernels::use_instruction_set(Kernels::supported_instruction_set());
+  CommonDenseVector< double > vector(size);
+  for (size_t ii = 0; ii < size; ++ii)
+    vector.set_entry(ii, xx[ii]);
+  EXPECT_EQ(1e6 + 1e-10, vector.compensated_l1_norm());
+}
 
 int main(int argc, char** argv)
 {
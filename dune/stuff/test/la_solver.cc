@@ -7,6 +7,7 @@
 #include <dune/stuff/test/test_common.hh>
 
 #include <tuple>
+#include <vector>
 
 #include <dune/stuff/common/exceptions.hh>
 #include <dune/stuff/common/logging.hh>
@@ -77,14 +78,130 @@ struct SolverTest
       if (!solution.almost_equal(rhs))
         DUNE_THROW_COLORFULLY(Exceptions::results_are_not_as_expected, "Wrong solution!");
       solution.scal(0);
+
+      // the same again, after dropping the cached preconditioner/factorization
+      solver.invalidate();
+      solver.apply(rhs, solution, detailed_opts);
+      if (!solution.almost_equal(rhs))
+        DUNE_THROW_COLORFULLY(Exceptions::results_are_not_as_expected, "Wrong solution!");
+      solution.scal(0);
     }
   } // ... produces_correct_results(...)
+
+  //! symmetric and positive definite, so all solvers can handle it
+  static MatrixType tridiagonal_matrix(const size_t dim, const double scale)
+  {
+    SparsityPatternDefault pattern(dim);
+    for (size_t ii = 0; ii < dim; ++ii) {
+      if (ii > 0)
+        pattern.inner(ii).insert(ii - 1);
+      pattern.inner(ii).insert(ii);
+      if (ii + 1 < dim)
+        pattern.inner(ii).insert(ii + 1);
+    }
+    MatrixType matrix(dim, dim, pattern);
+    for (size_t ii = 0; ii < dim; ++ii) {
+      if (ii > 0)
+        matrix.set_entry(ii, ii - 1, -1.0*scale);
+      matrix.set_entry(ii, ii, 4.0*scale);
+      if (ii + 1 < dim)
+        matrix.set_entry(ii, ii + 1, -1.0*scale);
+    }
+    return matrix;
+  } // ... tridiagonal_matrix(...)
+
+  static double residual(const MatrixType& matrix, const SolutionType& solution, const RhsType& rhs)
+  {
+    RhsType tmp = rhs.copy();
+    matrix.mv(solution, tmp);
+    tmp.axpy(-1.0, rhs);
+    return tmp.sup_norm();
+  }
+
+  static void solves_several_right_hand_sides_at_once()
+  {
+    const size_t dim = 10;
+    const MatrixType matrix = tridiagonal_matrix(dim, 1.0);
+    std::vector< RhsType > rhss;
+    std::vector< SolutionType > solutions;
+    for (size_t kk = 0; kk < 3; ++kk) {
+      rhss.emplace_back(Container< RhsType >::create(dim));
+      for (size_t ii = 0; ii < dim; ++ii)
+        rhss.back().set_entry(ii, 1.0 + ii + kk*ii*ii);
+      solutions.emplace_back(Container< SolutionType >::create(dim));
+    }
+    const SolverType solver(matrix);
+    for (auto opt : SolverType::options()) {
+      for (auto& solution : solutions)
+        solution.scal(0);
+      solver.apply(rhss, solutions, opt);
+      for (size_t kk = 0; kk < rhss.size(); ++kk) {
+        SolutionType single_solution = Container< SolutionType >::create(dim);
+        single_solution.scal(0);
+        solver.apply(rhss[kk], single_solution, opt);
+        single_solution.axpy(-1.0, solutions[kk]);
+        EXPECT_LT(single_solution.sup_norm(), 1e-6) << opt << ", rhs " << kk;
+        EXPECT_LT(residual(matrix, solutions[kk], rhss[kk]), 1e-6) << opt << ", rhs " << kk;
+      }
+    }
+  } // ... solves_several_right_hand_sides_at_once(...)
+
+  static void reuses_the_cache_correctly()
+  {
+    const size_t dim = 10;
+    MatrixType matrix = tridiagonal_matrix(dim, 1.0);
+    RhsType rhs = Container< RhsType >::create(dim);
+    for (size_t ii = 0; ii < dim; ++ii)
+      rhs.set_entry(ii, double(ii + 1));
+    SolutionType solution = Container< SolutionType >::create(dim);
+    const SolverType solver(matrix);
+    for (auto opt : SolverType::options()) {
+      Common::ConfigTree opts = SolverType::options(opt);
+      // the stale solutions below do not solve the system on purpose
+      opts.set("post_check_solves_system", "0", true);
+      const bool is_iterative = opt.substr(0, 9) == "bicgstab." || opt.substr(0, 3) == "cg.";
+      matrix = tridiagonal_matrix(dim, 1.0);
+      solver.invalidate();
+      solution.scal(0);
+      solver.apply(rhs, solution, opts);
+      EXPECT_LT(residual(matrix, solution, rhs), 1e-6) << opt;
+      const SolutionType unscaled_solution = solution.copy();
+
+      // the values change, but the factorization or preconditioner of the old ones is reused ...
+      matrix.scal(2.0);
+      solution.scal(0);
+      solver.apply(rhs, solution, opts);
+      if (is_iterative) // ... which only preconditions iterative solvers ...
+        EXPECT_LT(residual(matrix, solution, rhs), 1e-6) << opt;
+      else              // ... but gives the solution of the old system for direct ones
+        EXPECT_TRUE(solution.almost_equal(unscaled_solution)) << opt;
+
+      // until it is dropped
+      solver.invalidate();
+      solution.scal(0);
+      solver.apply(rhs, solution, opts);
+      EXPECT_LT(residual(matrix, solution, rhs), 1e-6) << opt;
+
+      // a new backend is detected, even if it is allocated where the freed cached one was
+      matrix = tridiagonal_matrix(dim, 3.0);
+      matrix = tridiagonal_matrix(dim, 4.0);
+      solution.scal(0);
+      solver.apply(rhs, solution, opts);
+      EXPECT_LT(residual(matrix, solution, rhs), 1e-6) << opt;
+    }
+  } // ... reuses_the_cache_correctly(...)
 }; // struct SolverTest
 
 TYPED_TEST_CASE(SolverTest, MatrixVectorCombinations);
 TYPED_TEST(SolverTest, behaves_correctly) {
   this->produces_correct_results();
 }
+TYPED_TEST(SolverTest, solves_several_right_hand_sides_at_once) {
+  this->solves_several_right_hand_sides_at_once();
+}
+TYPED_TEST(SolverTest, reuses_the_cache_correctly) {
+  this->reuses_the_cache_correctly();
+}
 
 
 int main(int argc, char** argv)